@@ -186,7 +186,7 @@ CREATE TABLE `expansion` (
 -- ----------------------------
 DROP TABLE IF EXISTS `ip_banned`;
 CREATE TABLE `ip_banned` (
-  `ip` char(16) NOT NULL,
+  `ip` char(18) NOT NULL,
   `ban_date` int(11) NOT NULL,
   `unban_date` int(11) NOT NULL,
   `banned_by` varchar(16) NOT NULL,
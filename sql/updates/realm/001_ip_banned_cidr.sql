@@ -0,0 +1,2 @@
+-- networks in CIDR notation (255.255.255.255/32) need 18 characters
+ALTER TABLE `ip_banned` MODIFY `ip` char(18) NOT NULL;
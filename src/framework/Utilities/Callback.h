@@ -401,6 +401,20 @@ namespace Looking4group
             {
             }
     };
+
+    class SCallback : public _ICallback<_SCallback<> >
+    {
+        private:
+
+            typedef _SCallback<> C0;
+
+        public:
+
+            SCallback(C0::Method method)
+                : _ICallback<C0>(C0(method))
+            {
+            }
+    };
 }
 
 /// ---------- QUERY CALLBACKS -----------
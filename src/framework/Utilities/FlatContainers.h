@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * Copyright (C) 2008 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef LOOKING4GROUP_FLAT_CONTAINERS_H
+#define LOOKING4GROUP_FLAT_CONTAINERS_H
+
+#include "Platform/Define.h"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <string.h>
+
+/*
+ * Containers for the small sets and lists units keep (attackers, combo point holders,
+ * dynamic objects, objects at client). They store elements in one array instead of a
+ * node per element. Only for plain data (pointers, numbers, guids): elements are
+ * copied with memcpy and never constructed or destroyed.
+ *
+ * Unlike std::set/std::list, inserting or erasing invalidates iterators of later elements.
+ */
+
+/// Vector keeping up to N elements inside the object, allocates only above that
+template<class T, size_t N>
+class SmallVector
+{
+    public:
+        typedef T value_type;
+        typedef T* iterator;
+        typedef T const* const_iterator;
+
+        SmallVector() : m_data(m_inline), m_size(0), m_capacity(N) {}
+
+        SmallVector(SmallVector const& other) : m_data(m_inline), m_size(0), m_capacity(N)
+        {
+            assign(other.begin(), other.end());
+        }
+
+        ~SmallVector()
+        {
+            if (m_data != m_inline)
+                ::operator delete(m_data);
+        }
+
+        SmallVector& operator=(SmallVector const& other)
+        {
+            if (this != &other)
+                assign(other.begin(), other.end());
+            return *this;
+        }
+
+        iterator begin() { return m_data; }
+        iterator end() { return m_data + m_size; }
+        const_iterator begin() const { return m_data; }
+        const_iterator end() const { return m_data + m_size; }
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        void clear() { m_size = 0; }
+
+        T& operator[](size_t index) { return m_data[index]; }
+        T const& operator[](size_t index) const { return m_data[index]; }
+        T& front() { return m_data[0]; }
+        T const& front() const { return m_data[0]; }
+        T& back() { return m_data[m_size - 1]; }
+        T const& back() const { return m_data[m_size - 1]; }
+
+        void reserve(size_t capacity)
+        {
+            if (capacity <= m_capacity)
+                return;
+
+            T* data = (T*)::operator new(capacity * sizeof(T));
+            memcpy(data, m_data, m_size * sizeof(T));
+            if (m_data != m_inline)
+                ::operator delete(m_data);
+
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+        void assign(const_iterator first, const_iterator last)
+        {
+            m_size = 0;
+            reserve(last - first);
+            memcpy(m_data, first, (last - first) * sizeof(T));
+            m_size = last - first;
+        }
+
+        void push_back(T value)
+        {
+            if (m_size == m_capacity)
+                reserve(m_capacity * 2);
+            m_data[m_size++] = value;
+        }
+
+        void pop_back() { --m_size; }
+
+        iterator insert(iterator pos, T value)
+        {
+            size_t index = pos - m_data;
+            if (m_size == m_capacity)
+                reserve(m_capacity * 2);
+
+            memmove(m_data + index + 1, m_data + index, (m_size - index) * sizeof(T));
+            m_data[index] = value;
+            ++m_size;
+            return m_data + index;
+        }
+
+        iterator erase(iterator pos) { return erase(pos, pos + 1); }
+
+        iterator erase(iterator first, iterator last)
+        {
+            memmove(first, last, (end() - last) * sizeof(T));
+            m_size -= last - first;
+            return first;
+        }
+
+        /// Erases all elements equal to value, like std::list::remove
+        void remove(T value) { erase(std::remove(begin(), end(), value), end()); }
+
+    private:
+        T* m_data;
+        size_t m_size;
+        size_t m_capacity;
+        T m_inline[N];
+};
+
+/// Set kept as a sorted SmallVector, binary search over contiguous elements
+template<class T, size_t N>
+class FlatSet
+{
+    public:
+        typedef T value_type;
+        typedef T key_type;
+        typedef T const* iterator;
+        typedef T const* const_iterator;
+
+        const_iterator begin() const { return m_elements.begin(); }
+        const_iterator end() const { return m_elements.end(); }
+
+        size_t size() const { return m_elements.size(); }
+        bool empty() const { return m_elements.empty(); }
+        void clear() { m_elements.clear(); }
+
+        const_iterator lower_bound(T key) const { return std::lower_bound(begin(), end(), key); }
+
+        const_iterator find(T key) const
+        {
+            const_iterator itr = lower_bound(key);
+            return itr != end() && !(key < *itr) ? itr : end();
+        }
+
+        size_t count(T key) const { return find(key) != end() ? 1 : 0; }
+
+        std::pair<const_iterator, bool> insert(T key)
+        {
+            T* itr = m_elements.begin() + (lower_bound(key) - begin());
+            if (itr != m_elements.end() && !(key < *itr))
+                return std::make_pair(const_iterator(itr), false);
+
+            return std::make_pair(const_iterator(m_elements.insert(itr, key)), true);
+        }
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last)
+        {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+
+        const_iterator erase(const_iterator pos)
+        {
+            T* itr = m_elements.begin() + (pos - begin());
+            return m_elements.erase(itr);
+        }
+
+        size_t erase(T key)
+        {
+            const_iterator itr = find(key);
+            if (itr == end())
+                return 0;
+
+            erase(itr);
+            return 1;
+        }
+
+    private:
+        SmallVector<T, N> m_elements;
+};
+
+/// Hash set of integer keys with open addressing in one array, for sets too large to keep sorted.
+/// EmptyKey marks free slots and can't be stored.
+template<class T, T EmptyKey>
+class FlatHashSet
+{
+    public:
+        typedef T value_type;
+        typedef T key_type;
+
+        class const_iterator
+        {
+            public:
+                const_iterator() : m_slot(NULL), m_end(NULL) {}
+                const_iterator(T const* slot, T const* end) : m_slot(slot), m_end(end) { skip(); }
+
+                T const& operator*() const { return *m_slot; }
+                T const* operator->() const { return m_slot; }
+
+                const_iterator& operator++() { ++m_slot; skip(); return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+
+                bool operator==(const_iterator const& other) const { return m_slot == other.m_slot; }
+                bool operator!=(const_iterator const& other) const { return m_slot != other.m_slot; }
+
+            private:
+                void skip()
+                {
+                    while (m_slot != m_end && *m_slot == EmptyKey)
+                        ++m_slot;
+                }
+
+                T const* m_slot;
+                T const* m_end;
+        };
+
+        typedef const_iterator iterator;
+
+        FlatHashSet() : m_slots(NULL), m_mask(0), m_size(0) {}
+
+        FlatHashSet(FlatHashSet const& other) : m_slots(NULL), m_mask(0), m_size(0) { *this = other; }
+
+        ~FlatHashSet() { ::operator delete(m_slots); }
+
+        FlatHashSet& operator=(FlatHashSet const& other)
+        {
+            if (this == &other)
+                return *this;
+
+            if (m_mask != other.m_mask)
+            {
+                ::operator delete(m_slots);
+                m_slots = other.m_slots ? (T*)::operator new((other.m_mask + 1) * sizeof(T)) : NULL;
+                m_mask = other.m_mask;
+            }
+
+            if (m_slots)
+                memcpy(m_slots, other.m_slots, (m_mask + 1) * sizeof(T));
+            m_size = other.m_size;
+            return *this;
+        }
+
+        const_iterator begin() const { return const_iterator(m_slots, m_slots + capacity()); }
+        const_iterator end() const { return const_iterator(m_slots + capacity(), m_slots + capacity()); }
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        /// keeps the memory, the set is refilled soon
+        void clear()
+        {
+            for (size_t i = 0; i < capacity(); ++i)
+                m_slots[i] = EmptyKey;
+            m_size = 0;
+        }
+
+        const_iterator find(T key) const
+        {
+            if (!m_size || key == EmptyKey)
+                return end();
+
+            for (size_t i = home(key); ; i = (i + 1) & m_mask)
+            {
+                if (m_slots[i] == key)
+                    return const_iterator(m_slots + i, m_slots + capacity());
+                if (m_slots[i] == EmptyKey)
+                    return end();
+            }
+        }
+
+        size_t count(T key) const { return find(key) != end() ? 1 : 0; }
+
+        std::pair<const_iterator, bool> insert(T key)
+        {
+            if (key == EmptyKey)
+                return std::make_pair(end(), false);
+
+            // at most half full, probe sequences stay short
+            if ((m_size + 1) * 2 > capacity())
+                rehash(capacity() ? capacity() * 2 : MIN_CAPACITY);
+
+            size_t i = home(key);
+            for (; m_slots[i] != EmptyKey; i = (i + 1) & m_mask)
+                if (m_slots[i] == key)
+                    return std::make_pair(const_iterator(m_slots + i, m_slots + capacity()), false);
+
+            m_slots[i] = key;
+            ++m_size;
+            return std::make_pair(const_iterator(m_slots + i, m_slots + capacity()), true);
+        }
+
+        size_t erase(T key)
+        {
+            if (!m_size || key == EmptyKey)
+                return 0;
+
+            size_t i = home(key);
+            for (; m_slots[i] != key; i = (i + 1) & m_mask)
+                if (m_slots[i] == EmptyKey)
+                    return 0;
+
+            // move back the following keys that can't be found past the new hole
+            for (size_t j = (i + 1) & m_mask; m_slots[j] != EmptyKey; j = (j + 1) & m_mask)
+            {
+                size_t k = home(m_slots[j]);
+                if (i <= j ? (k <= i || k > j) : (k <= i && k > j))
+                {
+                    m_slots[i] = m_slots[j];
+                    i = j;
+                }
+            }
+
+            m_slots[i] = EmptyKey;
+            --m_size;
+            return 1;
+        }
+
+    private:
+        enum { MIN_CAPACITY = 16 };
+
+        size_t capacity() const { return m_slots ? m_mask + 1 : 0; }
+
+        size_t home(T key) const
+        {
+            // guids differ in the low bits, multiplying spreads them over the high ones
+            return size_t((uint64(key) * uint64(0x9E3779B97F4A7C15ULL)) >> 32) & m_mask;
+        }
+
+        void rehash(size_t newCapacity)
+        {
+            T* oldSlots = m_slots;
+            size_t oldCapacity = capacity();
+
+            m_slots = (T*)::operator new(newCapacity * sizeof(T));
+            m_mask = newCapacity - 1;
+            m_size = 0;
+            clear();
+
+            for (size_t i = 0; i < oldCapacity; ++i)
+                if (oldSlots[i] != EmptyKey)
+                    insert(oldSlots[i]);
+
+            ::operator delete(oldSlots);
+        }
+
+        T* m_slots;
+        size_t m_mask;
+        size_t m_size;
+};
+
+#endif
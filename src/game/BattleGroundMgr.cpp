@@ -67,6 +67,7 @@ BattleGroundQueue::~BattleGroundQueue()
 
             m_QueuedGroups[i][j].clear();
         }
+        m_RatedTeams[i].Clear();
 
         queuedPlayersCount[BG_TEAM_ALLIANCE][i] = 0;
         queuedPlayersCount[BG_TEAM_HORDE][i] = 0;
@@ -74,6 +75,116 @@ BattleGroundQueue::~BattleGroundQueue()
     }
 }
 
+uint32 ArenaRatingWindow::GetWindow(uint32 waitTime) const
+{
+    if (!MaxRatingDifference)
+        return ARENA_QUEUE_UNLIMITED_WINDOW;
+
+    if (StepByStep)
+    {
+        if (!StepTime)
+            return MaxRatingDifference;
+
+        uint64 window = uint64(MaxRatingDifference) + uint64(StepValue) * (waitTime / StepTime);
+        return window >= ARENA_QUEUE_UNLIMITED_WINDOW ? ARENA_QUEUE_UNLIMITED_WINDOW : uint32(window);
+    }
+
+    return waitTime >= DiscardTime ? ARENA_QUEUE_UNLIMITED_WINDOW : MaxRatingDifference;
+}
+
+void ArenaQueueRatingIndex::Insert(GroupQueueInfo* ginfo)
+{
+    m_ByBucket.insert(MakeKey(ginfo));
+    m_ByJoinTime.insert(std::make_pair(ginfo->JoinTime, ginfo));
+}
+
+void ArenaQueueRatingIndex::Remove(GroupQueueInfo* ginfo)
+{
+    m_ByBucket.erase(MakeKey(ginfo));
+    m_ByJoinTime.erase(std::make_pair(ginfo->JoinTime, ginfo));
+}
+
+void ArenaQueueRatingIndex::Clear()
+{
+    m_ByBucket.clear();
+    m_ByJoinTime.clear();
+}
+
+GroupQueueInfo* ArenaQueueRatingIndex::GetOldest(GroupQueueInfo const* exclude) const
+{
+    for (JoinTimeIndex::const_iterator itr = m_ByJoinTime.begin(); itr != m_ByJoinTime.end(); ++itr)
+        if (itr->second != exclude)
+            return itr->second;
+
+    return NULL;
+}
+
+GroupQueueInfo* ArenaQueueRatingIndex::FindOpponent(GroupQueueInfo const* anchor, ArenaRatingWindow const& rules, uint32 now, bool opponentWindows) const
+{
+    uint32 window = rules.GetWindow(WorldTimer::getMSTimeDiff(anchor->JoinTime, now));
+
+    // windows grow with time in queue, none is wider than the one of the longest waiting team
+    uint32 searchWindow = window;
+    if (opponentWindows)
+    {
+        GroupQueueInfo* oldest = GetOldest(anchor);
+        if (!oldest)
+            return NULL;
+
+        searchWindow = std::max(window, rules.GetWindow(WorldTimer::getMSTimeDiff(oldest->JoinTime, now)));
+    }
+
+    if (searchWindow == ARENA_QUEUE_UNLIMITED_WINDOW)
+        return GetOldest(anchor);
+
+    uint32 rating = anchor->MatchmakingRating;
+    uint32 minRating = rating > searchWindow ? rating - searchWindow : 0;
+    uint32 maxRating = searchWindow > ARENA_QUEUE_UNLIMITED_WINDOW - rating ? ARENA_QUEUE_UNLIMITED_WINDOW : rating + searchWindow;
+    uint32 lastBucket = maxRating / ARENA_QUEUE_RATING_BUCKET_SIZE;
+
+    GroupQueueInfo* found = NULL;
+    std::set<BucketKey>::const_iterator itr = m_ByBucket.lower_bound(BucketKey(minRating / ARENA_QUEUE_RATING_BUCKET_SIZE, 0, NULL));
+    while (itr != m_ByBucket.end() && itr->Bucket <= lastBucket)
+    {
+        uint32 bucket = itr->Bucket;
+        // teams in bucket are sorted by join time, so first fitting one waits longest
+        // only border buckets can hold teams out of anchor's window
+        for (; itr != m_ByBucket.end() && itr->Bucket == bucket; ++itr)
+        {
+            GroupQueueInfo* ginfo = itr->GroupInfo;
+            if (ginfo == anchor || ginfo->MatchmakingRating < minRating || ginfo->MatchmakingRating > maxRating)
+                continue;
+
+            uint32 diff = ginfo->MatchmakingRating > rating ? ginfo->MatchmakingRating - rating : rating - ginfo->MatchmakingRating;
+            if (diff > window)
+            {
+                if (!opponentWindows)
+                    continue;
+
+                uint32 ownWindow = rules.GetWindow(WorldTimer::getMSTimeDiff(ginfo->JoinTime, now));
+                if (diff > ownWindow)
+                {
+                    // later teams of the bucket have narrower windows and ratings less than a bucket closer
+                    if (diff >= ARENA_QUEUE_RATING_BUCKET_SIZE && std::max(window, ownWindow) <= diff - ARENA_QUEUE_RATING_BUCKET_SIZE)
+                        break;
+                    continue;
+                }
+            }
+
+            if (!found || ginfo->JoinTime < found->JoinTime)
+                found = ginfo;
+            break;
+        }
+
+        // jump to next non-empty bucket
+        if (bucket == lastBucket)
+            break;
+        itr = m_ByBucket.lower_bound(BucketKey(bucket + 1, 0, NULL));
+    }
+
+    return found;
+}
+
 // selection pool initialization, used to clean up from prev selection
 void BattleGroundQueue::SelectionPool::Init()
 {
@@ -153,6 +264,7 @@ GroupQueueInfo * BattleGroundQueue::AddGroup(Player *leader, BattleGroundTypeId
     ginfo->HiddenRating              = hiddenRating;
     ginfo->OpponentsTeamRating       = 0;
     ginfo->OpponentsHiddenRating     = 0;
+    ginfo->MatchmakingRating         = sWorld.getConfig(CONFIG_ENABLE_HIDDEN_RATING) ? hiddenRating : arenaRating;
 
     ginfo->Players.clear();
 
@@ -166,6 +278,11 @@ GroupQueueInfo * BattleGroundQueue::AddGroup(Player *leader, BattleGroundTypeId
     DEBUG_LOG("Adding Group to BattleGroundQueue bgTypeId : %u, bracket_id : %u, index : %u", BgTypeId, bracketId, index);
 
     m_QueuedGroups[bracketId][index].push_back(ginfo);
+    if (isRated)
+    {
+        ginfo->QueuePosition = --m_QueuedGroups[bracketId][index].end();
+        m_RatedTeams[bracketId].Insert(ginfo);
+    }
 
     // return ginfo, because it is needed to add players to this group info
     return ginfo;
@@ -273,6 +390,8 @@ void BattleGroundQueue::RemovePlayer(const uint64& guid, bool decreaseInvitedCou
     if (group->Players.empty())
     {
         m_QueuedGroups[bracket_id][index].erase(group_itr);
+        if (group->IsRated)
+            m_RatedTeams[bracket_id].Remove(group);
         delete group;
     }
     // if group wasn't empty, so it wasn't deleted, and player have left a rated
@@ -884,196 +1003,98 @@ void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketI
     }
     else if (bg_template->isArena())
     {
-        bool hiddenEnabled = sWorld.getConfig(CONFIG_ENABLE_HIDDEN_RATING);
-        bool stepbystepEnabled = sWorld.getConfig(CONFIG_ENABLE_ARENA_STEP_BY_STEP_MATCHING);
-        uint32 stepbystepTime = sWorld.getConfig(CONFIG_ARENA_STEP_BY_STEP_TIME);
-        uint32 stepbystepValue = sWorld.getConfig(CONFIG_ARENA_STEP_BY_STEP_VALUE);
-        // found out the minimum and maximum ratings the newly added team should battle against
-        // arenaRating is the rating of the latest joined team, or 0
-        // 0 is on (automatic update call) and we must set it to team's with longest wait time
-        if (!arenaRating )
-        {
-            GroupQueueInfo* front1 = NULL;
-            GroupQueueInfo* front2 = NULL;
-            if (!m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].empty())
-            {
-                front1 = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].front();
-                arenaRating = front1->ArenaTeamRating;
-            }
-            if (!m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].empty())
-            {
-                front2 = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].front();
-                arenaRating = front2->ArenaTeamRating;
-            }
-            if (front1 && front2)
-            {
-                if (front1->JoinTime < front2->JoinTime)
-                    arenaRating = front1->ArenaTeamRating;
-            }
-            else if (!front1 && !front2)
-                return; //queues are empty
-        }
+        // arenaRating is the rating of the latest joined team, or 0 on automatic update call
+        // a new team can only make a match for itself, the automatic update rechecks everybody with widened windows
+        UpdateRatedArena(bgTypeId, bracket_id, arenaType, !arenaRating);
+    }
+}
 
-        //set rating range
-        uint32 arenaMinRating = ((hiddenEnabled ? hiddenRating : arenaRating) <= sBattleGroundMgr.GetMaxRatingDifference()) ? 0 : (hiddenEnabled ? hiddenRating : arenaRating) - sBattleGroundMgr.GetMaxRatingDifference();
-        uint32 arenaMaxRating = ((hiddenEnabled ? hiddenRating : arenaRating) == 0)? 0 : (hiddenEnabled ? hiddenRating : arenaRating) + sBattleGroundMgr.GetMaxRatingDifference();
-        // if max rating difference is set and the time past since server startup is greater than the rating discard time
-        // (after what time the ratings aren't taken into account when making teams) then
-        // the discard time is current_time - time_to_discard, teams that joined after that, will have their ratings taken into account
-        // else leave the discard time on 0, this way all ratings will be discarded
-        uint32 discardTime = stepbystepEnabled ? WorldTimer::getMSTime() : (WorldTimer::getMSTime() - sBattleGroundMgr.GetRatingDiscardTimer());
+/*
+matches rated arena teams using m_RatedTeams index
+two teams can play against each other if their rating difference fits into the window of any of them,
+windows only grow with time spent in queue, so it is enough to look for opponents inside the anchor's window
+while checking anchors from the longest waiting one
+a joining team is the newest one and has the narrowest window, so it is checked against the windows of the others too
+*/
+void BattleGroundQueue::UpdateRatedArena(BattleGroundTypeId bgTypeId, BattleGroundBracketId bracket_id, uint8 arenaType, bool fullPass)
+{
+    ArenaQueueRatingIndex& ratedTeams = m_RatedTeams[bracket_id];
+    if (ratedTeams.Size() < 2)
+        return;
 
-        // we need to find 2 teams which will play next game
+    ArenaRatingWindow window = sBattleGroundMgr.GetArenaRatingWindow();
+    uint32 now = WorldTimer::getMSTime();
 
-        GroupsQueueType::iterator itr_team[BG_TEAMS_COUNT];
+    if (!fullPass)
+    {
+        GroupQueueInfo* anchor = ratedTeams.GetNewest();
+        if (GroupQueueInfo* opponent = ratedTeams.FindOpponent(anchor, window, now, true))
+            StartRatedArena(opponent, anchor, bgTypeId, bracket_id, arenaType);
+        return;
+    }
 
-        //optimalization : --- we dont need to use selection_pools - each update we select max 2 groups
+    // matched teams are removed from index, so iterate over a copy
+    std::vector<GroupQueueInfo*> anchors;
+    anchors.reserve(ratedTeams.Size());
+    for (ArenaQueueRatingIndex::JoinTimeIndex::const_iterator itr = ratedTeams.GetJoinTimeIndex().begin(); itr != ratedTeams.GetJoinTimeIndex().end(); ++itr)
+        anchors.push_back(itr->second);
 
-        for(uint32 i = BG_QUEUE_PREMADE_ALLIANCE; i < BG_QUEUE_NORMAL_ALLIANCE; i++)
-        {
-            // take the group that joined first
-            itr_team[i] = m_QueuedGroups[bracket_id][i].begin();
-            for(; itr_team[i] != m_QueuedGroups[bracket_id][i].end(); ++(itr_team[i]))
-            {
-                uint32 arenaTeamRating = hiddenEnabled ? (*itr_team[i])->HiddenRating : (*itr_team[i])->ArenaTeamRating;
-                // if group match conditions, then add it to pool
-                if (stepbystepEnabled)
-                {
-                    uint32 stepbystepChange = stepbystepValue * (uint8)((discardTime - (*itr_team[i])->JoinTime)/stepbystepTime);
-                    if( !(*itr_team[i])->IsInvitedToBGInstanceGUID
-                        && (arenaTeamRating + stepbystepChange >= arenaMinRating
-                        && arenaTeamRating - stepbystepChange <= arenaMaxRating))
-                    {
-                        m_SelectionPools[i].AddGroup((*itr_team[i]), MaxPlayersPerTeam);
-                        // break for cycle to be able to start selecting another group from same faction queue
-                        break;
-                    }
-                }
-                else
-                {
-                    if( !(*itr_team[i])->IsInvitedToBGInstanceGUID
-                        && ((arenaTeamRating >= arenaMinRating && arenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[i])->JoinTime < discardTime) )
-                    {
-                        m_SelectionPools[i].AddGroup((*itr_team[i]), MaxPlayersPerTeam);
-                        // break for cycle to be able to start selecting another group from same faction queue
-                        break;
-                    }
-                }
-            }
-        }
-        // now we are done if we have 2 groups - ali vs horde!
-        // if we don't have, we must try to continue search in same queue
-        // tmp variables are correctly set
-        // this code isn't much userfriendly - but it is supposed to continue search for mathing group in HORDE queue
-        if (m_SelectionPools[BG_TEAM_ALLIANCE].GetPlayerCount() == 0 && m_SelectionPools[BG_TEAM_HORDE].GetPlayerCount())
-        {
-            itr_team[BG_TEAM_ALLIANCE] = itr_team[BG_TEAM_HORDE];
-            ++itr_team[BG_TEAM_ALLIANCE];
-            for(; itr_team[BG_TEAM_ALLIANCE] != m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].end(); ++(itr_team[BG_TEAM_ALLIANCE]))
-            {
-                uint32 arenaTeamRatingA = hiddenEnabled ? (*itr_team[BG_TEAM_ALLIANCE])->HiddenRating : (*itr_team[BG_TEAM_ALLIANCE])->ArenaTeamRating;
+    for (std::vector<GroupQueueInfo*>::const_iterator itr = anchors.begin(); itr != anchors.end() && ratedTeams.Size() >= 2; ++itr)
+    {
+        GroupQueueInfo* anchor = *itr;
+        if (anchor->IsInvitedToBGInstanceGUID)
+            continue;
 
-                if (stepbystepEnabled)
-                {
-                    uint32 stepbystepChange = stepbystepValue * (uint8)((discardTime - (*itr_team[BG_TEAM_ALLIANCE])->JoinTime)/stepbystepTime);
-                    if( !(*itr_team[BG_TEAM_ALLIANCE])->IsInvitedToBGInstanceGUID
-                        && (arenaTeamRatingA + stepbystepChange >= arenaMinRating
-                        && arenaTeamRatingA - stepbystepChange <= arenaMaxRating))
-                    {
-                        m_SelectionPools[BG_TEAM_ALLIANCE].AddGroup((*itr_team[BG_TEAM_ALLIANCE]), MaxPlayersPerTeam);
-                        // break for cycle to be able to start selecting another group from same faction queue
-                        break;
-                    }
-                }
-                else
-                {
-                    if( !(*itr_team[BG_TEAM_ALLIANCE])->IsInvitedToBGInstanceGUID
-                        && ((arenaTeamRatingA >= arenaMinRating && arenaTeamRatingA <= arenaMaxRating)
-                            || (*itr_team[BG_TEAM_ALLIANCE])->JoinTime < discardTime) )
-                    {
-                        m_SelectionPools[BG_TEAM_ALLIANCE].AddGroup((*itr_team[BG_TEAM_ALLIANCE]), MaxPlayersPerTeam);
-                        // break for cycle to be able to start selecting another group from same faction queue
-                        break;
-                    }
-                }
-            }
-        }
-        // this code isn't much userfriendly - but it is supposed to continue search for mathing group in ALLIANCE queue
-        if (m_SelectionPools[BG_TEAM_HORDE].GetPlayerCount() == 0 && m_SelectionPools[BG_TEAM_ALLIANCE].GetPlayerCount())
-        {
-            itr_team[BG_TEAM_HORDE] = itr_team[BG_TEAM_ALLIANCE];
-            ++itr_team[BG_TEAM_HORDE];
-            for(; itr_team[BG_TEAM_HORDE] != m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].end(); ++(itr_team[BG_TEAM_HORDE]))
-            {
-                uint32 arenaTeamRatingH = hiddenEnabled ? (*itr_team[BG_TEAM_HORDE])->HiddenRating : (*itr_team[BG_TEAM_HORDE])->ArenaTeamRating;
+        GroupQueueInfo* opponent = ratedTeams.FindOpponent(anchor, window, now, false);
+        if (opponent && !StartRatedArena(anchor, opponent, bgTypeId, bracket_id, arenaType))
+            return;
+    }
+}
 
-                if (stepbystepEnabled)
-                {
-                    uint32 stepbystepChange = stepbystepValue * (uint8)((discardTime - (*itr_team[BG_TEAM_HORDE])->JoinTime)/stepbystepTime);
-                    if( !(*itr_team[BG_TEAM_HORDE])->IsInvitedToBGInstanceGUID
-                        && (arenaTeamRatingH + stepbystepChange >= arenaMinRating
-                        && arenaTeamRatingH - stepbystepChange <= arenaMaxRating))
-                    {
-                        m_SelectionPools[BG_TEAM_HORDE].AddGroup((*itr_team[BG_TEAM_HORDE]), MaxPlayersPerTeam);
-                        // break for cycle to be able to start selecting another group from same faction queue
-                        break;
-                    }
-                }
-                else
-                {
-                    if( !(*itr_team[BG_TEAM_HORDE])->IsInvitedToBGInstanceGUID
-                        && ((arenaTeamRatingH >= arenaMinRating && arenaTeamRatingH <= arenaMaxRating)
-                            || (*itr_team[BG_TEAM_HORDE])->JoinTime < discardTime) )
-                    {
-                        m_SelectionPools[BG_TEAM_HORDE].AddGroup((*itr_team[BG_TEAM_HORDE]), MaxPlayersPerTeam);
-                        // break for cycle to be able to start selecting another group from same faction queue
-                        break;
-                    }
-                }
-            }
-        }
+// creates rated arena for two teams, team1 is the one waiting longer and keeps its faction side
+bool BattleGroundQueue::StartRatedArena(GroupQueueInfo* team1, GroupQueueInfo* team2, BattleGroundTypeId bgTypeId, BattleGroundBracketId bracket_id, uint8 arenaType)
+{
+    BattleGround* arena = sBattleGroundMgr.CreateNewBattleGround(bgTypeId, bracket_id, arenaType, true);
+    if (!arena)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: BattlegroundQueue::Update couldn't create arena instance for rated arena match!");
+        return false;
+    }
 
-        //if we have 2 teams, then start new arena and invite players!
-        if (m_SelectionPools[BG_TEAM_ALLIANCE].GetPlayerCount() && m_SelectionPools[BG_TEAM_HORDE].GetPlayerCount())
-        {
-            BattleGround* arena = sBattleGroundMgr.CreateNewBattleGround(bgTypeId, bracket_id, arenaType, true);
-            if (!arena)
-            {
-                sLog.outLog(LOG_DEFAULT, "ERROR: BattlegroundQueue::Update couldn't create arena instance for rated arena match!");
-                return;
-            }
+    GroupQueueInfo* aliTeam = team1->Team == HORDE ? team2 : team1;
+    GroupQueueInfo* hordeTeam = team1->Team == HORDE ? team1 : team2;
 
-            (*(itr_team[BG_TEAM_ALLIANCE]))->OpponentsTeamRating = (*(itr_team[BG_TEAM_HORDE]))->ArenaTeamRating;
-            (*(itr_team[BG_TEAM_ALLIANCE]))->OpponentsHiddenRating = (*(itr_team[BG_TEAM_HORDE]))->HiddenRating;
-            DEBUG_LOG("setting oposite teamrating for team %u to %u", (*(itr_team[BG_TEAM_ALLIANCE]))->ArenaTeamId, (*(itr_team[BG_TEAM_ALLIANCE]))->OpponentsTeamRating);
-            (*(itr_team[BG_TEAM_HORDE]))->OpponentsTeamRating = (*(itr_team[BG_TEAM_ALLIANCE]))->ArenaTeamRating;
-            (*(itr_team[BG_TEAM_HORDE]))->OpponentsHiddenRating = (*(itr_team[BG_TEAM_ALLIANCE]))->HiddenRating;
-            DEBUG_LOG("setting oposite teamrating for team %u to %u", (*(itr_team[BG_TEAM_HORDE]))->ArenaTeamId, (*(itr_team[BG_TEAM_HORDE]))->OpponentsTeamRating);
-            // now we must move team if we changed its faction to another faction queue, because then we will spam log by errors in Queue::RemovePlayer
-            if ((*(itr_team[BG_TEAM_ALLIANCE]))->Team != ALLIANCE)
-            {
-                // add to alliance queue
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].push_front(*(itr_team[BG_TEAM_ALLIANCE]));
-                // erase from horde queue
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].erase(itr_team[BG_TEAM_ALLIANCE]);
-                itr_team[BG_TEAM_ALLIANCE] = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].begin();
-            }
-            if ((*(itr_team[BG_TEAM_HORDE]))->Team != HORDE)
-            {
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].push_front(*(itr_team[BG_TEAM_HORDE]));
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].erase(itr_team[BG_TEAM_HORDE]);
-                itr_team[BG_TEAM_HORDE] = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].begin();
-            }
+    // now we must move team if we changed its faction to another faction queue, because then we will spam log by errors in Queue::RemovePlayer
+    if (aliTeam->Team != ALLIANCE)
+        MoveGroupToQueue(aliTeam, bracket_id, BG_QUEUE_PREMADE_HORDE, BG_QUEUE_PREMADE_ALLIANCE);
+    if (hordeTeam->Team != HORDE)
+        MoveGroupToQueue(hordeTeam, bracket_id, BG_QUEUE_PREMADE_ALLIANCE, BG_QUEUE_PREMADE_HORDE);
 
-            InviteGroupToBG(*(itr_team[BG_TEAM_ALLIANCE]), arena, ALLIANCE);
-            InviteGroupToBG(*(itr_team[BG_TEAM_HORDE]), arena, HORDE);
+    aliTeam->OpponentsTeamRating = hordeTeam->ArenaTeamRating;
+    aliTeam->OpponentsHiddenRating = hordeTeam->HiddenRating;
+    DEBUG_LOG("setting oposite teamrating for team %u to %u", aliTeam->ArenaTeamId, aliTeam->OpponentsTeamRating);
+    hordeTeam->OpponentsTeamRating = aliTeam->ArenaTeamRating;
+    hordeTeam->OpponentsHiddenRating = aliTeam->HiddenRating;
+    DEBUG_LOG("setting oposite teamrating for team %u to %u", hordeTeam->ArenaTeamId, hordeTeam->OpponentsTeamRating);
 
-            DEBUG_LOG("Starting rated arena match!");
+    // invited teams can't be selected again
+    m_RatedTeams[bracket_id].Remove(aliTeam);
+    m_RatedTeams[bracket_id].Remove(hordeTeam);
 
-            arena->StartBattleGround();
-        }
-    }
+    InviteGroupToBG(aliTeam, arena, ALLIANCE);
+    InviteGroupToBG(hordeTeam, arena, HORDE);
+
+    DEBUG_LOG("Starting rated arena match!");
+
+    arena->StartBattleGround();
+    return true;
+}
+
+void BattleGroundQueue::MoveGroupToQueue(GroupQueueInfo* ginfo, BattleGroundBracketId bracket_id, uint32 from, uint32 to)
+{
+    m_QueuedGroups[bracket_id][from].erase(ginfo->QueuePosition);
+    m_QueuedGroups[bracket_id][to].push_front(ginfo);
+    ginfo->QueuePosition = m_QueuedGroups[bracket_id][to].begin();
 }
 
 uint32 BattleGroundQueue::GetQueuedPlayersCount(BattleGroundTeamId team, BattleGroundBracketId bracketId)
@@ -2070,6 +2091,17 @@ uint32 BattleGroundMgr::GetRatingDiscardTimer() const
     return sWorld.getConfig(CONFIG_ARENA_RATING_DISCARD_TIMER);
 }
 
+ArenaRatingWindow BattleGroundMgr::GetArenaRatingWindow() const
+{
+    ArenaRatingWindow window;
+    window.MaxRatingDifference = GetMaxRatingDifference();
+    window.DiscardTime = GetRatingDiscardTimer();
+    window.StepByStep = sWorld.getConfig(CONFIG_ENABLE_ARENA_STEP_BY_STEP_MATCHING);
+    window.StepTime = sWorld.getConfig(CONFIG_ARENA_STEP_BY_STEP_TIME);
+    window.StepValue = sWorld.getConfig(CONFIG_ARENA_STEP_BY_STEP_VALUE);
+    return window;
+}
+
 uint32 BattleGroundMgr::GetPrematureFinishTime() const
 {
     return sWorld.getConfig(CONFIG_BATTLEGROUND_PREMATURE_FINISH_TIMER);
@@ -60,6 +60,8 @@ struct GroupQueueInfo                                       // stores informatio
     uint32  HiddenRating;                                   // if rated match, inited to the rating of the team
     uint32  OpponentsTeamRating;                            // for rated arena matches
     uint32  OpponentsHiddenRating;                          // for rated arena matches
+    uint32  MatchmakingRating;                              // rating used for matchmaking (team or hidden rating), key in ArenaQueueRatingIndex
+    std::list<GroupQueueInfo*>::iterator QueuePosition;     // rated teams only, position in BattleGroundQueue::m_QueuedGroups
 
     BattleGroundTeamId GetBGTeam()
     {
@@ -67,6 +69,75 @@ struct GroupQueueInfo                                       // stores informatio
     }
 };
 
+#define ARENA_QUEUE_RATING_BUCKET_SIZE  25                  // rating span covered by one bucket of ArenaQueueRatingIndex
+#define ARENA_QUEUE_UNLIMITED_WINDOW    0xFFFFFFFF
+
+// allowed rating difference of a rated arena team, widening with time spent in queue
+struct ArenaRatingWindow
+{
+    uint32 MaxRatingDifference;                             // 0 when ratings are not taken into account at all
+    uint32 DiscardTime;                                     // ms in queue after which rating is discarded (when not step by step)
+    bool   StepByStep;                                      // widen by StepValue every StepTime ms instead of discarding
+    uint32 StepTime;
+    uint32 StepValue;
+
+    uint32 GetWindow(uint32 waitTime) const;
+};
+
+/*
+    Rated arena teams waiting in one bracket, indexed by rating bucket and join time.
+    Teams are kept in buckets of ARENA_QUEUE_RATING_BUCKET_SIZE rating points, ordered by join time inside each bucket,
+    so the longest waiting team within a rating window is found with one O(log n) lookup per non-empty bucket
+    instead of walking whole m_QueuedGroups lists. Invited teams are removed from the index.
+*/
+class ArenaQueueRatingIndex
+{
+    public:
+        typedef std::set<std::pair<uint32, GroupQueueInfo*> > JoinTimeIndex;
+
+        void Insert(GroupQueueInfo* ginfo);
+        void Remove(GroupQueueInfo* ginfo);
+        void Clear();
+
+        bool Empty() const { return m_ByJoinTime.empty(); }
+        uint32 Size() const { return m_ByJoinTime.size(); }
+
+        GroupQueueInfo* GetNewest() const { return m_ByJoinTime.empty() ? NULL : m_ByJoinTime.rbegin()->second; }
+        GroupQueueInfo* GetOldest(GroupQueueInfo const* exclude = NULL) const;
+        // longest waiting team other than anchor with rating within window of anchor's rating,
+        // with opponentWindows also the teams whose own (wider) window holds anchor's rating
+        GroupQueueInfo* FindOpponent(GroupQueueInfo const* anchor, ArenaRatingWindow const& rules, uint32 now, bool opponentWindows) const;
+
+        JoinTimeIndex const& GetJoinTimeIndex() const { return m_ByJoinTime; }
+
+    private:
+        struct BucketKey
+        {
+            BucketKey(uint32 bucket, uint32 joinTime, GroupQueueInfo* ginfo) : Bucket(bucket), JoinTime(joinTime), GroupInfo(ginfo) {}
+
+            bool operator<(BucketKey const& other) const
+            {
+                if (Bucket != other.Bucket)
+                    return Bucket < other.Bucket;
+                if (JoinTime != other.JoinTime)
+                    return JoinTime < other.JoinTime;
+                return GroupInfo < other.GroupInfo;
+            }
+
+            uint32 Bucket;
+            uint32 JoinTime;
+            GroupQueueInfo* GroupInfo;
+        };
+
+        static BucketKey MakeKey(GroupQueueInfo* ginfo)
+        {
+            return BucketKey(ginfo->MatchmakingRating / ARENA_QUEUE_RATING_BUCKET_SIZE, ginfo->JoinTime, ginfo);
+        }
+
+        std::set<BucketKey> m_ByBucket;
+        JoinTimeIndex m_ByJoinTime;
+};
+
 enum BattleGroundQueueGroupTypes
 {
     BG_QUEUE_PREMADE_ALLIANCE   = 0,
@@ -135,6 +206,9 @@ class BattleGroundQueue
         //one selection pool for horde, other one for alliance
         SelectionPool m_SelectionPools[BG_TEAMS_COUNT];
 
+        // rated teams of both factions, used to find rating compatible opponents
+        ArenaQueueRatingIndex m_RatedTeams[MAX_BATTLEGROUND_BRACKETS];
+
         typedef ACE_Atomic_Op<ACE_Thread_Mutex, uint32> atomicUInt32;
         atomicUInt32 queuedPlayersCount[BG_TEAMS_COUNT][MAX_BATTLEGROUND_BRACKETS];
         atomicUInt32 queuedPlayersCountCrossfaction[MAX_BATTLEGROUND_BRACKETS];
@@ -142,6 +216,10 @@ class BattleGroundQueue
     private:
 
         bool InviteGroupToBG(GroupQueueInfo * ginfo, BattleGround * bg, uint32 side);
+
+        void UpdateRatedArena(BattleGroundTypeId bgTypeId, BattleGroundBracketId bracket_id, uint8 arenaType, bool fullPass);
+        bool StartRatedArena(GroupQueueInfo* team1, GroupQueueInfo* team2, BattleGroundTypeId bgTypeId, BattleGroundBracketId bracket_id, uint8 arenaType);
+        void MoveGroupToQueue(GroupQueueInfo* ginfo, BattleGroundBracketId bracket_id, uint32 from, uint32 to);
 };
 
 /*
@@ -238,6 +316,7 @@ class BattleGroundMgr
 
         uint32 GetMaxRatingDifference() const;
         uint32 GetRatingDiscardTimer()  const;
+        ArenaRatingWindow GetArenaRatingWindow() const;
         uint32 GetPrematureFinishTime() const;
         bool IsPrematureFinishTimerEnabled() {return sWorld.getConfig(CONFIG_BATTLEGROUND_TIMER_INFO);}
 
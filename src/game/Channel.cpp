@@ -119,10 +119,7 @@ void Channel::Join(uint64 p, const char *pass)
 
     data.clear();
 
-    PlayerInfo pinfo;
-    pinfo.player = p;
-    pinfo.flags = 0;
-    players[p] = pinfo;
+    AddMember(p, plr);
 
     MakeYouJoined(&data);
     SendToOne(&data, p);
@@ -164,7 +161,7 @@ void Channel::Leave(uint64 p, bool send)
 
         bool changeowner = players[p].IsOwner();
 
-        players.erase(p);
+        RemoveMember(p);
         if (m_announce && (!plr || !plr->GetSession()->HasPermissions(PERM_GMT) || !sWorld.getConfig(CONFIG_SILENTLY_GM_JOIN_TO_CHANNEL)))
         {
             WorldPacket data;
@@ -228,7 +225,7 @@ void Channel::KickOrBan(uint64 good, const char *badname, bool ban)
                 MakePlayerKicked(&data, bad->GetGUID(), good);
 
             SendToAll(&data);
-            players.erase(bad->GetGUID());
+            RemoveMember(bad->GetGUID());
             bad->LeftChannel(this);
 
             if (changeowner)
@@ -594,7 +591,18 @@ void Channel::Say(uint64 p, const char *what, uint32 lang)
         data << what;
         data << uint8(plr ? plr->chatTag() : 0);
 
+        ACE_Time_Value start = ACE_OS::gettimeofday();
+
         SendToAll(&data, !players[p].IsModerator() ? p : false);
+
+        ACE_Time_Value spent = ACE_OS::gettimeofday() - start;
+        uint64 time = uint64(spent.sec()) * 1000000 + spent.usec();
+
+        ++m_fanoutStats.messages;
+        m_fanoutStats.recipients += m_members.size();
+        m_fanoutStats.totalTime += time;
+        if (time > m_fanoutStats.maxTime)
+            m_fanoutStats.maxTime = time;
     }
 }
 
@@ -676,14 +684,58 @@ void Channel::SetOwner(uint64 guid, bool exclaim)
     }
 }
 
+void Channel::AddMember(uint64 guid, Player* plr)
+{
+    PlayerInfo& pinfo = players[guid];
+    pinfo.player = guid;
+    pinfo.flags = 0;
+
+    if (pinfo.memberIndex != CHANNEL_NO_MEMBER_INDEX)
+    {
+        m_members[pinfo.memberIndex].player = plr;
+        return;
+    }
+
+    ChannelMember member;
+    member.guid = guid;
+    member.player = plr;
+
+    pinfo.memberIndex = m_members.size();
+    m_members.push_back(member);
+}
+
+void Channel::RemoveMember(uint64 guid)
+{
+    PlayerList::iterator itr = players.find(guid);
+    if (itr == players.end())
+        return;
+
+    uint32 index = itr->second.memberIndex;
+    players.erase(itr);
+
+    if (index == CHANNEL_NO_MEMBER_INDEX)
+        return;
+
+    // move last member to freed slot
+    if (index != m_members.size() - 1)
+    {
+        m_members[index] = m_members.back();
+        players[m_members[index].guid].memberIndex = index;
+    }
+
+    m_members.pop_back();
+}
+
 void Channel::SendToAll(WorldPacket *data, uint64 p)
 {
-    for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
+    uint32 ignoredGuid = GUID_LOPART(p);
+
+    for (MemberList::const_iterator i = m_members.begin(); i != m_members.end(); ++i)
     {
-        Player *plr = sObjectMgr.GetPlayer(i->first);
+        Player *plr = i->player ? i->player : sObjectMgr.GetPlayer(i->guid);
         if (plr)
         {
-            if (!p || !plr->GetSocial()->HasIgnore(GUID_LOPART(p)))
+            if (!p || !plr->GetSocial()->HasIgnore(ignoredGuid))
                 plr->SendPacketToSelf(data);
         }
     }
@@ -691,11 +743,11 @@ void Channel::SendToAll(WorldPacket *data, uint64 p)
 
 void Channel::SendToAllButOne(WorldPacket *data, uint64 who)
 {
-    for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
+    for (MemberList::const_iterator i = m_members.begin(); i != m_members.end(); ++i)
     {
-        if (i->first != who)
+        if (i->guid != who)
         {
-            Player *plr = sObjectMgr.GetPlayer(i->first);
+            Player *plr = i->player ? i->player : sObjectMgr.GetPlayer(i->guid);
             if (plr)
                 plr->SendPacketToSelf(data);
         }
@@ -30,6 +30,19 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
+
+#define CHANNEL_NO_MEMBER_INDEX     0xFFFFFFFF
+
+struct ChannelFanoutStats
+{
+    ChannelFanoutStats() : messages(0), recipients(0), totalTime(0), maxTime(0) {}
+
+    uint32 messages;                                        // chat messages sent to channel
+    uint64 recipients;                                      // packets sent for them
+    uint64 totalTime;                                       // microseconds spent sending them
+    uint64 maxTime;                                         // longest single message
+};
 
 class Channel
 {
@@ -122,8 +135,11 @@ class Channel
 
     struct PlayerInfo
     {
+        PlayerInfo() : player(0), flags(0), memberIndex(CHANNEL_NO_MEMBER_INDEX) {}
+
         uint64 player;
         uint8 flags;
+        uint32 memberIndex;                                 // position in m_members
 
         bool HasFlag(uint8 flag) { return flags & flag; }
         void SetFlag(uint8 flag) { if (!HasFlag(flag)) flags |= flag; }
@@ -147,8 +163,19 @@ class Channel
         }
     };
 
+    // recipients of channel packets, kept apart from PlayerList so sending doesn't need
+    // player lookups; Player leaves all channels before it is deleted (CleanupChannels)
+    struct ChannelMember
+    {
+        uint64 guid;
+        Player* player;                                     // NULL if not in world at join
+    };
+
     typedef     std::map<uint64, PlayerInfo> PlayerList;
     PlayerList  players;
+    typedef     std::vector<ChannelMember> MemberList;
+    MemberList  m_members;
+    ChannelFanoutStats m_fanoutStats;
     typedef     std::set<uint64> BannedList;
     BannedList  banned;
     bool        m_announce;
@@ -160,6 +187,9 @@ class Channel
     uint64      m_ownerGUID;
 
     private:
+        void AddMember(uint64 guid, Player* plr);
+        void RemoveMember(uint64 guid);
+
         void ChangeOwner();
         // initial packet data (notify type and channel name)
         void MakeNotifyPacket(WorldPacket *data, uint8 notify_type);
@@ -254,6 +284,7 @@ class Channel
         void SetPassword(const std::string& npassword) { m_password = npassword; }
         void SetAnnounce(bool nannounce) { m_announce = nannounce; }
         uint32 GetNumPlayers() const { return players.size(); }
+        ChannelFanoutStats const& GetFanoutStats() const { return m_fanoutStats; }
         uint8 GetFlags() const { return m_flags; }
         bool HasFlag(uint8 flag) { return m_flags & flag; }
 
@@ -82,6 +82,8 @@ class ChannelMgr
             }
         }
 
+        ChannelMap const& GetChannels() const { return channels; }
+
         std::list<std::string> GetCustomChannelNames()
         {
             std::list<std::string> tmpList;
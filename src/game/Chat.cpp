@@ -252,6 +252,15 @@ ChatCommand * ChatHandler::getCommandTable()
         { NULL,             0,              false, NULL,                                                "", NULL }
     };
 
+    static ChatCommand debugStatsCommandTable[] =
+    {
+        { "channels",       PERM_ADM,       false, &ChatHandler::HandleDebugStatsChannelsCommand,       "", NULL },
+        { "map",            PERM_ADM,       false, &ChatHandler::HandleDebugStatsMapCommand,            "", NULL },
+        { "opcodes",        PERM_ADM,       true,  &ChatHandler::HandleDebugStatsOpcodesCommand,        "", NULL },
+        { "player",         PERM_ADM,       false, &ChatHandler::HandleDebugStatsPlayerCommand,         "", NULL },
+        { NULL,             0,              false, NULL,                                                "", NULL }
+    };
+
     static ChatCommand debugCommandTable[] =
     {
         { "addformation",   PERM_DEVELOPER, false,  &ChatHandler::HandleDebugAddFormationToFileCommand, "", NULL },
@@ -273,6 +282,7 @@ ChatCommand * ChatHandler::getCommandTable()
         { "setinstdata64",  PERM_ADM,       false,  &ChatHandler::HandleDebugSetInstanceData64Command,  "", NULL },
         { "setitemflag",    PERM_ADM,       false,  &ChatHandler::HandleDebugSetItemFlagCommand,        "", NULL },
         { "setvalue",       PERM_ADM,       false,  &ChatHandler::HandleDebugSetValue,                  "", NULL },
+        { "stats",          PERM_ADM,       true,   NULL,                                               "", debugStatsCommandTable },
         { "showcombatstats",PERM_ADM,       false,  &ChatHandler::HandleDebugShowCombatStats,           "", NULL },
         { "threatlist",     PERM_GMT_DEV,   false,  &ChatHandler::HandleDebugThreatList,                "", NULL },
         { "printstate",     PERM_PLAYER,    false,  &ChatHandler::HandleDebugUnitState,                 "", NULL },
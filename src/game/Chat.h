@@ -140,6 +140,10 @@ class ChatHandler
         bool HandleDebugAddFormationToFileCommand(const char* args);
         bool HandleDebugAnimCommand(const char* args);
         bool HandleDebugArenaCommand(const char * args);
+        bool HandleDebugStatsChannelsCommand(const char * args);
+        bool HandleDebugStatsMapCommand(const char * args);
+        bool HandleDebugStatsOpcodesCommand(const char * args);
+        bool HandleDebugStatsPlayerCommand(const char * args);
         bool HandleDebugBattleGroundCommand(const char * args);
         bool HandleDebugGetInstanceDataCommand(const char* args);
         bool HandleDebugGetInstanceData64Command(const char* args);
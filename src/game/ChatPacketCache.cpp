@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2005-2009 MaNGOS <http://getmangos.com/>
+ *
+ * Copyright (C) 2008-2009 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ChatPacketCache.h"
+
+ACE_Atomic_Op<ACE_Thread_Mutex, uint32> ChatPacketCache::s_generation(0);
+
+bool ChatPacketKey::operator<(ChatPacketKey const& other) const
+{
+    if (speaker != other.speaker)
+        return speaker < other.speaker;
+    if (textId != other.textId)
+        return textId < other.textId;
+    if (locale != other.locale)
+        return locale < other.locale;
+    if (target != other.target)
+        return target < other.target;
+    if (language != other.language)
+        return language < other.language;
+    if (msgType != other.msgType)
+        return msgType < other.msgType;
+    return withoutPrename < other.withoutPrename;
+}
+
+void ChatPacketCache::Update()
+{
+    uint32 generation = s_generation.value();
+    if (m_generation != generation)
+    {
+        m_entries.clear();
+        m_generation = generation;
+    }
+}
+
+WorldPacket const* ChatPacketCache::Find(ChatPacketKey const& key)
+{
+    EntryMap::iterator itr = m_entries.find(key);
+    if (itr == m_entries.end())
+        return NULL;
+
+    itr->second.lastUse = ++m_clock;
+    return &itr->second.packet;
+}
+
+WorldPacket* ChatPacketCache::Insert(ChatPacketKey const& key)
+{
+    if (m_entries.size() >= MAX_PACKETS && m_entries.find(key) == m_entries.end())
+    {
+        EntryMap::iterator oldest = m_entries.begin();
+        for (EntryMap::iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr)
+            if (itr->second.lastUse < oldest->second.lastUse)
+                oldest = itr;
+
+        m_entries.erase(oldest);
+    }
+
+    Entry& entry = m_entries[key];
+    entry.lastUse = ++m_clock;
+    return &entry.packet;
+}
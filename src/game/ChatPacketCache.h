@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2005-2009 MaNGOS <http://getmangos.com/>
+ *
+ * Copyright (C) 2008-2009 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOOKING4GROUP_CHATPACKETCACHE_H
+#define LOOKING4GROUP_CHATPACKETCACHE_H
+
+#include "Common.h"
+#include "WorldPacket.h"
+
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include <map>
+
+/// Everything a creature text packet is built from
+struct ChatPacketKey
+{
+    ChatPacketKey(int32 text, int32 loc, uint32 lang, uint8 type, bool noPrename, uint64 speakerGuid, uint64 targetGuid)
+        : textId(text), locale(loc), language(lang), msgType(type), withoutPrename(noPrename), speaker(speakerGuid), target(targetGuid) {}
+
+    bool operator<(ChatPacketKey const& other) const;
+
+    int32 textId;
+    int32 locale;
+    uint32 language;
+    uint8 msgType;
+    bool withoutPrename;
+    uint64 speaker;
+    uint64 target;
+};
+
+/// SMSG_MESSAGECHAT packets of recent creature texts, used only from map update thread.
+/// Creatures repeating their texts (guards, criers, scripted events) send the packet
+/// of the last time instead of looking up and formatting strings again.
+/// A packet stays valid until next Update() unless MAX_PACKETS other ones are used after it,
+/// so one text can be sent to all its listeners without copying it.
+class ChatPacketCache
+{
+    public:
+        ChatPacketCache() : m_clock(0), m_generation(0) {}
+
+        /// Drops all packets if strings or names were reloaded, called at start of map update
+        void Update();
+
+        /// NULL if not built recently
+        WorldPacket const* Find(ChatPacketKey const& key);
+
+        /// Packet to build for key, the least recently used one is dropped when full
+        WorldPacket* Insert(ChatPacketKey const& key);
+
+        /// Strings or names were reloaded, all caches drop their packets at next map update. Any thread.
+        static void Invalidate() { ++s_generation; }
+
+    private:
+        enum
+        {
+            MAX_PACKETS = 64
+        };
+
+        struct Entry
+        {
+            WorldPacket packet;
+            uint32 lastUse;
+        };
+
+        typedef std::map<ChatPacketKey, Entry> EntryMap;
+
+        EntryMap m_entries;
+        uint32 m_clock;
+        uint32 m_generation;
+
+        static ACE_Atomic_Op<ACE_Thread_Mutex, uint32> s_generation;
+};
+
+#endif
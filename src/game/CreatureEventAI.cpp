@@ -48,6 +48,11 @@ bool CreatureEventAIHolder::UpdateRepeatTimer(Creature* creature, uint32 repeatM
     return true;
 }
 
+static bool EventTimerLater(CreatureEventAITimer const& lhs, CreatureEventAITimer const& rhs)
+{
+    return int32(lhs.due - rhs.due) > 0;
+}
+
 int CreatureEventAI::Permissible(const Creature *creature)
 {
     if (creature->GetAIName() == "EventAI")
@@ -57,6 +62,12 @@ int CreatureEventAI::Permissible(const Creature *creature)
 
 CreatureEventAI::CreatureEventAI(Creature *c) : CreatureAI(c)
 {
+    EventClock = 0;
+    TimerPhase = 0;
+    SettledGeneration = 1;                                  // holders start unsettled with generation 0
+    EventUpdateTime = EVENT_UPDATE_TIME;
+    EventDiff = 0;
+
     // Need make copy for filter unneeded steps and safe in case table reload
     CreatureEventAI_Event_Map::const_iterator CreatureEvents = sCreatureEAIMgr.GetCreatureEventAIMap().find(int64(me->GetEntry()));
     if (CreatureEvents != sCreatureEAIMgr.GetCreatureEventAIMap().end())
@@ -75,11 +86,11 @@ CreatureEventAI::CreatureEventAI(Creature *c) : CreatureAI(c)
                     (!m_creature->GetMap()->IsHeroic() && (*i).event_flags & EFLAG_NORMAL))
                 {
                     //event flagged for instance mode
-                    CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
+                    AddEventHolder(*i);
                 }
                 continue;
             }
-            CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
+            AddEventHolder(*i);
         }
     }
 
@@ -102,11 +113,11 @@ CreatureEventAI::CreatureEventAI(Creature *c) : CreatureAI(c)
                     (!m_creature->GetMap()->IsHeroic() && (*i).event_flags & EFLAG_NORMAL))
                 {
                     //event flagged for instance mode
-                    CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
+                    AddEventHolder(*i);
                 }
                 continue;
             }
-            CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
+            AddEventHolder(*i);
         }
     }
 
@@ -138,14 +149,194 @@ CreatureEventAI::CreatureEventAI(Creature *c) : CreatureAI(c)
     cevent.action[1].type = ACTION_T_NONE;
     cevent.action[2].type = ACTION_T_NONE;
 
-    CreatureEventAIList.push_back(CreatureEventAIHolder(cevent));
+    AddEventHolder(cevent);
 
     //Handle Spawned Events
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-            if (SpawnedEventConditionsCheck((*i).Event))
-                ProcessEvent(*i);
+        CreatureEventAIIndexList const& events = EventsByType[EVENT_T_SPAWNED];
+        for (CreatureEventAIIndexList::const_iterator i = events.begin(); i != events.end(); ++i)
+            if (SpawnedEventConditionsCheck(CreatureEventAIList[*i].Event))
+                ProcessEvent(CreatureEventAIList[*i]);
+    }
+}
+
+void CreatureEventAI::AddEventHolder(CreatureEventAI_Event const& event)
+{
+    uint32 index = CreatureEventAIList.size();
+    CreatureEventAIList.push_back(CreatureEventAIHolder(event));
+
+    if (event.event_type < EVENT_T_END)
+        EventsByType[event.event_type].push_back(index);
+
+    // other events are triggered by creature callbacks only
+    switch (event.event_type)
+    {
+        case EVENT_T_TIMER_OOC:
+            OOCPolledEvents.push_back(index);
+            break;
+        case EVENT_T_TIMER:
+        case EVENT_T_MANA:
+        case EVENT_T_HP:
+        case EVENT_T_TARGET_HP:
+        case EVENT_T_TARGET_CASTING:
+        case EVENT_T_FRIENDLY_HP:
+        case EVENT_T_RANGE:
+            CombatPolledEvents.push_back(index);
+            break;
+        default:
+            break;
+    }
+}
+
+void CreatureEventAI::ScheduleEventTimer(CreatureEventAIHolder& holder)
+{
+    // drop timer queued before
+    ++holder.TimerGeneration;
+    holder.TimerPaused = false;
+
+    if (!holder.Time)
+        return;
+
+    // timers don't run in phases the event can't trigger in
+    if (holder.Event.event_inverse_phase_mask & (1 << Phase))
+    {
+        holder.TimerPaused = true;
+        return;
+    }
+
+    holder.TimerDue = EventClock + holder.Time;
+
+    CreatureEventAITimer timer;
+    timer.due = holder.TimerDue;
+    timer.index = &holder - &CreatureEventAIList[0];
+    timer.generation = holder.TimerGeneration;
+
+    EventTimers.push_back(timer);
+    std::push_heap(EventTimers.begin(), EventTimers.end(), EventTimerLater);
+}
+
+void CreatureEventAI::UpdateEventTimers(uint32 diff)
+{
+    // phase changed by actions since last update: pause and resume timers at the time it happened
+    if (Phase != TimerPhase)
+        UpdatePhaseTimers();
+
+    EventClock += diff;
+
+    while (!EventTimers.empty() && int32(EventTimers.front().due - EventClock) <= 0)
+    {
+        CreatureEventAITimer timer = EventTimers.front();
+        std::pop_heap(EventTimers.begin(), EventTimers.end(), EventTimerLater);
+        EventTimers.pop_back();
+
+        CreatureEventAIHolder& holder = CreatureEventAIList[timer.index];
+        if (timer.generation == holder.TimerGeneration)
+            holder.Time = 0;
+    }
+}
+
+void CreatureEventAI::UpdatePhaseTimers()
+{
+    for (std::vector<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+    {
+        if (!(*i).Time)
+            continue;
+
+        bool blocked = (*i).Event.event_inverse_phase_mask & (1 << Phase);
+        if (blocked && !(*i).TimerPaused)
+        {
+            int32 remaining = int32((*i).TimerDue - EventClock);
+            if (remaining > 0)
+            {
+                (*i).Time = remaining;
+                (*i).TimerPaused = true;
+                ++(*i).TimerGeneration;
+            }
+        }
+        else if (!blocked && (*i).TimerPaused)
+            ScheduleEventTimer(*i);
+    }
+
+    TimerPhase = Phase;
+    ResetSettledEvents();
+}
+
+void CreatureEventAI::UpdatePolledEvents(CreatureEventAIIndexList const& events)
+{
+    for (CreatureEventAIIndexList::const_iterator itr = events.begin(); itr != events.end(); ++itr)
+    {
+        CreatureEventAIHolder& holder = CreatureEventAIList[*itr];
+        if (holder.Time || !holder.Enabled)
+            continue;
+
+        switch (holder.Event.event_type)
+        {
+            case EVENT_T_TIMER_OOC:
+                break;
+            case EVENT_T_RANGE:
+                if (!me->getVictim() || !m_creature->IsInMap(m_creature->getVictim()) ||
+                    !m_creature->IsInRange(m_creature->getVictim(),(float)holder.Event.range.minDist,(float)holder.Event.range.maxDist))
+                    continue;
+                break;
+            default:
+                // victim may be lost by actions of events processed before
+                if (!me->getVictim())
+                    continue;
+                break;
+        }
+
+        // conditions failed already for the same state
+        uint64 key;
+        bool keyed = GetEventConditionKey(holder, key);
+        if (keyed && holder.SettledGeneration == SettledGeneration && holder.SettledKey == key)
+            continue;
+
+        if (!ProcessEvent(holder) && holder.ConditionFailed && keyed)
+        {
+            holder.SettledKey = key;
+            holder.SettledGeneration = SettledGeneration;
+        }
+    }
+}
+
+// state the event conditions depend on, false if it can't be tracked cheaply (health of other creatures around)
+bool CreatureEventAI::GetEventConditionKey(CreatureEventAIHolder const& holder, uint64& key) const
+{
+    key = uint64(m_creature->isInCombat()) << 8;
+
+    switch (holder.Event.event_type)
+    {
+        case EVENT_T_TIMER:
+        case EVENT_T_TIMER_OOC:
+            return true;
+        case EVENT_T_RANGE:                                 // distance is checked before every try
+        case EVENT_T_TARGET_CASTING:
+        {
+            Unit* victim = m_creature->getVictim();
+            if (victim)
+                key |= (uint64(victim->GetGUIDLow()) << 32) | (uint64(GUID_HIPART(victim->GetGUID()) & 0xFF) << 16) |
+                    (holder.Event.event_type == EVENT_T_TARGET_CASTING && victim->IsNonMeleeSpellCasted(false, false, true) ? 1 : 0);
+            return true;
+        }
+        case EVENT_T_HP:
+            if (m_creature->GetMaxHealth())
+                key |= (m_creature->GetHealth()*100) / m_creature->GetMaxHealth() + 1;
+            return true;
+        case EVENT_T_MANA:
+            if (m_creature->GetMaxPower(POWER_MANA))
+                key |= (m_creature->GetPower(POWER_MANA)*100) / m_creature->GetMaxPower(POWER_MANA) + 1;
+            return true;
+        case EVENT_T_TARGET_HP:
+        {
+            Unit* victim = m_creature->getVictim();
+            if (victim && victim->GetMaxHealth())
+                key |= (uint64(victim->GetGUIDLow()) << 32) | (uint64(GUID_HIPART(victim->GetGUID()) & 0xFF) << 16) |
+                    ((victim->GetHealth()*100) / victim->GetMaxHealth() + 1);
+            return true;
+        }
+        default:
+            return false;
     }
 }
 
@@ -154,10 +345,41 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
     if (!pHolder.Enabled || pHolder.Time)
         return false;
 
+    pHolder.ConditionFailed = true;
+
     //Check the inverse phase mask (event doesn't trigger if current phase bit is set in mask)
     if (pHolder.Event.event_inverse_phase_mask & (1 << Phase))
         return false;
 
+    //Check event conditions based on the event type, also reset events
+    if (!CheckEventConditions(pHolder, pActionInvoker))
+        return false;
+
+    pHolder.ConditionFailed = false;
+
+    //Start repeat timer set by conditions check
+    ScheduleEventTimer(pHolder);
+
+    //Disable non-repeatable events
+    if (!(pHolder.Event.event_flags & EFLAG_REPEATABLE))
+        pHolder.Enabled = false;
+
+    //Store random here so that all random actions match up
+    uint32 rnd = rand();
+
+    //Return if chance for event is not met
+    if (pHolder.Event.event_chance <= rnd % 100)
+        return false;
+
+    //Process actions
+    for (uint32 j = 0; j < MAX_ACTIONS; j++)
+        ProcessAction(pHolder.Event.action[j], rnd, pHolder.Event.event_id, pActionInvoker);
+
+    return true;
+}
+
+bool CreatureEventAI::CheckEventConditions(CreatureEventAIHolder& pHolder, Unit*& pActionInvoker)
+{
     CreatureEventAI_Event const& event = pHolder.Event;
 
     //Check event conditions based on the event type, also reset events
@@ -366,21 +588,6 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             break;
     }
 
-    //Disable non-repeatable events
-    if (!(pHolder.Event.event_flags & EFLAG_REPEATABLE))
-        pHolder.Enabled = false;
-
-    //Store random here so that all random actions match up
-    uint32 rnd = rand();
-
-    //Return if chance for event is not met
-    if (pHolder.Event.event_chance <= rnd % 100)
-        return false;
-
-    //Process actions
-    for (uint32 j = 0; j < MAX_ACTIONS; j++)
-        ProcessAction(pHolder.Event.action[j], rnd, pHolder.Event.event_id, pActionInvoker);
-
     return true;
 }
 
@@ -642,8 +849,8 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
             break;
         case ACTION_T_THREAT_ALL_PCT:
         {
-            std::list<HostilReference*>& threatList = m_creature->getThreatManager().getThreatList();
-            for (std::list<HostilReference*>::iterator i = threatList.begin(); i != threatList.end(); ++i)
+            std::list<HostilReference*> const& threatList = m_creature->getThreatManager().getThreatList();
+            for (std::list<HostilReference*>::const_iterator i = threatList.begin(); i != threatList.end(); ++i)
                 if (Unit* Temp = Unit::GetUnit(*m_creature,(*i)->getUnitGuid()))
                     m_creature->getThreatManager().modifyThreatPercent(Temp, action.threat_all_pct.percent);
             break;
@@ -753,8 +960,8 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
             break;
         case ACTION_T_CAST_EVENT_ALL:
         {
-            std::list<HostilReference*>& threatList = m_creature->getThreatManager().getThreatList();
-            for (std::list<HostilReference*>::iterator i = threatList.begin(); i != threatList.end(); ++i)
+            std::list<HostilReference*> const& threatList = m_creature->getThreatManager().getThreatList();
+            for (std::list<HostilReference*>::const_iterator i = threatList.begin(); i != threatList.end(); ++i)
                 if (Unit* Temp = Unit::GetUnit(*m_creature,(*i)->getUnitGuid()))
                     if (Temp->GetTypeId() == TYPEID_PLAYER)
                         ((Player*)Temp)->CastedCreatureOrGO(action.cast_event_all.creatureId, m_creature->GetGUID(), action.cast_event_all.spellId);
@@ -952,9 +1159,10 @@ void CreatureEventAI::JustRespawned()
         return;
 
     //Handle Spawned Events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        if (SpawnedEventConditionsCheck((*i).Event))
-            ProcessEvent(*i);
+    CreatureEventAIIndexList const& events = EventsByType[EVENT_T_SPAWNED];
+    for (CreatureEventAIIndexList::const_iterator i = events.begin(); i != events.end(); ++i)
+        if (SpawnedEventConditionsCheck(CreatureEventAIList[*i].Event))
+            ProcessEvent(CreatureEventAIList[*i]);
 }
 
 void CreatureEventAI::Reset()
@@ -965,32 +1173,29 @@ void CreatureEventAI::Reset()
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_RESET)
-            ProcessEvent(*i);
-    }
+    ResetSettledEvents();
+
+    CreatureEventAIIndexList const& resetEvents = EventsByType[EVENT_T_RESET];
+    for (CreatureEventAIIndexList::const_iterator i = resetEvents.begin(); i != resetEvents.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i]);
 
-    //Reset all events to enabled
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+    //Reset all out of combat timers
+    CreatureEventAIIndexList const& timerEvents = EventsByType[EVENT_T_TIMER_OOC];
+    for (CreatureEventAIIndexList::const_iterator i = timerEvents.begin(); i != timerEvents.end(); ++i)
     {
-        CreatureEventAI_Event const& event = (*i).Event;
-        switch (event.event_type)
+        CreatureEventAIHolder& holder = CreatureEventAIList[*i];
+        if (holder.UpdateRepeatTimer(m_creature,holder.Event.timer.initialMin,holder.Event.timer.initialMax))
         {
-            //Reset all out of combat timers
-            case EVENT_T_TIMER_OOC:
-            {
-                if ((*i).UpdateRepeatTimer(m_creature,event.timer.initialMin,event.timer.initialMax))
-                    (*i).Enabled = true;
-                break;
-            }
-            //default:
-            //TODO: enable below code line / verify this is correct to enable events previously disabled (ex. aggro yell), instead of enable this in void EnterCombat()
-            //(*i).Enabled = true;
-            //(*i).Time = 0;
-            //break;
+            holder.Enabled = true;
+            ScheduleEventTimer(holder);
         }
     }
+
+    //default:
+    //TODO: enable below code line / verify this is correct to enable events previously disabled (ex. aggro yell), instead of enable this in void EnterCombat()
+    //(*i).Enabled = true;
+    //(*i).Time = 0;
+    //break;
 }
 
 void CreatureEventAI::JustReachedHome()
@@ -999,11 +1204,9 @@ void CreatureEventAI::JustReachedHome()
 
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        {
-            if ((*i).Event.event_type == EVENT_T_REACHED_HOME)
-                ProcessEvent(*i);
-        }
+        CreatureEventAIIndexList const& events = EventsByType[EVENT_T_REACHED_HOME];
+        for (CreatureEventAIIndexList::const_iterator i = events.begin(); i != events.end(); ++i)
+            ProcessEvent(CreatureEventAIList[*i]);
     }
     Reset();
 }
@@ -1016,11 +1219,9 @@ void CreatureEventAI::EnterEvadeMode()
         return;
 
     //Handle Evade events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_EVADE)
-            ProcessEvent(*i);
-    }
+    CreatureEventAIIndexList const& events = EventsByType[EVENT_T_EVADE];
+    for (CreatureEventAIIndexList::const_iterator i = events.begin(); i != events.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i]);
 }
 
 void CreatureEventAI::JustDied(Unit* killer)
@@ -1031,16 +1232,15 @@ void CreatureEventAI::JustDied(Unit* killer)
         return;
 
     //Handle Evade events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_DEATH)
-            ProcessEvent(*i, killer);
-    }
+    CreatureEventAIIndexList const& events = EventsByType[EVENT_T_DEATH];
+    for (CreatureEventAIIndexList::const_iterator i = events.begin(); i != events.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i], killer);
 
     eventAISummonedList.clear();
 
     // reset phase after any death state events
     Phase = 0;
+    ResetSettledEvents();
 }
 
 void CreatureEventAI::KilledUnit(Unit* victim)
@@ -1048,11 +1248,9 @@ void CreatureEventAI::KilledUnit(Unit* victim)
     if (bEmptyList || victim->GetTypeId() != TYPEID_PLAYER)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_KILL)
-            ProcessEvent(*i, victim);
-    }
+    CreatureEventAIIndexList const& events = EventsByType[EVENT_T_KILL];
+    for (CreatureEventAIIndexList::const_iterator i = events.begin(); i != events.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i], victim);
 }
 
 void CreatureEventAI::JustSummoned(Creature* pUnit)
@@ -1090,11 +1288,9 @@ void CreatureEventAI::JustSummoned(Creature* pUnit)
 
     eventAISummonedList.push_back(pUnit->GetGUID());
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_SUMMONED_UNIT)
-            ProcessEvent(*i, pUnit);
-    }
+    CreatureEventAIIndexList const& events = EventsByType[EVENT_T_SUMMONED_UNIT];
+    for (CreatureEventAIIndexList::const_iterator i = events.begin(); i != events.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i], pUnit);
 }
 
 void CreatureEventAI::EnterCombat(Unit *enemy)
@@ -1102,7 +1298,9 @@ void CreatureEventAI::EnterCombat(Unit *enemy)
     //Check for on combat start events
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+        ResetSettledEvents();
+
+        for (std::vector<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
         {
             CreatureEventAI_Event const& event = (*i).Event;
             switch (event.event_type)
@@ -1114,12 +1312,16 @@ void CreatureEventAI::EnterCombat(Unit *enemy)
                     //Reset all in combat timers
                 case EVENT_T_TIMER:
                     if ((*i).UpdateRepeatTimer(m_creature,event.timer.initialMin,event.timer.initialMax))
+                    {
                         (*i).Enabled = true;
+                        ScheduleEventTimer(*i);
+                    }
                     break;
                     //All normal events need to be re-enabled and their time set to 0
                 default:
                     (*i).Enabled = true;
                     (*i).Time = 0;
+                    ScheduleEventTimer(*i);
                     break;
             }
         }
@@ -1149,21 +1351,21 @@ void CreatureEventAI::MoveInLineOfSight(Unit *who)
     //Check for OOC LOS Event
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator itr = CreatureEventAIList.begin(); itr != CreatureEventAIList.end(); ++itr)
+        CreatureEventAIIndexList const& events = EventsByType[EVENT_T_OOC_LOS];
+        for (CreatureEventAIIndexList::const_iterator itr = events.begin(); itr != events.end(); ++itr)
         {
-            if ((*itr).Event.event_type == EVENT_T_OOC_LOS)
-            {
-                //can trigger if closer than fMaxAllowedRange
-                float fMaxAllowedRange = (*itr).Event.ooc_los.maxRange;
+            CreatureEventAIHolder& holder = CreatureEventAIList[*itr];
 
-                //if range is ok and we are actually in LOS
-                if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
-                {
-                    //if friendly event&&who is not hostile OR hostile event&&who is hostile
-                    if (((*itr).Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
-                        ((!(*itr).Event.ooc_los.noHostile) && (me->IsHostileTo(who) || who->IsHostileTo(me))))
-                        ProcessEvent(*itr, who);
-                }
+            //can trigger if closer than fMaxAllowedRange
+            float fMaxAllowedRange = holder.Event.ooc_los.maxRange;
+
+            //if range is ok and we are actually in LOS
+            if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
+            {
+                //if friendly event&&who is not hostile OR hostile event&&who is hostile
+                if ((holder.Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
+                    ((!holder.Event.ooc_los.noHostile) && (me->IsHostileTo(who) || who->IsHostileTo(me))))
+                    ProcessEvent(holder, who);
             }
         }
     }
@@ -1177,12 +1379,16 @@ void CreatureEventAI::SpellHit(Unit* pUnit, const SpellEntry* pSpell)
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        if ((*i).Event.event_type == EVENT_T_SPELLHIT)
-            //If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!(*i).Event.spell_hit.spellId || pSpell->Id == (*i).Event.spell_hit.spellId)
-                if (pSpell->SchoolMask & (*i).Event.spell_hit.schoolMask)
-                    ProcessEvent(*i, pUnit);
+    CreatureEventAIIndexList const& events = EventsByType[EVENT_T_SPELLHIT];
+    for (CreatureEventAIIndexList::const_iterator i = events.begin(); i != events.end(); ++i)
+    {
+        CreatureEventAIHolder& holder = CreatureEventAIList[*i];
+
+        //If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.Event.spell_hit.spellId || pSpell->Id == holder.Event.spell_hit.spellId)
+            if (pSpell->SchoolMask & holder.Event.spell_hit.schoolMask)
+                ProcessEvent(holder, pUnit);
+    }
 }
 
 void CreatureEventAI::UpdateAI(const uint32 diff)
@@ -1197,51 +1403,13 @@ void CreatureEventAI::UpdateAI(const uint32 diff)
         {
             EventDiff += diff;
 
-            //Check for time based events
-            for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-            {
-                //Decrement Timers
-                if ((*i).Time)
-                {
-                    if ((*i).Time > EventDiff)
-                    {
-                        //Do not decrement timers if event cannot trigger in this phase
-                        if (!((*i).Event.event_inverse_phase_mask & (1 << Phase)))
-                            (*i).Time -= EventDiff;
+            //Expire timers, events with time remaining are not checked below
+            UpdateEventTimers(EventDiff);
 
-                        //Skip processing of events that have time remaining
-                        continue;
-                    }
-                    else (*i).Time = 0;
-                }
-
-                //Events that are updated every EVENT_UPDATE_TIME
-                switch ((*i).Event.event_type)
-                {
-                    case EVENT_T_TIMER_OOC:
-                        ProcessEvent(*i);
-                        break;
-                    case EVENT_T_TIMER:
-                    case EVENT_T_MANA:
-                    case EVENT_T_HP:
-                    case EVENT_T_TARGET_HP:
-                    case EVENT_T_TARGET_CASTING:
-                    case EVENT_T_FRIENDLY_HP:
-                        if (me->getVictim())
-                            ProcessEvent(*i);
-                        break;
-                    case EVENT_T_RANGE:
-                        if (me->getVictim())
-                        {
-                            if (m_creature->IsInMap(m_creature->getVictim()))
-                            {
-                                if (m_creature->IsInRange(m_creature->getVictim(),(float)(*i).Event.range.minDist,(float)(*i).Event.range.maxDist))
-                                    ProcessEvent(*i);
-                            }
-                        }
-                        break;
-                }
-            }
+            //Events that are updated every EVENT_UPDATE_TIME
+            UpdatePolledEvents(OOCPolledEvents);
+            if (me->getVictim())
+                UpdatePolledEvents(CombatPolledEvents);
 
             EventDiff = 0;
             EventUpdateTime = EVENT_UPDATE_TIME;
@@ -1451,19 +1619,18 @@ void CreatureEventAI::ReceiveEmote(Player* pPlayer, uint32 text_emote)
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator itr = CreatureEventAIList.begin(); itr != CreatureEventAIList.end(); ++itr)
+    CreatureEventAIIndexList const& events = EventsByType[EVENT_T_RECEIVE_EMOTE];
+    for (CreatureEventAIIndexList::const_iterator itr = events.begin(); itr != events.end(); ++itr)
     {
-        if ((*itr).Event.event_type == EVENT_T_RECEIVE_EMOTE)
-        {
-            if ((*itr).Event.receive_emote.emoteId != text_emote)
-                return;
+        CreatureEventAIHolder& holder = CreatureEventAIList[*itr];
+        if (holder.Event.receive_emote.emoteId != text_emote)
+            return;
 
-            PlayerCondition pcon((*itr).Event.receive_emote.condition,(*itr).Event.receive_emote.conditionValue1,(*itr).Event.receive_emote.conditionValue2);
-            if (pcon.Meets(pPlayer))
-            {
-                sLog.outDebug("CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
-                ProcessEvent(*itr, pPlayer);
-            }
+        PlayerCondition pcon(holder.Event.receive_emote.condition,holder.Event.receive_emote.conditionValue1,holder.Event.receive_emote.conditionValue2);
+        if (pcon.Meets(pPlayer))
+        {
+            sLog.outDebug("CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
+            ProcessEvent(holder, pPlayer);
         }
     }
 }
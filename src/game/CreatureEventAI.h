@@ -593,16 +593,34 @@ typedef UNORDERED_MAP<uint32, CreatureEventAI_Summon> CreatureEventAI_Summon_Map
 
 struct CreatureEventAIHolder
 {
-    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), Enabled(true){}
+    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), Enabled(true),
+        TimerDue(0), TimerGeneration(0), TimerPaused(false), ConditionFailed(false), SettledKey(0), SettledGeneration(0) {}
 
     CreatureEventAI_Event Event;
-    uint32 Time;
+    uint32 Time;                                            // non zero while event waits for its timer
     bool Enabled;
 
+    uint32 TimerDue;                                        // event clock when Time expires
+    uint32 TimerGeneration;                                 // queued timers of older generations are ignored
+    bool TimerPaused;                                       // Time is remaining time, frozen by inverse phase mask
+
+    bool ConditionFailed;                                   // last ProcessEvent failed on phase or event conditions
+    uint64 SettledKey;                                      // condition state of that failure
+    uint32 SettledGeneration;
+
     // helper
     bool UpdateRepeatTimer(Creature* creature, uint32 repeatMin, uint32 repeatMax);
 };
 
+struct CreatureEventAITimer
+{
+    uint32 due;
+    uint32 index;
+    uint32 generation;
+};
+
+typedef std::vector<uint32> CreatureEventAIIndexList;
+
 class LOOKING4GROUP_IMPORT_EXPORT CreatureEventAI : public CreatureAI
 {
 
@@ -629,6 +647,7 @@ class LOOKING4GROUP_IMPORT_EXPORT CreatureEventAI : public CreatureAI
         static int Permissible(const Creature *);
 
         bool ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pActionInvoker = NULL);
+        bool CheckEventConditions(CreatureEventAIHolder& pHolder, Unit*& pActionInvoker);
         void ProcessAction(CreatureEventAI_Action const& action, uint32 rnd, uint32 EventId, Unit* pActionInvoker);
         inline uint32 GetRandActionParam(uint32 rnd, uint32 param1, uint32 param2, uint32 param3);
         inline int32 GetRandActionParam(uint32 rnd, int32 param1, int32 param2, int32 param3);
@@ -643,8 +662,24 @@ class LOOKING4GROUP_IMPORT_EXPORT CreatureEventAI : public CreatureAI
         void FindFriendlyMissingBuff(std::list<Creature*>& _list, float range, uint32 spellid);
         void FindFriendlyCC(std::list<Creature*>& _list, float range);
 
+        // scheduling of time based and polled events
+        void AddEventHolder(CreatureEventAI_Event const& event);
+        void ScheduleEventTimer(CreatureEventAIHolder& holder);
+        void UpdateEventTimers(uint32 diff);
+        void UpdatePhaseTimers();
+        void UpdatePolledEvents(CreatureEventAIIndexList const& events);
+        bool GetEventConditionKey(CreatureEventAIHolder const& holder, uint64& key) const;
+        void ResetSettledEvents() { ++SettledGeneration; }
+
                                                             //Holder for events (stores enabled, time, and eventid)
-        std::list<CreatureEventAIHolder> CreatureEventAIList;
+        std::vector<CreatureEventAIHolder> CreatureEventAIList; // not resized after constructor, holders are referenced by index
+        CreatureEventAIIndexList EventsByType[EVENT_T_END]; // holder indexes per event type
+        CreatureEventAIIndexList OOCPolledEvents;           // checked every EVENT_UPDATE_TIME
+        CreatureEventAIIndexList CombatPolledEvents;        // checked every EVENT_UPDATE_TIME while creature has victim
+        std::vector<CreatureEventAITimer> EventTimers;      // min heap by due time
+        uint32 EventClock;                                  // sum of EventDiff of all event updates
+        uint8 TimerPhase;                                   // phase used for paused timers
+        uint32 SettledGeneration;                           // increased when all conditions must be checked again
         uint32 EventUpdateTime;                             //Time between event updates
         uint32 EventDiff;                                   //Time between the last event call
         bool bEmptyList;
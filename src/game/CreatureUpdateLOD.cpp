@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2005-2009 MaNGOS <http://getmangos.com/>
+ *
+ * Copyright (C) 2008-2009 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "CreatureUpdateLOD.h"
+#include "Creature.h"
+#include "GridDefines.h"
+#include "World.h"
+
+void CreatureUpdateLOD::Reset(float visibleDistance)
+{
+    m_lastStats = m_stats;
+    m_stats = CreatureUpdateStats();
+
+    m_cells.clear();
+    m_cellIndex.clear();
+
+    m_nearDist = float(sWorld.getConfig(CONFIG_CREATURE_UPDATE_NEAR_DISTANCE));
+    m_edgeDist = visibleDistance;
+    if (m_nearDist > m_edgeDist)
+        m_nearDist = m_edgeDist;
+
+    m_rate[CREATURE_UPDATE_NEAR] = 1;
+    m_rate[CREATURE_UPDATE_FAR] = sWorld.getConfig(CONFIG_CREATURE_UPDATE_FAR_RATE);
+    m_rate[CREATURE_UPDATE_EDGE] = sWorld.getConfig(CONFIG_CREATURE_UPDATE_EDGE_RATE);
+}
+
+void CreatureUpdateLOD::AddPlayer(uint32 cellId, float x, float y)
+{
+    UNORDERED_MAP<uint32, uint32>::const_iterator itr = m_cellIndex.find(cellId);
+    if (itr == m_cellIndex.end())
+    {
+        itr = m_cellIndex.insert(std::make_pair(cellId, uint32(m_cells.size()))).first;
+        m_cells.push_back(CellUpdatePlayers(cellId));
+    }
+
+    if (!IsEnabled())
+        return;
+
+    CellUpdatePlayers& cell = m_cells[itr->second];
+
+    // cell x covers [(x - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL, +SIZE_OF_GRID_CELL), see ComputeCellPair
+    float lowX = (float(cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+    float lowY = (float(cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+
+    float dx = x < lowX ? lowX - x : (x > lowX + SIZE_OF_GRID_CELL ? x - lowX - SIZE_OF_GRID_CELL : 0.0f);
+    float dy = y < lowY ? lowY - y : (y > lowY + SIZE_OF_GRID_CELL ? y - lowY - SIZE_OF_GRID_CELL : 0.0f);
+    float dist = sqrt(dx*dx + dy*dy);
+
+    uint32 pos = cell.count;
+    if (pos == CELL_UPDATE_PLAYERS)
+    {
+        if (dist >= cell.dist[pos - 1])
+            return;
+
+        --pos;
+    }
+    else
+        ++cell.count;
+
+    // keep nearest players sorted
+    for (; pos > 0 && cell.dist[pos - 1] > dist; --pos)
+    {
+        cell.dist[pos] = cell.dist[pos - 1];
+        cell.x[pos] = cell.x[pos - 1];
+        cell.y[pos] = cell.y[pos - 1];
+    }
+
+    cell.dist[pos] = dist;
+    cell.x[pos] = x;
+    cell.y[pos] = y;
+}
+
+bool CreatureUpdateLOD::KeepsFullRate(Creature* creature)
+{
+    return creature->isInCombat() || creature->IsInEvadeMode() || creature->isActiveObject() ||
+        creature->isTrigger() || creature->isCharmedOwnedByPlayerOrPlayer();
+}
+
+uint32 CreatureUpdateLOD::GetUpdateInterval(Creature* creature, CellUpdatePlayers const& cell, uint32 interval)
+{
+    CreatureUpdateTier tier = CREATURE_UPDATE_NEAR;
+    if (IsEnabled() && !KeepsFullRate(creature))
+    {
+        float nearest = -1.0f;
+        for (uint32 i = 0; i < cell.count; ++i)
+        {
+            float dx = creature->GetPositionX() - cell.x[i];
+            float dy = creature->GetPositionY() - cell.y[i];
+            float distSq = dx*dx + dy*dy;
+            if (nearest < 0.0f || distSq < nearest)
+                nearest = distSq;
+        }
+
+        if (nearest < 0.0f)
+            tier = CREATURE_UPDATE_NEAR;
+        else if (nearest > m_edgeDist * m_edgeDist)
+            tier = CREATURE_UPDATE_EDGE;
+        else if (nearest > m_nearDist * m_nearDist)
+            tier = CREATURE_UPDATE_FAR;
+    }
+
+    ++m_stats.creatures[tier];
+    return interval * m_rate[tier];
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2005-2009 MaNGOS <http://getmangos.com/>
+ *
+ * Copyright (C) 2008-2009 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOOKING4GROUP_CREATUREUPDATELOD_H
+#define LOOKING4GROUP_CREATUREUPDATELOD_H
+
+#include "Common.h"
+#include "Utilities/UnorderedMap.h"
+
+#include <vector>
+
+class Creature;
+
+enum CreatureUpdateTier
+{
+    CREATURE_UPDATE_NEAR        = 0,                        // every map update
+    CREATURE_UPDATE_FAR         = 1,                        // no player within near distance
+    CREATURE_UPDATE_EDGE        = 2,                        // no player within visibility distance, grey zone only
+    MAX_CREATURE_UPDATE_TIERS
+};
+
+#define CELL_UPDATE_PLAYERS     4                           // nearest players remembered for each visited cell
+
+struct CreatureUpdateStats
+{
+    CreatureUpdateStats() { memset(creatures, 0, sizeof(creatures)); }
+
+    uint32 creatures[MAX_CREATURE_UPDATE_TIERS];            // creatures visited in one map update
+};
+
+/// Cell visited by map update with players closest to it.
+struct CellUpdatePlayers
+{
+    explicit CellUpdatePlayers(uint32 id) : cellId(id), count(0) {}
+
+    uint32 cellId;
+    uint32 count;
+    float dist[CELL_UPDATE_PLAYERS];                        // from player to cell bounds, ascending
+    float x[CELL_UPDATE_PLAYERS];
+    float y[CELL_UPDATE_PLAYERS];
+};
+
+/// Picks update interval of creatures from distance to nearest player, used only from map update thread.
+/// Creatures in combat, evading, active, trigger or owned by players always update at full rate;
+/// slower creatures get accumulated diff, so timers keep their length.
+class CreatureUpdateLOD
+{
+    public:
+        typedef std::vector<CellUpdatePlayers> CellList;
+
+        CreatureUpdateLOD() : m_nearDist(0.0f), m_edgeDist(0.0f) {}
+
+        // start of map update, forgets visited cells
+        void Reset(float visibleDistance);
+
+        bool IsEnabled() const { return m_nearDist > 0.0f; }
+
+        void AddPlayer(uint32 cellId, float x, float y);
+        CellList const& GetCells() const { return m_cells; }
+
+        uint32 GetUpdateInterval(Creature* creature, CellUpdatePlayers const& cell, uint32 interval);
+
+        // counts of last finished map update
+        CreatureUpdateStats const& GetStats() const { return m_lastStats; }
+
+    private:
+        static bool KeepsFullRate(Creature* creature);
+
+        float m_nearDist;
+        float m_edgeDist;
+        uint32 m_rate[MAX_CREATURE_UPDATE_TIERS];
+
+        CellList m_cells;
+        UNORDERED_MAP<uint32, uint32> m_cellIndex;          // cell id -> position in m_cells
+
+        CreatureUpdateStats m_stats;
+        CreatureUpdateStats m_lastStats;
+};
+
+#endif
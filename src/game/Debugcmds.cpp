@@ -39,6 +39,7 @@
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
+#include "ChannelMgr.h"
 
 #define COMMAND_COOLDOWN 2
 
@@ -663,6 +664,118 @@ bool ChatHandler::HandleDebugArenaCommand(const char * /*args*/)
     return true;
 }
 
+// .debug stats player - derived stat recalculations of selected player
+bool ChatHandler::HandleDebugStatsPlayerCommand(const char * /*args*/)
+{
+    Player* player = getSelectedPlayer();
+    if (!player)
+        player = m_session->GetPlayer();
+
+    PlayerStatUpdateCounters const& lastTick = player->GetStatUpdateCountersLastTick();
+    PlayerStatUpdateCounters const& total = player->GetStatUpdateCountersTotal();
+
+    PSendSysMessage("Stat recalculations of %s:", player->GetName());
+    PSendSysMessage("Last update: " UI64FMTD " done, " UI64FMTD " avoided", lastTick.performed, lastTick.avoided);
+    PSendSysMessage("Total:       " UI64FMTD " done, " UI64FMTD " avoided", total.performed, total.avoided);
+    return true;
+}
+
+// .debug stats map - path service, grid loads, script queue and creature update tiers of current map
+bool ChatHandler::HandleDebugStatsMapCommand(const char * /*args*/)
+{
+    Map* map = m_session->GetPlayer()->GetMap();
+    PSendSysMessage("Map %u (instance %u):", map->GetId(), map->GetInstanceId());
+
+    PathService const& service = map->GetPathService();
+    PathServiceCounters const& lastTick = service.GetCountersLastTick();
+    PathServiceCounters const& total = service.GetCountersTotal();
+
+    PSendSysMessage("Paths, last update: %u requests (%u deferred), %u cache hits, %u replans, " UI64FMTD " us batch, " UI64FMTD " us findPath",
+        lastTick.requests, lastTick.deferred, lastTick.cacheHits, lastTick.replans, lastTick.batchTime, lastTick.replanTime);
+    PSendSysMessage("Paths, total: %u requests, %u cache hits, %u replans, " UI64FMTD " us batch, " UI64FMTD " us findPath, %u cached corridors",
+        total.requests, total.cacheHits, total.replans, total.batchTime, total.replanTime, service.GetCachedCorridorCount());
+
+    GridLoadStats const& grids = map->GetGridLoadStats();
+    PSendSysMessage("Grid loads: %u loaded, %u with preloaded terrain, %u preload requests, " UI64FMTD " us total, " UI64FMTD " us average, " UI64FMTD " us max",
+        grids.loads, grids.preloaded, grids.requests, grids.totalTime, grids.loads ? grids.totalTime / grids.loads : 0, grids.maxTime);
+
+    ScriptSchedulerStats const& scripts = map->GetScriptSchedulerStats();
+    PSendSysMessage("Script queue: %u waiting, %u at most, " UI64FMTD " scheduled, " UI64FMTD " executed, " UI64FMTD " cancelled with their source",
+        scripts.queued, scripts.peak, scripts.scheduled, scripts.executed, scripts.cancelled);
+
+    CreatureUpdateStats const& creatures = map->GetCreatureUpdateStats();
+    PSendSysMessage("Creatures visited by last update: %u near, %u far, %u at edge",
+        creatures.creatures[CREATURE_UPDATE_NEAR], creatures.creatures[CREATURE_UPDATE_FAR], creatures.creatures[CREATURE_UPDATE_EDGE]);
+    return true;
+}
+
+// .debug stats channels - chat fan-out of channels of own team
+bool ChatHandler::HandleDebugStatsChannelsCommand(const char * /*args*/)
+{
+    ChannelMgr* cMgr = channelMgr(m_session->GetPlayer()->GetTeam());
+    if (!cMgr)
+        return false;
+
+    ChannelMgr::ChannelMap const& channels = cMgr->GetChannels();
+    for (ChannelMgr::ChannelMap::const_iterator itr = channels.begin(); itr != channels.end(); ++itr)
+    {
+        ChannelFanoutStats const& stats = itr->second->GetFanoutStats();
+        if (!stats.messages)
+            continue;
+
+        PSendSysMessage("%s: %u members, %u messages, " UI64FMTD " packets, " UI64FMTD " us average, " UI64FMTD " us max",
+            itr->first.c_str(), itr->second->GetNumPlayers(), stats.messages, stats.recipients,
+            stats.totalTime / stats.messages, stats.maxTime);
+    }
+    return true;
+}
+
+// .debug stats opcodes [reset] - handler time histograms of opcodes with most total time
+bool ChatHandler::HandleDebugStatsOpcodesCommand(const char * args)
+{
+    if (*args)
+    {
+        if (strncmp(args, "reset", strlen(args)) != 0)
+            return false;
+
+        for (uint16 i = 0; i < NUM_MSG_TYPES; ++i)
+            opcodeTimes[i].Reset();
+
+        SendSysMessage("Opcode handler times cleared.");
+        return true;
+    }
+
+    std::vector<std::pair<uint64, uint16> > opcodes;
+    for (uint16 i = 0; i < NUM_MSG_TYPES; ++i)
+        if (uint64 total = opcodeTimes[i].totalTime.value())
+            opcodes.push_back(std::make_pair(total, i));
+
+    std::sort(opcodes.begin(), opcodes.end(), std::greater<std::pair<uint64, uint16> >());
+    if (opcodes.size() > 10)
+        opcodes.resize(10);
+
+    std::ostringstream limits;
+    limits << "Buckets (us):";
+    for (uint32 i = 0; i < OPCODE_TIME_BUCKETS - 1; ++i)
+        limits << " <" << opcodeTimeBucketLimits[i];
+    limits << " more";
+    SendSysMessage(limits.str().c_str());
+
+    for (std::vector<std::pair<uint64, uint16> >::const_iterator itr = opcodes.begin(); itr != opcodes.end(); ++itr)
+    {
+        OpcodeTimeStats const& stats = opcodeTimes[itr->second];
+
+        std::ostringstream str;
+        str << LookupOpcodeName(itr->second) << ": total " << itr->first << " us, max " << stats.maxTime.value()
+            << " us, coalesced " << stats.coalesced.value() << ", buckets";
+        for (uint32 i = 0; i < OPCODE_TIME_BUCKETS; ++i)
+            str << " " << stats.buckets[i].value();
+
+        SendSysMessage(str.str().c_str());
+    }
+    return true;
+}
+
 bool ChatHandler::HandleDebugBattleGroundCommand(const char * /*args*/)
 {
     sBattleGroundMgr.ToggleTesting();
@@ -694,8 +807,8 @@ bool ChatHandler::HandleDebugThreatList(const char * /*args*/)
         max_count = 3;
     }
 
-    std::list<HostilReference*>& tlist = target->getThreatManager().getThreatList();
-    std::list<HostilReference*>::iterator itr;
+    std::list<HostilReference*> const& tlist = target->getThreatManager().getThreatList();
+    std::list<HostilReference*>::const_iterator itr;
     uint32 cnt = 0;
 
     PSendSysMessage("Threat list of %s (guid %u)",target->GetName(), target->GetGUIDLow());
@@ -637,6 +637,9 @@ TerrainInfo::~TerrainInfo()
          for (int i = 0; i < MAX_NUMBER_OF_GRIDS; ++i)
              delete m_GridMaps[i][k];
 
+     for (PreloadedGridMaps::iterator itr = m_PreloadedGridMaps.begin(); itr != m_PreloadedGridMaps.end(); ++itr)
+         delete itr->second.map;
+
      VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId);
      MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId);
 }
@@ -657,6 +660,69 @@ GridMap * TerrainInfo::Load(const uint32 x, const uint32 y)
      return pMap;
 }
 
+//read whole file, so following loads find it in OS file cache
+static void PreloadFile(std::string const& fileName)
+{
+     FILE* file = fopen(fileName.c_str(), "rb");
+     if (!file)
+         return;
+
+     char buffer[64*1024];
+     while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer))
+         ;
+
+     fclose(file);
+}
+
+void TerrainInfo::Preload(const uint32 x, const uint32 y)
+{
+     ASSERT(x < MAX_NUMBER_OF_GRIDS);
+     ASSERT(y < MAX_NUMBER_OF_GRIDS);
+
+     uint32 gridId = x * MAX_NUMBER_OF_GRIDS + y;
+     {
+         LOCK_GUARD lock(m_mutex);
+         if (m_GridMaps[x][y] || m_PreloadedGridMaps.find(gridId) != m_PreloadedGridMaps.end())
+             return;
+     }
+
+     //GridMap is private until published, so it can be read without lock
+     char tmp[256];
+     snprintf(tmp, sizeof(tmp), (sWorld.GetDataPath()+"maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
+
+     GridMap* map = new GridMap();
+     if (!map->loadData(tmp))
+     {
+         delete map;
+         return;
+     }
+
+     //vmap and mmap tiles are inserted by map thread, here only their files are read
+     PreloadFile(sWorld.GetDataPath() + "vmaps/" + VMAP::VMapFactory::createOrGetVMapManager()->getDirFileName(m_mapId, x, y));
+
+     snprintf(tmp, sizeof(tmp), (sWorld.GetDataPath()+"mmaps/%03u%02u%02u.mmtile").c_str(), m_mapId, x, y);
+     PreloadFile(tmp);
+
+     LOCK_GUARD lock(m_mutex);
+     if (m_GridMaps[x][y] || m_PreloadedGridMaps.find(gridId) != m_PreloadedGridMaps.end())
+     {
+         //map thread was faster
+         map->unloadData();
+         delete map;
+         return;
+     }
+
+     PreloadedGridMap& preloaded = m_PreloadedGridMaps[gridId];
+     preloaded.map = map;
+     preloaded.expiring = false;
+}
+
+bool TerrainInfo::IsPreloaded(const uint32 x, const uint32 y)
+{
+     LOCK_GUARD lock(m_mutex);
+     return m_PreloadedGridMaps.find(x * MAX_NUMBER_OF_GRIDS + y) != m_PreloadedGridMaps.end();
+}
+
 //schedule lazy GridMap object cleanup
 void TerrainInfo::Unload(const uint32 x, const uint32 y)
 {
@@ -703,6 +769,25 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
          }
      }
 
+     //drop preloaded grids nobody entered
+     {
+         LOCK_GUARD lock(m_mutex);
+         for (PreloadedGridMaps::iterator itr = m_PreloadedGridMaps.begin(); itr != m_PreloadedGridMaps.end();)
+         {
+             if (itr->second.expiring)
+             {
+                 itr->second.map->unloadData();
+                 delete itr->second.map;
+                 m_PreloadedGridMaps.erase(itr++);
+             }
+             else
+             {
+                 itr->second.expiring = true;
+                 ++itr;
+             }
+         }
+     }
+
      i_timer.Reset();
 }
 
@@ -1017,22 +1102,33 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
         if(!m_GridMaps[x][y])
         {
-            GridMap * map = new GridMap();
+            GridMap * map = NULL;
 
-            // map file name
-            char *tmp=NULL;
-            int len = sWorld.GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
-            tmp = new char[len];
-            snprintf(tmp, len, (char *)(sWorld.GetDataPath()+"maps/%03u%02u%02u.map").c_str(),m_mapId, x, y);
-            sLog.outDetail("Loading map %s",tmp);
-
-            if(!map->loadData(tmp))
+            PreloadedGridMaps::iterator preloaded = m_PreloadedGridMaps.find(x * MAX_NUMBER_OF_GRIDS + y);
+            if (preloaded != m_PreloadedGridMaps.end())
             {
-                sLog.outLog(LOG_DEFAULT, "ERROR: Error load map file: \n %s\n", tmp);
-                //ASSERT(false);
+                map = preloaded->second.map;
+                m_PreloadedGridMaps.erase(preloaded);
+            }
+            else
+            {
+                map = new GridMap();
+
+                // map file name
+                char *tmp=NULL;
+                int len = sWorld.GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
+                tmp = new char[len];
+                snprintf(tmp, len, (char *)(sWorld.GetDataPath()+"maps/%03u%02u%02u.map").c_str(),m_mapId, x, y);
+                sLog.outDetail("Loading map %s",tmp);
+
+                if(!map->loadData(tmp))
+                {
+                    sLog.outLog(LOG_DEFAULT, "ERROR: Error load map file: \n %s\n", tmp);
+                    //ASSERT(false);
+                }
+
+                delete [] tmp;
             }
-
-            delete [] tmp;
 
             //load VMAPs for current map/grid...
             const MapEntry * i_mapEntry = sMapStore.LookupEntry(m_mapId);
@@ -1279,6 +1375,46 @@ void TerrainManager::UnloadTerrain(const uint32 mapId)
     }
 }
 
+class TerrainPreloadRequest : public ACE_Method_Request
+{
+    public:
+        TerrainPreloadRequest(TerrainInfo* terrain, uint32 x, uint32 y) : m_terrain(terrain), m_x(x), m_y(y)
+        {
+            m_terrain->AddRef();
+        }
+
+        virtual int call(void)
+        {
+            m_terrain->Preload(m_x, m_y);
+
+            if (m_terrain->Release())
+                sTerrainMgr.UnloadTerrain(m_terrain->GetMapId());
+            return 0;
+        }
+
+    private:
+        TerrainInfo* m_terrain;
+        uint32 m_x;
+        uint32 m_y;
+};
+
+void TerrainManager::ActivatePreloader()
+{
+    if (m_preloader.activated())
+        return;
+
+    if (m_preloader.activate(1) == -1)
+        sLog.outLog(LOG_DEFAULT, "ERROR: Can't start grid preload thread, grids will be loaded only on demand");
+}
+
+void TerrainManager::SchedulePreload(TerrainInfo* terrain, const uint32 x, const uint32 y)
+{
+    if (!m_preloader.activated())
+        return;
+
+    m_preloader.execute(new TerrainPreloadRequest(terrain, x, y));
+}
+
 void TerrainManager::Update(const uint32 diff)
 {
     //global garbage collection for GridMap objects and VMaps
@@ -1288,6 +1424,9 @@ void TerrainManager::Update(const uint32 diff)
 
 void TerrainManager::UnloadAll()
 {
+    //queued preloads are dropped, running one still uses its terrain
+    m_preloader.deactivate();
+
     for (TerrainDataMap::iterator it = i_TerrainMap.begin(); it != i_TerrainMap.end(); ++it)
         delete it->second;
 
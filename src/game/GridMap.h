@@ -26,6 +26,7 @@
 #include "GridDefines.h"
 #include "Object.h"
 #include "SharedDefines.h"
+#include "DelayExecutor.h"
 
 #include <bitset>
 #include <list>
@@ -271,12 +272,17 @@ class LOOKING4GROUP_IMPORT_EXPORT TerrainInfo : public Referencable<AtomicLong>
         bool IsPathfindingForceEnabled(const Unit* unit) const;
         bool IsPathfindingForceDisabled(const Unit* unit) const;
 
+        //read grid terrain ahead of Load(), called from preload thread only
+        void Preload(const uint32 x, const uint32 y);
+
     protected:
         friend class Map;
         //load/unload terrain data
         GridMap * Load(const uint32 x, const uint32 y);
         void Unload(const uint32 x, const uint32 y);
 
+        bool IsPreloaded(const uint32 x, const uint32 y);
+
     private:
         TerrainInfo(const TerrainInfo&);
         TerrainInfo& operator=(const TerrainInfo&);
@@ -294,6 +300,16 @@ class LOOKING4GROUP_IMPORT_EXPORT TerrainInfo : public Referencable<AtomicLong>
         GridMap *m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
+        //GridMap objects read by preload thread, taken over by LoadMapAndVMap()
+        struct PreloadedGridMap
+        {
+            GridMap* map;
+            bool expiring;                                  //survived one clean up, dropped on next one
+        };
+
+        typedef UNORDERED_MAP<uint32, PreloadedGridMap> PreloadedGridMaps;
+        PreloadedGridMaps m_PreloadedGridMaps;              //guarded by m_mutex
+
         //global garbage collection timer
         ShortIntervalTimer i_timer;
 
@@ -318,6 +334,10 @@ class TerrainManager
         TerrainInfo* LoadTerrain(const uint32 mapId);
         void UnloadTerrain(const uint32 mapId);
 
+        //background reading of grid terrain files, see Map::UpdateGridPreload()
+        void ActivatePreloader();
+        void SchedulePreload(TerrainInfo* terrain, const uint32 x, const uint32 y);
+
         void Update(const uint32 diff);
         void UnloadAll();
 
@@ -352,6 +372,8 @@ class TerrainManager
         ACE_Thread_Mutex Lock;
         TerrainDataMap i_TerrainMap;
         TerrainsSpecificsMap i_TerrainSpecifics;
+
+        DelayExecutor m_preloader;
 };
 
 #define sTerrainMgr (*ACE_Singleton<TerrainManager, ACE_Thread_Mutex>::instance())
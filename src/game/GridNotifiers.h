@@ -34,6 +34,7 @@
 #include "Unit.h"
 #include "CreatureAI.h"
 #include "SpellAuras.h"
+#include "CreatureUpdateLOD.h"
 
 class Player;
 //class Map;
@@ -118,7 +119,9 @@ namespace Looking4group
     struct LOOKING4GROUP_EXPORT ObjectUpdater
     {
         uint32 i_timeDiff;
-        explicit ObjectUpdater(const uint32 &diff) : i_timeDiff(diff) {}
+        CreatureUpdateLOD* i_lod;                           // NULL updates creatures at full rate
+        CellUpdatePlayers const* i_cell;
+        explicit ObjectUpdater(const uint32 &diff) : i_timeDiff(diff), i_lod(NULL), i_cell(NULL) {}
 
         void Visit(PlayerMapType&) {}
         void Visit(CorpseMapType&) {}
@@ -636,6 +639,20 @@ namespace Looking4group
             std::vector<WorldPacket*> i_data_cache;         // 0 = default, i => i-1 locale index
     };
 
+    // Send to player the packet Builder keeps for his locale, without copying it
+    template<class Builder>
+    class CachedPacketDo
+    {
+        public:
+            explicit CachedPacketDo(Builder& builder) : i_builder(builder) {}
+
+            void operator()( Player* p );
+
+        private:
+            Builder& i_builder;
+            std::vector<WorldPacket const*> i_data_cache;   // 0 = default, i => i-1 locale index
+    };
+
     struct AnyDeadUnitCheck
     {
         bool operator()(Unit* u) { return !u->isAlive(); }
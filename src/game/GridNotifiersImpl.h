@@ -125,13 +125,19 @@ struct UpdateListSorter : public std::binary_function<Creature*, Creature*, bool
 inline void ObjectUpdater::Visit(CreatureMapType &m)
 {
     UpdateList updateList;
+    uint32 minUpdateTime = sWorld.getConfig(CONFIG_INTERVAL_MAPUPDATE);
     for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
-        if (iter->getSource()->isSpiritGuide())
+        Creature* creature = iter->getSource();
+        if (creature->isSpiritGuide())
             continue;
 
-        if (WorldObject::UpdateHelper::ProcessUpdate(iter->getSource()))
-            updateList.push_back(iter->getSource());
+        uint32 updateTime = minUpdateTime;
+        if (i_lod && creature->IsInWorld())
+            updateTime = i_lod->GetUpdateInterval(creature, *i_cell, minUpdateTime);
+
+        if (WorldObject::UpdateHelper::ProcessUpdate(creature, updateTime))
+            updateList.push_back(creature);
     }
 
     uint32 maxListSize = sWorld.getConfig(CONFIG_MAPUPDATE_MAXVISITORS);
@@ -281,6 +287,21 @@ void LocalizedPacketDo<Builder>::operator()( Player* p )
 
     p->SendPacketToSelf(data);
 }
+
+template<class Builder>
+void CachedPacketDo<Builder>::operator()( Player* p )
+{
+    uint32 loc_idx = p->GetSession()->GetSessionDbLocaleIndex();
+    uint32 cache_idx = loc_idx+1;
+
+    if (i_data_cache.size() < cache_idx+1)
+        i_data_cache.resize(cache_idx+1);
+
+    if (!i_data_cache[cache_idx])
+        i_data_cache[cache_idx] = i_builder(loc_idx);
+
+    p->GetSession()->SendPacket(i_data_cache[cache_idx]);
+}
 }
 
 #endif
@@ -33,6 +33,9 @@
 #include "InstanceSaveMgr.h"
 #include "Util.h"
 
+Group::GroupSet Group::s_statsQueue;
+ACE_Thread_Mutex Group::s_statsQueueLock;
+
 Group::Group()
 {
     m_leaderGuid        = 0;
@@ -63,6 +66,11 @@ Group::~Group()
             sLog.outLog(LOG_DEFAULT, "ERROR: Group::~Group: battleground group is not linked to the correct battleground.");
     }
 
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, s_statsQueueLock);
+        s_statsQueue.erase(this);
+    }
+
     Rolls::iterator itr;
     while (!RollId.empty())
     {
@@ -1139,11 +1147,39 @@ void Group::UpdatePlayerOutOfRange(Player* pPlayer)
     for (GroupReference *itr = GetFirstMember(); itr != NULL; itr = itr->next())
     {
         player = itr->getSource();
-        if (player && player != pPlayer && !player->HaveAtClient(pPlayer))
+        // members on other maps can't see him, no need to look him up
+        if (player && player != pPlayer && (!player->IsInMap(pPlayer) || !player->HaveAtClient(pPlayer)))
             player->SendPacketToSelf(&data);
     }
 }
 
+void Group::QueueMemberStatsUpdate()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, s_statsQueueLock);
+    s_statsQueue.insert(this);
+}
+
+void Group::SendQueuedMemberStats()
+{
+    GroupSet groups;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, s_statsQueueLock);
+        groups.swap(s_statsQueue);
+    }
+
+    // one packet per changed member with all changes since the last tick, whatever the map updates in between
+    for (GroupSet::const_iterator group = groups.begin(); group != groups.end(); ++group)
+    {
+        for (GroupReference *itr = (*group)->GetFirstMember(); itr != NULL; itr = itr->next())
+        {
+            Player* member = itr->getSource();
+            // battleground raid members are in their original group too, send with the one they play in
+            if (member && member->GetGroup() == *group)
+                member->SendUpdateToOutOfRangeGroupMembers();
+        }
+    }
+}
+
 void Group::BroadcastPacket(WorldPacket *packet, bool ignorePlayersInBGRaid, int group, uint64 ignore)
 {
     for (GroupReference *itr = GetFirstMember(); itr != NULL; itr = itr->next())
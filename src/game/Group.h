@@ -27,8 +27,11 @@
 #include "BattleGround.h"
 
 #include <map>
+#include <set>
 #include <vector>
 
+#include <ace/Thread_Mutex.h>
+
 #define MAXGROUPSIZE 5
 #define MAXRAIDSIZE 40
 #define MAX_RAID_SUBGROUPS (MAXRAIDSIZE / MAXGROUPSIZE)
@@ -307,6 +310,10 @@ class LOOKING4GROUP_IMPORT_EXPORT Group
         void SendUpdate();
         void Update(uint32 diff);
         void UpdatePlayerOutOfRange(Player* pPlayer);
+
+        // out of range stats of members are gathered over a world tick and sent at once
+        void QueueMemberStatsUpdate();                      // any map thread
+        static void SendQueuedMemberStats();                // world thread, maps not updating
                                                             // ignore: GUID of player that will be ignored
         void BroadcastPacket(WorldPacket *packet, bool ignorePlayersInBGRaid, int group=-1, uint64 ignore=0);
         void BroadcastReadyCheck(WorldPacket *packet);
@@ -429,6 +436,11 @@ class LOOKING4GROUP_IMPORT_EXPORT Group
         BoundInstancesMap   m_boundInstances[TOTAL_DIFFICULTIES];
         uint8*              m_subGroupsCounts;
         time_t              m_leaderLogoutTime;
+
+        typedef std::set<Group*> GroupSet;
+
+        static GroupSet         s_statsQueue;               // groups with members whose stats changed
+        static ACE_Thread_Mutex s_statsQueueLock;
 };
 #endif
 
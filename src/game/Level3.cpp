@@ -5193,9 +5193,14 @@ bool ChatHandler::HandleBanHelper(BanMode mode, const char* args)
                     bannedPlayer->RemoveAura(9454, 0);
             break;
         case BAN_IP:
-            if (!IsIPAddress(nameIPOrMail.c_str()))
+        {
+            // single address or network in CIDR notation, realmd matches both
+            uint32 net;
+            uint8 prefixLen;
+            if (!IsIPAddress(nameIPOrMail.c_str()) && !ParseIPNetwork(nameIPOrMail, net, prefixLen))
                 return false;
             break;
+        }
     }
 
     switch(sWorld.BanAccount(mode, nameIPOrMail, duration, reason,m_session ? m_session->GetPlayerName() : ""))
@@ -5284,9 +5289,14 @@ bool ChatHandler::HandleUnBanHelper(BanMode mode, const char* args)
             }
             break;
         case BAN_IP:
-            if (!IsIPAddress(nameIPOrMail.c_str()))
+        {
+            // single address or network in CIDR notation, realmd matches both
+            uint32 net;
+            uint8 prefixLen;
+            if (!IsIPAddress(nameIPOrMail.c_str()) && !ParseIPNetwork(nameIPOrMail, net, prefixLen))
                 return false;
             break;
+        }
     }
 
     if (sWorld.RemoveBanAccount(mode,nameIPOrMail))
@@ -5404,20 +5414,45 @@ bool ChatHandler::HandleBanInfoIPCommand(const char* args)
     if (!cIP)
         return false;
 
-    if (!IsIPAddress(cIP))
-        return false;
-
     std::string IP = cIP;
 
+    uint32 net;
+    uint8 prefixLen;
+    bool parsed = ParseIPNetwork(IP, net, prefixLen);
+    if (!parsed && !IsIPAddress(cIP))
+        return false;
+
+    // the entry itself first, then networks containing it
     AccountsDatabase.escape_string(IP);
-    QueryResultAutoPtr result = AccountsDatabase.PQuery("SELECT ip, FROM_UNIXTIME(ban_date), FROM_UNIXTIME(unban_date), unban_date-UNIX_TIMESTAMP(), ban_reason, banned_by, unban_date-ban_date FROM ip_banned WHERE ip = '%s'", IP.c_str());
-    if (!result)
+    QueryResultAutoPtr result = AccountsDatabase.PQuery("SELECT ip, FROM_UNIXTIME(ban_date), FROM_UNIXTIME(unban_date), unban_date-UNIX_TIMESTAMP(), ban_reason, banned_by, unban_date-ban_date FROM ip_banned "
+        "WHERE ip = '%s' OR ip LIKE '%%/%%' ORDER BY ip = '%s' DESC", IP.c_str(), IP.c_str());
+
+    Field *fields = NULL;
+    if (result)
+    {
+        do
+        {
+            fields = result->Fetch();
+            if (IP == fields[0].GetCppString())
+                break;
+
+            uint32 banNet;
+            uint8 banPrefixLen;
+            if (parsed && ParseIPNetwork(fields[0].GetCppString(), banNet, banPrefixLen) && banPrefixLen <= prefixLen &&
+                !((net ^ banNet) & IPNetworkMask(banPrefixLen)))
+                break;
+
+            fields = NULL;
+        }
+        while (result->NextRow());
+    }
+
+    if (!fields)
     {
         PSendSysMessage(LANG_BANINFO_NOIP);
         return true;
     }
 
-    Field *fields = result->Fetch();
     bool permanent = !fields[6].GetUInt64();
     PSendSysMessage(LANG_BANINFO_IPENTRY,
         fields[0].GetString(), fields[1].GetString(), permanent ? GetTrinityString(LANG_BANINFO_NEVER):fields[2].GetString(),
@@ -27,6 +27,8 @@
 #include "SharedDefines.h"
 #include "Group.h"
 
+#include <ace/TSS_T.h>
+
 static Rates const qualityToRate[MAX_ITEM_QUALITY] = {
     RATE_DROP_ITEM_POOR,                                    // ITEM_QUALITY_POOR
     RATE_DROP_ITEM_NORMAL,                                  // ITEM_QUALITY_NORMAL
@@ -57,6 +59,7 @@ class LootTemplate::LootGroup                               // A set of loot def
         bool HasQuestDropForPlayer(Player const * player) const;
                                                             // The same for active quests of the player
         void Process(Loot& loot) const;                     // Rolls an item from the group (if any) and adds the item to the loot
+        void Compile();                                     // Builds alias table for explicitly chanced entries
         float RawTotalChance() const;                       // Overall chance for the group (without equal chanced items)
         float TotalChance() const;                          // Overall chance for the group
 
@@ -67,9 +70,26 @@ class LootTemplate::LootGroup                               // A set of loot def
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
 
-        LootStoreItem const * Roll(std::set<uint32> &except) const;                 // Rolls an item from the group, returns NULL if all miss their chances
+        // alias table (Vose) over ExplicitlyChanced and one more slot for empty roll, one random number per roll
+        std::vector<float>  AliasChance;
+        std::vector<uint32> AliasIndex;
+        bool HasUniqueItems;                                // some entry may be excluded by already dropped unique item
+
+        LootStoreItem const * Roll(LootUniqueItems const& except) const;            // Rolls an item from the group, returns NULL if all miss their chances
+        LootStoreItem const * RollLinear(LootUniqueItems const& except) const;
+    public:
+        LootGroup() : HasUniqueItems(false) {}
 };
 
+// items with quality >= RARE are unique in loot, except for epic junk (-> tier tokens)
+static bool IsUniqueInLoot(ItemPrototype const* proto)
+{
+    return proto->Quality >= ITEM_QUALITY_RARE && (proto->Quality != ITEM_QUALITY_EPIC || proto->Class != ITEM_CLASS_JUNK);
+}
+
+// unique items of the loot being filled, kept per thread so filling a loot doesn't allocate
+static ACE_TSS<LootUniqueItems> threadUniqueItems;
+
 //Remove all data and free all memory
 void LootStore::Clear()
 {
@@ -156,6 +176,7 @@ void LootStore::LoadLootTable()
         } while (result->NextRow());
 
         Verify();                                           // Checks validity of the loot store
+        Compile();
 
         sLog.outString();
         sLog.outString(">> Loaded %u loot definitions (%d templates)", count, m_LootTemplates.size());
@@ -197,6 +218,12 @@ LootTemplate const* LootStore::GetLootfor (uint32 loot_id) const
     return tab->second;
 }
 
+void LootStore::Compile()
+{
+    for (LootTemplateMap::const_iterator tab = m_LootTemplates.begin(); tab != m_LootTemplates.end(); ++tab)
+        tab->second->Compile();
+}
+
 void LootStore::LoadAndCollectLootIds(LootIdSet& ids_set)
 {
     LoadLootTable();
@@ -374,10 +401,8 @@ void Loot::AddItem(LootStoreItem const & item)
         if(proto->Flags & ITEM_FLAGS_PARTY_LOOT || item.conditionId)
             everyone_can_open = true;
 
-        // items with quality >= RARE are unique in loot, except for epic junk (-> tier tokens)
-        if (proto->Quality >= ITEM_QUALITY_RARE &&
-            (proto->Quality != ITEM_QUALITY_EPIC || proto->Class != ITEM_CLASS_JUNK))
-            unique_items.insert(item.itemid);
+        if (IsUniqueInLoot(proto) && !HasUniqueItem(item.itemid))
+            unique_items.push_back(item.itemid);
 
         // non-conditional one-player only items are counted here,
         // free for all items are counted in FillFFALoot(),
@@ -679,7 +704,18 @@ void Loot::FillLoot(uint32 loot_id, LootStore const& store, Player* loot_owner,
 
     items.reserve(MAX_NR_LOOT_ITEMS);
     quest_items.reserve(MAX_NR_QUEST_ITEMS);
+
+    // dropped unique items are only looked at while rolling, roll with the buffer of the thread
+    LootUniqueItems& uniqueItems = *threadUniqueItems;
+    uniqueItems.clear();
+    for (std::vector<LootItem>::const_iterator i = items.begin(); i != items.end(); ++i)
+        if (ItemPrototype const* proto = ObjectMgr::GetItemPrototype(i->itemid))
+            if (IsUniqueInLoot(proto))
+                uniqueItems.push_back(i->itemid);
+
+    unique_items.swap(uniqueItems);
     tab->Process(*this, store);                             // Processing is done there, callback via Loot::AddItem()
+    unique_items.swap(uniqueItems);
 
     if (loot_owner) // loot_owner not provided for creatures with no loot recipient on death
     {
@@ -1125,7 +1161,32 @@ void LootTemplate::LootGroup::AddEntry(LootStoreItem& item)
 }
 
 // Rolls an item from the group, returns NULL if all miss their chances
-LootStoreItem const * LootTemplate::LootGroup::Roll(std::set<uint32> &except) const
+LootStoreItem const * LootTemplate::LootGroup::Roll(LootUniqueItems const& except) const
+{
+    // dropped unique items change chances of the rest, roll them the slow way
+    if (HasUniqueItems && !except.empty())
+        return RollLinear(except);
+
+    if (!AliasChance.empty())                               // First explicitly chanced entries are checked
+    {
+        double roll = rand_norm() * AliasChance.size();
+        uint32 slot = std::min(uint32(roll), uint32(AliasChance.size() - 1));
+
+        if (roll - slot >= AliasChance[slot])
+            slot = AliasIndex[slot];
+
+        if (slot < ExplicitlyChanced.size())
+            return &ExplicitlyChanced[slot];
+    }
+
+    if (!EqualChanced.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
+        return &EqualChanced[irand(0, EqualChanced.size()-1)];
+
+    return NULL;                                            // Empty drop from the group
+}
+
+// Rolls an item from the group walking all chances, skips items from except
+LootStoreItem const * LootTemplate::LootGroup::RollLinear(LootUniqueItems const& except) const
 {
     if (!ExplicitlyChanced.empty())                         // First explicitly chanced entries are checked
     {
@@ -1136,7 +1197,7 @@ LootStoreItem const * LootTemplate::LootGroup::Roll(std::set<uint32> &except) co
         int counter = 0;
         for (LootStoreItemList::const_iterator i = ExplicitlyChanced.begin(); i != ExplicitlyChanced.end(); ++i)
         {
-            if (except.find(i->itemid) != except.end())
+            if (std::find(except.begin(), except.end(), i->itemid) != except.end())
                 notAllowedChance += i->chance;
             else
                 allowed.push_back(counter);
@@ -1166,7 +1227,7 @@ LootStoreItem const * LootTemplate::LootGroup::Roll(std::set<uint32> &except) co
         int counter = 0;
         for (LootStoreItemList::const_iterator i = EqualChanced.begin(); i != EqualChanced.end(); ++i)
         {
-            if (except.find(i->itemid) == except.end())
+            if (std::find(except.begin(), except.end(), i->itemid) == except.end())
                 allowed.push_back(counter);
             counter++;
         }
@@ -1210,6 +1271,68 @@ void LootTemplate::LootGroup::Process(Loot& loot) const
         loot.AddItem(*item);
 }
 
+// Builds alias table giving every entry the same chance it has in RollLinear()
+void LootTemplate::LootGroup::Compile()
+{
+    AliasChance.clear();
+    AliasIndex.clear();
+    HasUniqueItems = false;
+
+    for (LootStoreItemList::const_iterator i = ExplicitlyChanced.begin(); i != ExplicitlyChanced.end(); ++i)
+        if (ItemPrototype const* proto = ObjectMgr::GetItemPrototype(i->itemid))
+            HasUniqueItems |= IsUniqueInLoot(proto);
+
+    for (LootStoreItemList::const_iterator i = EqualChanced.begin(); i != EqualChanced.end(); ++i)
+        if (ItemPrototype const* proto = ObjectMgr::GetItemPrototype(i->itemid))
+            HasUniqueItems |= IsUniqueInLoot(proto);
+
+    if (ExplicitlyChanced.empty())
+        return;
+
+    // entries behind 100% total chance are never reached by linear roll, last slot is empty roll
+    uint32 size = ExplicitlyChanced.size() + 1;
+    std::vector<double> weight(size);
+    double left = 100.0;
+    for (uint32 i = 0; i < ExplicitlyChanced.size(); ++i)
+    {
+        double chance = std::min(double(ExplicitlyChanced[i].chance), left);
+        weight[i] = chance * size / 100.0;
+        left -= chance;
+    }
+    weight[size-1] = left * size / 100.0;
+
+    AliasChance.resize(size, 1.0f);
+    AliasIndex.resize(size);
+
+    std::vector<uint32> underfull, overfull;
+    for (uint32 i = 0; i < size; ++i)
+    {
+        AliasIndex[i] = i;
+        if (weight[i] < 1.0)
+            underfull.push_back(i);
+        else
+            overfull.push_back(i);
+    }
+
+    while (!underfull.empty() && !overfull.empty())
+    {
+        uint32 less = underfull.back();
+        uint32 more = overfull.back();
+        underfull.pop_back();
+
+        AliasChance[less] = weight[less];
+        AliasIndex[less] = more;
+
+        weight[more] -= 1.0 - weight[less];
+        if (weight[more] < 1.0)
+        {
+            overfull.pop_back();
+            underfull.push_back(more);
+        }
+    }
+    // slots left in any list are full up to rounding errors and keep own entry
+}
+
 // Overall chance for the group without equal chanced items
 float LootTemplate::LootGroup::RawTotalChance() const
 {
@@ -1309,7 +1432,7 @@ void LootTemplate::Process(Loot& loot, LootStore const& store, uint8 groupId) co
 
         if (i->mincountOrRef < 0)                           // References processing
         {
-            LootTemplate const* Referenced = LootTemplates_Reference.GetLootfor (-i->mincountOrRef);
+            LootTemplate const* Referenced = EntryReferences[i - Entries.begin()];
 
             if (!Referenced)
                 continue;                                   // Error message already printed at loading stage
@@ -1319,7 +1442,7 @@ void LootTemplate::Process(Loot& loot, LootStore const& store, uint8 groupId) co
         }
         else                                                // Plain entries (not a reference, not grouped)
         {
-            if (loot.unique_items.find(i->itemid) == loot.unique_items.end())
+            if (!loot.HasUniqueItem(i->itemid))
                 loot.AddItem(*i);                               // Chance is already checked, just add
         }
     }
@@ -1329,6 +1452,17 @@ void LootTemplate::Process(Loot& loot, LootStore const& store, uint8 groupId) co
         i->Process(loot);
 }
 
+void LootTemplate::Compile()
+{
+    EntryReferences.assign(Entries.size(), (LootTemplate const*)NULL);
+    for (uint32 i = 0; i < Entries.size(); ++i)
+        if (Entries[i].mincountOrRef < 0)
+            EntryReferences[i] = LootTemplates_Reference.GetLootfor(-Entries[i].mincountOrRef);
+
+    for (LootGroups::iterator i = Groups.begin(); i != Groups.end(); ++i)
+        i->Compile();
+}
+
 // True if template includes at least 1 quest drop entry
 bool LootTemplate::HasQuestDrop(LootTemplateMap const& store, uint8 groupId) const
 {
@@ -1631,4 +1765,16 @@ void LoadLootTemplates_Reference()
 
     // output error for any still listed ids (not referenced from any loot table)
     LootTemplates_Reference.ReportUnusedIds(ids_set);
+
+    // references are resolved at compile, old pointers are invalid after (re)load
+    LootTemplates_Creature.Compile();
+    LootTemplates_Fishing.Compile();
+    LootTemplates_Gameobject.Compile();
+    LootTemplates_Item.Compile();
+    LootTemplates_Pickpocketing.Compile();
+    LootTemplates_Skinning.Compile();
+    LootTemplates_Disenchant.Compile();
+    LootTemplates_Prospecting.Compile();
+    LootTemplates_QuestMail.Compile();
+    LootTemplates_Reference.Compile();
 }
@@ -132,6 +132,7 @@ typedef std::vector<LootStoreItem> LootStoreItemList;
 typedef UNORDERED_MAP<uint32, LootTemplate*> LootTemplateMap;
 
 typedef std::set<uint32> LootIdSet;
+typedef std::vector<uint32> LootUniqueItems;             // at most MAX_NR_LOOT_ITEMS, linear search is faster than set
 
 class LootStore
 {
@@ -152,6 +153,9 @@ class LootStore
 
         LootTemplate const* GetLootfor (uint32 loot_id) const;
 
+        // Builds roll tables and resolves references, must be redone after reference store reload
+        void Compile();
+
         char const* GetName() const { return m_name; }
         char const* GetEntryName() const { return m_entryName; }
     protected:
@@ -174,6 +178,9 @@ class LootTemplate
         // Rolls for every item in the template and adds the rolled items the the loot
         void Process(Loot& loot, LootStore const& store, uint8 GroupId = 0) const;
 
+        // Builds group roll tables and resolves references (after whole store and references are loaded)
+        void Compile();
+
         // True if template includes at least 1 quest drop entry
         bool HasQuestDrop(LootTemplateMap const& store, uint8 GroupId = 0) const;
         // True if template includes at least 1 quest drop for an active quest of the player
@@ -185,6 +192,7 @@ class LootTemplate
     private:
         LootStoreItemList Entries;                          // not grouped only
         LootGroups        Groups;                           // groups have own (optimised) processing, grouped entries go there
+        std::vector<LootTemplate const*> EntryReferences;   // referenced template for every entry of Entries, NULL for plain items
 };
 
 //=====================================================
@@ -229,7 +237,7 @@ struct Loot
 
     std::vector<LootItem> items;
     std::vector<LootItem> quest_items;
-    std::set<uint32> unique_items;
+    LootUniqueItems unique_items;                           // only filled while FillLoot() rolls, swapped with a per-thread buffer
     std::set<uint64> players_allowed_to_loot;
 
     // required by round robin to see who can open loot
@@ -277,6 +285,7 @@ struct Loot
     }
 
     bool empty() const { return items.empty() && gold == 0; }
+    bool HasUniqueItem(uint32 itemid) const { return std::find(unique_items.begin(), unique_items.end(), itemid) != unique_items.end(); }
     bool isLooted() const { return gold == 0 && unlootedCount == 0; }
 
     void NotifyItemRemoved(uint8 lootIndex);
@@ -315,10 +315,12 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
 
     time_t expire_time = deliver_time + expire_delay;
 
-    // Add to DB
+    // Add to DB, as part of the caller's transaction if one is open
     std::string safe_subject = GetSubject();
 
-    RealmDataDatabase.BeginTransaction();
+    bool ownTransaction = !RealmDataDatabase.InTransaction();
+    if (ownTransaction)
+        RealmDataDatabase.BeginTransaction();
     RealmDataDatabase.escape_string(safe_subject);
     RealmDataDatabase.PExecute("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,itemTextId,has_items,expire_time,deliver_time,money,cod,checked) "
         "VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '%s', '%u', '%u', '" UI64FMTD "','" UI64FMTD "', '%u', '%u', '%u')",
@@ -330,7 +332,9 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
         RealmDataDatabase.PExecute("INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES ('%u', '%u', '%u','%u')",
             mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
     }
-    RealmDataDatabase.CommitTransaction();
+
+    if (ownTransaction)
+        RealmDataDatabase.CommitTransaction();
 
     // For online receiver update in game mail status and data
     if (pReceiver)
@@ -417,54 +421,149 @@ void Mail::prepareTemplateItems( Player* receiver )
 
 /*! @} */
 
-void WorldSession::SendExternalMails()
+void ExternalMailMgr::Deliver(ExternalMailList const& mails, Player* receiver)
 {
-    if (!sWorld.getConfig(CONFIG_EXTERNAL_MAIL))
+    std::vector<uint64> ids;
+    std::ostringstream idList;
+
+    RealmDataDatabase.BeginTransaction();
+
+    for (ExternalMailList::const_iterator itr = mails.begin(); itr != mails.end(); ++itr)
+    {
+        ExternalMail const& mail = *itr;
+        ObjectGuid receiverGuid = ObjectGuid(HIGHGUID_PLAYER, mail.receiver);
+
+        sLog.outLog(LOG_CHAR, "EXTERNAL MAIL> Sending mail to %u, Item:%u", mail.receiver, mail.itemId);
+        uint32 itemTextId = !mail.message.empty() ? sObjectMgr.CreateItemText(mail.message) : 0;
+
+        MailDraft draft(mail.subject, itemTextId);
+        if (mail.itemId != 0)
+        {
+            if (Item* ToMailItem = Item::CreateItem(mail.itemId, mail.itemCount, receiver))
+            {
+                ToMailItem->SaveToDB();
+                draft.AddItem(ToMailItem);
+            }
+        }
+
+        draft.SetMoney(mail.money)
+            .SendMailTo(MailReceiver(receiver, receiverGuid), MailSender(MAIL_NORMAL, uint32(0), MAIL_STATIONERY_GM), MAIL_CHECK_MASK_RETURNED);
+
+        ids.push_back(mail.id);
+        idList << (idList.tellp() ? "," : "") << mail.id;
+    }
+
+    RealmDataDatabase.PExecute("DELETE FROM mail_external WHERE id IN (%s)", idList.str().c_str());
+    RealmDataDatabase.CommitTransaction();
+
+    // runs on the async connection after the transaction, rows still there were not delivered
+    RealmDataDatabase.AsyncPQuery(this, &ExternalMailMgr::ConfirmCallback, ids, "SELECT id FROM mail_external WHERE id IN (%s)", idList.str().c_str());
+}
+
+void ExternalMailMgr::Update()
+{
+    if (!sWorld.getConfig(CONFIG_EXTERNAL_MAIL) || m_loading)
         return;
 
-    QueryResultAutoPtr result = RealmDataDatabase.Query("SELECT * FROM `mail_external` ORDER by id ASC");
+    if (m_retryId)
+    {
+        m_lastId = std::min(m_lastId, m_retryId - 1);
+        m_retryId = 0;
+    }
+
+    // primary key range, only rows inserted since the last poll are read
+    m_loading = RealmDataDatabase.AsyncPQuery(this, &ExternalMailMgr::LoadCallback,
+        "SELECT id, receiver, subject, message, money, item, item_count FROM mail_external WHERE id > " UI64FMTD " ORDER BY id ASC", m_lastId);
+}
+
+void ExternalMailMgr::LoadCallback(QueryResultAutoPtr result)
+{
+    m_loading = false;
+
     if (!result)
     {
         sLog.outDebug("EXTERNAL MAIL> No Mials to deliver!");
         return;
     }
+
+    typedef std::map<uint32, ExternalMailList> ReceiverMails;
+    ReceiverMails byReceiver;
+
     do
     {
         Field *fields = result->Fetch();
-        uint32 id = fields[0].GetUInt32();
-        uint64 receiver_guid = fields[1].GetUInt32();
-        std::string subject = fields[2].GetString();
-        std::string message = fields[3].GetString();
-        uint32 money = fields[4].GetUInt32();
-        uint32 ItemID = fields[5].GetUInt32();
-        uint32 ItemCount = fields[6].GetUInt32();
-
-        Player *receiver = ObjectAccessor::FindPlayer(receiver_guid);
-        if (receiver != 0)
-        {
-            sLog.outLog(LOG_CHAR, "EXTERNAL MAIL> Sending mail to %u, Item:%u", receiver->GetGUIDLow(), ItemID);
-            uint32 itemTextId = !message.empty() ? sObjectMgr.CreateItemText(message) : 0;
 
-            RealmDataDatabase.PExecute("DELETE FROM mail_external WHERE id=%u", id);
+        ExternalMail mail;
+        mail.id = fields[0].GetUInt64();
+        mail.receiver = fields[1].GetUInt32();
 
-            if (ItemID != 0)
-            {
-                Item* ToMailItem = Item::CreateItem(ItemID, ItemCount, receiver);
-                ToMailItem -> SaveToDB();
+        if (mail.id > m_lastId)
+            m_lastId = mail.id;
 
-                MailDraft(subject, itemTextId)
-                    .AddItem(ToMailItem)
-                    .SetMoney(money)
-                    .SendMailTo(MailReceiver(receiver), MailSender(MAIL_NORMAL, uint32(0), MAIL_STATIONERY_GM), MAIL_CHECK_MASK_RETURNED);
-            }
-            else
-            {
-                MailDraft(subject, itemTextId)
-                    .SetMoney(money)
-                    .SendMailTo(MailReceiver(receiver), MailSender(MAIL_NORMAL, uint32(0), MAIL_STATIONERY_GM), MAIL_CHECK_MASK_RETURNED);
-            }
-        }
+        // read again after a failed delivery, but an earlier one of it is still running
+        if (!m_delivering.insert(mail.id).second)
+            continue;
+
+        mail.subject = fields[2].GetCppString();
+        mail.message = fields[3].GetCppString();
+        mail.money = fields[4].GetUInt32();
+        mail.itemId = fields[5].GetUInt32();
+        mail.itemCount = fields[6].GetUInt32();
+
+        byReceiver[mail.receiver].push_back(mail);
+    }
+    while (result->NextRow());
+
+    // called from World::UpdateResultQueue(), map threads are idle
+    ExternalMailList offline;
+    for (ReceiverMails::const_iterator itr = byReceiver.begin(); itr != byReceiver.end(); ++itr)
+    {
+        if (Player* receiver = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(itr->first, 0, HIGHGUID_PLAYER)))
+            receiver->m_Events.AddEvent(new ExternalMailDeliverEvent(receiver, itr->second), receiver->m_Events.CalculateTime(0));
+        else
+            offline.insert(offline.end(), itr->second.begin(), itr->second.end());
+    }
+
+    if (!offline.empty())
+        Deliver(offline, NULL);
+}
+
+void ExternalMailMgr::ConfirmCallback(QueryResultAutoPtr result, std::vector<uint64> ids)
+{
+    for (std::vector<uint64>::const_iterator itr = ids.begin(); itr != ids.end(); ++itr)
+        m_delivering.erase(*itr);
+
+    if (!result)
+        return;
+
+    // transaction failed or receiver left before delivery, read the rows again at next poll
+    do
+    {
+        uint64 id = result->Fetch()[0].GetUInt64();
+        if (!m_retryId || id < m_retryId)
+            m_retryId = id;
     }
-    while(result -> NextRow());    
+    while (result->NextRow());
+
+    sLog.outLog(LOG_DEFAULT, "ERROR: EXTERNAL MAIL> " UI64FMTD " mails not delivered, trying again", result->GetRowCount());
+}
+
+bool ExternalMailDeliverEvent::Execute(uint64 /*e_time*/, uint32 /*p_time*/)
+{
+    sExternalMailMgr.Deliver(m_mails, m_receiver);
+    return true;
 }
 
+void ExternalMailDeliverEvent::Abort(uint64 /*e_time*/)
+{
+    // receiver leaves the world, rows are still in the table
+    std::vector<uint64> ids;
+    std::ostringstream idList;
+    for (ExternalMailList::const_iterator itr = m_mails.begin(); itr != m_mails.end(); ++itr)
+    {
+        ids.push_back(itr->id);
+        idList << (idList.tellp() ? "," : "") << itr->id;
+    }
+
+    RealmDataDatabase.AsyncPQuery(&sExternalMailMgr, &ExternalMailMgr::ConfirmCallback, ids, "SELECT id FROM mail_external WHERE id IN (%s)", idList.str().c_str());
+}
@@ -37,6 +37,11 @@
 #include "Common.h"
 #include "ObjectGuid.h"
 #include <map>
+#include <set>
+#include <vector>
+#include <ace/Singleton.h>
+#include "Utilities/EventProcessor.h"
+#include "Database/QueryResult.h"
 
 struct AuctionEntry;
 class Item;
@@ -382,5 +387,71 @@ struct Mail
     void prepareTemplateItems(Player* receiver);            ///< called from _LoadMails for generate mailTemplateBase items not generated for offline player
 };
 
+/**
+ * Row of `mail_external` read for delivery.
+ */
+struct ExternalMail
+{
+    uint64 id;
+    uint32 receiver;
+    std::string subject;
+    std::string message;
+    uint32 money;
+    uint32 itemId;
+    uint32 itemCount;
+};
+
+typedef std::vector<ExternalMail> ExternalMailList;
+
+/**
+ * Delivers mails which external tools insert into `mail_external`.
+ *
+ * Each poll reads the rows above the highest id seen so far in the background. Mails of offline
+ * receivers are written in one transaction from the world thread, mails of online receivers are
+ * handed to the receiver's map thread and written there with the player's mail list. The rows are
+ * deleted in the same transaction as the mails are written; rows found still in the table afterwards
+ * are read again.
+ */
+class ExternalMailMgr
+{
+    public:
+        ExternalMailMgr() : m_lastId(0), m_retryId(0), m_loading(false) {}
+
+        /// World thread, starts the next read if the previous one is done
+        void Update();
+
+        /// Writes the mails and deletes their rows in one transaction, then checks the rows are gone
+        void Deliver(ExternalMailList const& mails, Player* receiver);
+
+        void LoadCallback(QueryResultAutoPtr result);
+        void ConfirmCallback(QueryResultAutoPtr result, std::vector<uint64> ids);
+
+    private:
+        uint64 m_lastId;                                    ///< highest id read, rows above it are new
+        uint64 m_retryId;                                   ///< lowest undelivered row to read again, 0 for none
+        bool m_loading;
+
+        typedef std::set<uint64> MailIdSet;
+        MailIdSet m_delivering;                             ///< read but not confirmed deleted yet, world thread only
+};
+
+/**
+ * Delivers external mails on the map thread of their online receiver.
+ */
+class ExternalMailDeliverEvent : public BasicEvent
+{
+    public:
+        ExternalMailDeliverEvent(Player* receiver, ExternalMailList const& mails) : m_receiver(receiver), m_mails(mails) {}
+
+        bool Execute(uint64 e_time, uint32 p_time);
+        void Abort(uint64 e_time);
+
+    private:
+        Player* m_receiver;
+        ExternalMailList m_mails;
+};
+
+#define sExternalMailMgr (*ACE_Singleton<ExternalMailMgr, ACE_Null_Mutex>::instance())
+
 #endif
 /*! @} */
@@ -48,24 +48,14 @@
 #define MAX_GRID_LOAD_TIME      50
 #define MAX_CREATURE_ATTACK_RADIUS  (45.0f * sWorld.getRate(RATE_CREATURE_AGGRO))
 
-struct ScriptAction
-{
-    uint64 sourceGUID;
-    uint64 targetGUID;
-    uint64 ownerGUID;                                       // owner of source if source is item
-    ScriptInfo const* script;                               // pointer to static script data
-};
-
 GridState* si_GridStates[MAX_GRID_STATE];
 
 Map::~Map()
 {
     UnloadAll();
 
-    if (!m_scriptSchedule.empty())
-        sWorld.DecreaseScheduledScriptCount(m_scriptSchedule.size());
-
-     MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
+    if (!m_scriptScheduler.empty())
+        sWorld.DecreaseScheduledScriptCount(m_scriptScheduler.size());
 
     //release reference count
     if (m_TerrainData->Release())
@@ -101,7 +91,7 @@ void Map::DeleteStateMachine()
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
    : i_mapEntry (sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
      i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0), i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-     m_activeNonPlayersIter(m_activeNonPlayers.end()), i_scriptLock(true)
+     m_activeNonPlayersIter(m_activeNonPlayers.end()), i_scriptLock(true), m_gridPreloadElapsed(0), m_gridPreloadClock(0)
 {
     for (unsigned int j=0; j < MAX_NUMBER_OF_GRIDS; ++j)
     {
@@ -319,6 +309,11 @@ void Map::EnsureGridLoadedAtEnter(const Cell &cell, Player *player)
 
 bool Map::EnsureGridLoaded(const Cell &cell)
 {
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+
+    bool created = !getNGrid(cell.GridX(), cell.GridY());
+    bool preloaded = created && m_TerrainData->IsPreloaded((MAX_NUMBER_OF_GRIDS - 1) - cell.GridX(), (MAX_NUMBER_OF_GRIDS - 1) - cell.GridY());
+
     EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
     NGridType *grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -334,11 +329,109 @@ bool Map::EnsureGridLoaded(const Cell &cell)
         sObjectAccessor.AddCorpsesToGrid(GridPair(cell.GridX(),cell.GridY()),(*grid)(cell.CellX(), cell.CellY()), this);
 
         setGridObjectDataLoaded(true,cell.GridX(), cell.GridY());
+        RecordGridLoad(cell, start, preloaded);
         return true;
     }
+
+    if (created)
+        RecordGridLoad(cell, start, preloaded);
+
     return false;
 }
 
+void Map::RecordGridLoad(Cell const& cell, ACE_Time_Value const& start, bool preloaded)
+{
+    ACE_Time_Value spent = ACE_OS::gettimeofday() - start;
+    uint64 time = uint64(spent.sec()) * 1000000 + spent.usec();
+
+    ++m_gridLoadStats.loads;
+    if (preloaded)
+        ++m_gridLoadStats.preloaded;
+
+    m_gridLoadStats.totalTime += time;
+    if (time > m_gridLoadStats.maxTime)
+        m_gridLoadStats.maxTime = time;
+
+    sLog.outDetail("Grid[%u,%u] of map %u instance %u loaded in " UI64FMTD " us%s", cell.GridX(), cell.GridY(), GetId(), i_InstanceId,
+        time, preloaded ? " (terrain preloaded)" : "");
+}
+
+void Map::UpdateGridPreload(uint32 diff)
+{
+    // instances are small, their grids are loaded with the first player
+    uint32 lookAhead = sWorld.getConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD);
+    if (!lookAhead || Instanceable())
+        return;
+
+    m_gridPreloadElapsed += diff;
+    if (m_gridPreloadElapsed < GRID_PRELOAD_INTERVAL)
+        return;
+
+    uint32 elapsed = m_gridPreloadElapsed;
+    m_gridPreloadElapsed = 0;
+    m_gridPreloadClock += elapsed;
+
+    GridPreloadPositions positions;
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->getSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        GridPreloadPosition& pos = positions[player->GetGUID()];
+        pos.x = player->GetPositionX();
+        pos.y = player->GetPositionY();
+
+        GridPreloadPositions::const_iterator last = m_gridPreloadPositions.find(player->GetGUID());
+        if (last == m_gridPreloadPositions.end())
+            continue;
+
+        float dx = pos.x - last->second.x;
+        float dy = pos.y - last->second.y;
+        float dist = sqrt(dx*dx + dy*dy);
+
+        // standing or teleported
+        if (dist < 1.0f || dist > GRID_PRELOAD_MAX_SPEED * elapsed / IN_MILISECONDS)
+            continue;
+
+        // check several points of predicted track, it may cross a grid corner
+        float scale = float(lookAhead) / elapsed / GRID_PRELOAD_STEPS;
+        for (uint8 step = 1; step <= GRID_PRELOAD_STEPS; ++step)
+            PreloadGridAt(pos.x + dx * scale * step, pos.y + dy * scale * step);
+    }
+
+    m_gridPreloadPositions.swap(positions);
+
+    // preloaded terrain is dropped after a while, allow requesting it again
+    for (GridPreloadRequests::iterator itr = m_gridPreloadRequests.begin(); itr != m_gridPreloadRequests.end();)
+    {
+        if (m_gridPreloadClock - itr->second >= GRID_PRELOAD_REQUEST_DELAY)
+            m_gridPreloadRequests.erase(itr++);
+        else
+            ++itr;
+    }
+}
+
+void Map::PreloadGridAt(float x, float y)
+{
+    if (!Looking4group::IsValidMapCoord(x, y))
+        return;
+
+    GridPair p = Looking4group::ComputeGridPair(x, y);
+    if (getNGrid(p.x_coord, p.y_coord))
+        return;
+
+    uint32 gridId = p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord;
+    if (m_gridPreloadRequests.find(gridId) != m_gridPreloadRequests.end())
+        return;
+
+    m_gridPreloadRequests[gridId] = m_gridPreloadClock;
+    ++m_gridLoadStats.requests;
+
+    // terrain grid coords are mirrored, see EnsureGridCreated
+    sTerrainMgr.SchedulePreload(m_TerrainData, (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord, (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord);
+}
+
 void Map::LoadGrid(float x, float y)
 {
     CellPair pair = Looking4group::ComputeCellPair(x, y);
@@ -441,6 +534,8 @@ void Map::Update(const uint32 &t_diff)
 {
     MAP_UPDATE_DIFF(DiffRecorder diff("", 0))
 
+    m_chatPacketCache.Update();
+
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -469,6 +564,7 @@ void Map::Update(const uint32 &t_diff)
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_PLAYER_UPDATE, diff.RecordTimeFor(""), GetId()))
 
     resetMarkedCells();
+    m_creatureLOD.Reset(GetVisibilityDistance());
 
     Looking4group::ObjectUpdater updater(t_diff);
     // for creature
@@ -494,26 +590,36 @@ void Map::Update(const uint32 &t_diff)
 
         CellArea area = Cell::CalculateCellArea(plr->GetPositionX(), plr->GetPositionY(), GetVisibilityDistance() + World::GetVisibleObjectGreyDistance());
 
+        // cells are visited after all players are known, update rate of creatures depends on nearest one
         for (uint32 x = area.low_bound.x_coord; x < area.high_bound.x_coord; ++x)
         {
             for (uint32 y = area.low_bound.y_coord; y < area.high_bound.y_coord; ++y)
             {
-                // marked cells are those that have been visited
-                // don't visit the same cell twice
                 uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                {
-                    markCell(cell_id);
-                    CellPair pair(x,y);
-                    Cell cell(pair);
-                    cell.SetNoCreate();
-                    Visit(cell, grid_object_update);
-                    Visit(cell, world_object_update);
-                }
+                markCell(cell_id);
+                m_creatureLOD.AddPlayer(cell_id, plr->GetPositionX(), plr->GetPositionY());
             }
         }
     }
 
+    updater.i_lod = &m_creatureLOD;
+
+    CreatureUpdateLOD::CellList const& cells = m_creatureLOD.GetCells();
+    for (CreatureUpdateLOD::CellList::const_iterator itr = cells.begin(); itr != cells.end(); ++itr)
+    {
+        updater.i_cell = &*itr;
+
+        CellPair pair(itr->cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP, itr->cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_object_update);
+        Visit(cell, world_object_update);
+    }
+
+    // active objects keep cells around them at full rate
+    updater.i_lod = NULL;
+    updater.i_cell = NULL;
+
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_PLAYER_GRID_VISIT, diff.RecordTimeFor(""), GetId()))
 
     // non-player active objects
@@ -556,13 +662,19 @@ void Map::Update(const uint32 &t_diff)
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_ACTIVEUNIT_GRID_VISIT, diff.RecordTimeFor(""), GetId()))
 
+    // path updates queued by movement generators during unit updates
+    m_pathService.Update(*this, t_diff);
+
+    // read terrain of grids players are heading to
+    UpdateGridPreload(t_diff);
+
     // Send world objects and item update field changes
     SendObjectUpdates();
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_SEND_OBJECTS_UPDATE, diff.RecordTimeFor(""), GetId()))
 
     ///- Process necessary scripts
-    if (!m_scriptSchedule.empty())
+    if (!m_scriptScheduler.empty())
     {
         i_scriptLock = true;
         ScriptsProcess();
@@ -686,6 +798,9 @@ void Map::Remove(T *obj, bool remove)
         if (!sWorld.getConfig(CONFIG_SAVE_RESPAWN_TIME_IMMEDIATELY))
             obj->SaveRespawnTime();
 
+        // scripts of deleted object would only report missing source
+        CancelScripts(obj->GetGUID());
+
         DeleteFromWorld(obj);
     }
 }
@@ -1266,7 +1381,7 @@ void Map::ScriptsStart(ScriptMapMap const& scripts, uint32 id, Object* source, O
         sa.ownerGUID  = ownerGUID;
 
         sa.script = &iter->second;
-        m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + iter->first), sa));
+        m_scriptScheduler.Schedule(sa, iter->first * IN_MILISECONDS, WorldTimer::getMSTime());
         if (iter->first == 0)
             immedScript = true;
 
@@ -1296,7 +1411,7 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
     sa.ownerGUID  = ownerGUID;
 
     sa.script = &script;
-    m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + delay), sa));
+    m_scriptScheduler.Schedule(sa, delay * IN_MILISECONDS, WorldTimer::getMSTime());
 
     sWorld.IncreaseScheduledScriptsCount();
 
@@ -1312,15 +1427,15 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
 /// Process queued scripts
 void Map::ScriptsProcess()
 {
-    if (m_scriptSchedule.empty())
+    if (m_scriptScheduler.empty())
         return;
 
     ///- Process overdue queued scripts
-    std::multimap<time_t, ScriptAction>::iterator iter = m_scriptSchedule.begin();
-                                                            // ok as multimap is a *sorted* associative container
-    while (!m_scriptSchedule.empty() && (iter->first <= sWorld.GetGameTime()))
+    ScriptAction step;
+    // time is read for every action, actions scheduled without delay by previous one run in this pass too
+    while (m_scriptScheduler.PopDue(WorldTimer::getMSTime(), step))
     {
-        ScriptAction const& step = iter->second;
+        sWorld.DecreaseScheduledScriptCount();
 
         Object* source = NULL;
 
@@ -2067,7 +2182,7 @@ void Map::ScriptsProcess()
                 if (!pInst)
                 {
                     sLog.outLog(LOG_DEFAULT, "ERROR: SCRIPT_COMMAND_SET_INST_DATA %d attempt to set instance data without instance script.", step.script->id);
-                    return;
+                    break;
                 }
 
                 pInst->SetData(step.script->datalong, step.script->datalong2);
@@ -2078,14 +2193,33 @@ void Map::ScriptsProcess()
                 sLog.outLog(LOG_DEFAULT, "ERROR: Unknown script command %u called.",step.script->command);
                 break;
         }
+    }
+}
 
-        m_scriptSchedule.erase(iter);
-        sWorld.DecreaseScheduledScriptCount();
-
-        iter = m_scriptSchedule.begin();
+// commands which do something even when their source is gone
+static bool ScriptNeedsSource(ScriptAction const& action)
+{
+    switch (action.script->command)
+    {
+        case SCRIPT_COMMAND_TELEPORT_TO:
+        case SCRIPT_COMMAND_CALLSCRIPT_TO_UNIT:
+            return false;
+        case SCRIPT_COMMAND_REMOVE_AURA:
+            return action.script->datalong2 != 0;
+        default:
+            return true;
     }
 }
 
+void Map::CancelScripts(uint64 sourceGUID)
+{
+    if (m_scriptScheduler.empty())
+        return;
+
+    if (uint32 count = m_scriptScheduler.CancelBySource(sourceGUID, &ScriptNeedsSource))
+        sWorld.DecreaseScheduledScriptCount(count);
+}
+
 
 template void Map::Add(Corpse *);
 template void Map::Add(Creature *);
@@ -34,6 +34,10 @@
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
 #include "mersennetwister/MersenneTwister.h"
+#include "movemap/PathService.h"
+#include "ScriptScheduler.h"
+#include "CreatureUpdateLOD.h"
+#include "ChatPacketCache.h"
 
 #include <tbb/concurrent_hash_map.h>
 
@@ -56,7 +60,6 @@ class GridMap;
 class TerrainInfo;
 
 struct ScriptInfo;
-struct ScriptAction;
 
 struct CreatureMover
 {
@@ -102,6 +105,22 @@ enum LevelRequirementVsMode
 #define INVALID_HEIGHT       -100000.0f                     // for check, must be equal to VMAP_INVALID_HEIGHT, real value for unknown height is VMAP_INVALID_HEIGHT_VALUE
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 
+#define GRID_PRELOAD_INTERVAL       1000                    // how often player movement is checked for grids to preload
+#define GRID_PRELOAD_STEPS          4                       // points checked along predicted track
+#define GRID_PRELOAD_MAX_SPEED      100.0f                  // yards per second, faster movement is teleport
+#define GRID_PRELOAD_REQUEST_DELAY  60000                   // same grid is not requested again sooner
+
+struct GridLoadStats
+{
+    GridLoadStats() : loads(0), preloaded(0), requests(0), totalTime(0), maxTime(0) {}
+
+    uint32 loads;                                           // grids loaded by map thread
+    uint32 preloaded;                                       // of them with terrain read by preload thread
+    uint32 requests;                                        // grids scheduled for preload
+    uint64 totalTime;                                       // microseconds map thread spent loading grids
+    uint64 maxTime;                                         // longest single grid load
+};
+
 typedef UNORDERED_MAP<Creature*, CreatureMover>                 CreatureMoveList;
 typedef std::map<uint32/*leaderDBGUID*/, CreatureGroup*>        CreatureGroupHolderType;
 typedef tbb::concurrent_hash_map<uint64, GameObject*>           GObjectMapType;
@@ -297,9 +316,18 @@ class LOOKING4GROUP_IMPORT_EXPORT Map : public GridRefManager<NGridType>
             return i_grids[x][y];
         }
 
+        PathService& GetPathService() { return m_pathService; }
+
+        ChatPacketCache& GetChatPacketCache() { return m_chatPacketCache; }
+
+        GridLoadStats const& GetGridLoadStats() const { return m_gridLoadStats; }
+
         //per-map script storage
         void ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo> > const& scripts, uint32 id, Object* source, Object* target);
         void ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* source, Object* target);
+        void CancelScripts(uint64 sourceGUID);
+        ScriptSchedulerStats const& GetScriptSchedulerStats() const { return m_scriptScheduler.GetStats(); }
+        CreatureUpdateStats const& GetCreatureUpdateStats() const { return m_creatureLOD.GetStats(); }
 
     private:
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
@@ -322,6 +350,10 @@ class LOOKING4GROUP_IMPORT_EXPORT Map : public GridRefManager<NGridType>
 
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
+        void UpdateGridPreload(uint32 diff);
+        void PreloadGridAt(float x, float y);
+        void RecordGridLoad(Cell const& cell, ACE_Time_Value const& start, bool preloaded);
+
         bool isGridObjectDataLoaded(uint32 x, uint32 y) const { return getNGrid(x,y)->isGridObjectDataLoaded(); }
         void setGridObjectDataLoaded(bool pLoaded, uint32 x, uint32 y) { getNGrid(x,y)->setGridObjectDataLoaded(pLoaded); }
 
@@ -374,7 +406,27 @@ class LOOKING4GROUP_IMPORT_EXPORT Map : public GridRefManager<NGridType>
 
         std::set<WorldObject *> i_objectsToRemove;
         std::map<WorldObject*, bool> i_objectsToSwitch;
-        std::multimap<time_t, ScriptAction> m_scriptSchedule;
+        ScriptScheduler m_scriptScheduler;
+        CreatureUpdateLOD m_creatureLOD;
+        ChatPacketCache m_chatPacketCache;
+
+        PathService m_pathService;
+
+        // player positions at previous preload check, movement since then predicts next grids
+        struct GridPreloadPosition
+        {
+            float x;
+            float y;
+        };
+
+        typedef UNORDERED_MAP<uint64, GridPreloadPosition> GridPreloadPositions;
+        typedef UNORDERED_MAP<uint32, uint32> GridPreloadRequests;
+
+        GridPreloadPositions m_gridPreloadPositions;
+        GridPreloadRequests m_gridPreloadRequests;          // grid id -> request time
+        uint32 m_gridPreloadElapsed;
+        uint32 m_gridPreloadClock;
+        GridLoadStats m_gridLoadStats;
 
         // Type specific code for add/remove to/from grid
         template<class T>
@@ -62,6 +62,9 @@ void MapManager::Initialize()
         sLog.outLog(LOG_DEFAULT, "ERROR: MapUpdater cannot be activated !!!!!");
         abort();
     }
+
+    if (sWorld.getConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD))
+        sTerrainMgr.ActivatePreloader();
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
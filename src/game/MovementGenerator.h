@@ -57,6 +57,9 @@ class LOOKING4GROUP_IMPORT_EXPORT MovementGenerator : public UnitAction
         // given destination unreachable? due to path finding or other
         virtual bool IsReachable() const { return true; }
 
+        // called by map path service for path update queued by this movement generator
+        virtual void ProcessPathRequest(Unit &) { }
+
         // used for check from Update call is movegen still be active (top movement generator)
         // after some not safe for this calls
         bool IsActive(Unit& u);
@@ -1361,11 +1361,22 @@ namespace Looking4group
         public:
             MonsterChatBuilder(WorldObject const& obj, ChatMsg msgtype, int32 textId, uint32 language, uint64 targetGUID, bool withoutPrename = false)
                 : i_object(obj), i_msgtype(msgtype), i_textId(textId), i_language(language), i_targetGUID(targetGUID), i_withoutPrename(withoutPrename) {}
-            void operator()(WorldPacket& data, int32 loc_idx)
+            // packet is kept by map, same text of the same speaker sent before is sent again as it is
+            WorldPacket const* operator()(int32 loc_idx)
             {
+                ChatPacketCache& cache = i_object.GetMap()->GetChatPacketCache();
+                ChatPacketKey key(i_textId, loc_idx, i_language, i_msgtype, i_withoutPrename, i_object.GetGUID(), i_targetGUID);
+
+                if (WorldPacket const* cached = cache.Find(key))
+                    return cached;
+
+                WorldPacket* data = cache.Insert(key);
+                data->Initialize(SMSG_MESSAGECHAT, 200);
+
                 char const* text = sObjectMgr.GetTrinityString(i_textId, loc_idx);
                 // TODO: i_object.GetName() also must be localized?
-                i_object.BuildMonsterChat(&data, i_msgtype, text, i_language, i_object.GetNameForLocaleIdx(loc_idx), i_targetGUID, i_withoutPrename);
+                i_object.BuildMonsterChat(data, i_msgtype, text, i_language, i_object.GetNameForLocaleIdx(loc_idx), i_targetGUID, i_withoutPrename);
+                return data;
             }
 
         private:
@@ -1382,9 +1393,9 @@ void WorldObject::MonsterSay(int32 textId, uint32 language, uint64 TargetGuid)
 {
     float range = sWorld.getConfig(CONFIG_LISTEN_RANGE_SAY);
     Looking4group::MonsterChatBuilder say_build(*this, CHAT_MSG_MONSTER_SAY, textId, language, TargetGuid);
-    Looking4group::LocalizedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
-    Looking4group::CameraDistWorker<Looking4group::LocalizedPacketDo<Looking4group::MonsterChatBuilder> > say_worker(this, range, say_do);
-    TypeContainerVisitor<Looking4group::CameraDistWorker<Looking4group::LocalizedPacketDo<Looking4group::MonsterChatBuilder> >, WorldTypeMapContainer > message(say_worker);
+    Looking4group::CachedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
+    Looking4group::CameraDistWorker<Looking4group::CachedPacketDo<Looking4group::MonsterChatBuilder> > say_worker(this, range, say_do);
+    TypeContainerVisitor<Looking4group::CameraDistWorker<Looking4group::CachedPacketDo<Looking4group::MonsterChatBuilder> >, WorldTypeMapContainer > message(say_worker);
     //cell_lock->Visit(cell_lock, message, *GetMap());
     Cell::VisitWorldObjects(this, say_worker, range);
 }
@@ -1393,15 +1404,15 @@ void WorldObject::MonsterYell(int32 textId, uint32 language, uint64 TargetGuid)
 {
     float range = sWorld.getConfig(CONFIG_LISTEN_RANGE_YELL);
     Looking4group::MonsterChatBuilder say_build(*this, CHAT_MSG_MONSTER_YELL, textId, language, TargetGuid);
-    Looking4group::LocalizedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
-    Looking4group::CameraDistWorker<Looking4group::LocalizedPacketDo<Looking4group::MonsterChatBuilder> > say_worker(this, range, say_do);
+    Looking4group::CachedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
+    Looking4group::CameraDistWorker<Looking4group::CachedPacketDo<Looking4group::MonsterChatBuilder> > say_worker(this, range, say_do);
     Cell::VisitWorldObjects(this, say_worker, range);
 }
 
 void WorldObject::MonsterYellToZone(int32 textId, uint32 language, uint64 TargetGuid)
 {
     Looking4group::MonsterChatBuilder say_build(*this, CHAT_MSG_MONSTER_YELL, textId, language, TargetGuid);
-    Looking4group::LocalizedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
+    Looking4group::CachedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
 
     uint32 zoneid = GetZoneId();
 
@@ -1415,15 +1426,15 @@ void WorldObject::MonsterTextEmote(int32 textId, uint64 TargetGuid, bool IsBossE
 {
     float range = sWorld.getConfig(IsBossEmote ? CONFIG_LISTEN_RANGE_YELL : CONFIG_LISTEN_RANGE_TEXTEMOTE);
     Looking4group::MonsterChatBuilder say_build(*this, IsBossEmote ? CHAT_MSG_RAID_BOSS_EMOTE : CHAT_MSG_MONSTER_EMOTE, textId, LANG_UNIVERSAL, TargetGuid, withoutPrename);
-    Looking4group::LocalizedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
-    Looking4group::CameraDistWorker<Looking4group::LocalizedPacketDo<Looking4group::MonsterChatBuilder> > say_worker(this, range, say_do);
+    Looking4group::CachedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
+    Looking4group::CameraDistWorker<Looking4group::CachedPacketDo<Looking4group::MonsterChatBuilder> > say_worker(this, range, say_do);
     Cell::VisitWorldObjects(this, say_worker, range);
 }
 
 void WorldObject::MonsterTextEmoteToZone(int32 textId, uint64 TargetGuid, bool IsBossEmote, bool withoutPrename)
 {
     Looking4group::MonsterChatBuilder say_build(*this, IsBossEmote ? CHAT_MSG_RAID_BOSS_EMOTE : CHAT_MSG_MONSTER_EMOTE, textId, LANG_UNIVERSAL, TargetGuid, withoutPrename);
-    Looking4group::LocalizedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
+    Looking4group::CachedPacketDo<Looking4group::MonsterChatBuilder> say_do(say_build);
 
     uint32 zoneid = GetZoneId();
 
@@ -1892,13 +1903,11 @@ const Pet* WorldObject::ToPet() const
     return NULL;
 }
 
-bool WorldObject::UpdateHelper::ProcessUpdate(Creature* creature)
+bool WorldObject::UpdateHelper::ProcessUpdate(Creature* creature, uint32 minUpdateTime)
 {
     if (!creature->IsInWorld() || creature->isSpiritService())
         return false;
 
-    uint32 minUpdateTime = sWorld.getConfig(CONFIG_INTERVAL_MAPUPDATE);
-
     return creature->m_updateTracker.timeElapsed() >= minUpdateTime;
 }
 
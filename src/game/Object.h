@@ -380,7 +380,7 @@ class LOOKING4GROUP_IMPORT_EXPORT WorldObject : public Object//, public WorldLoc
 
                 //bool ProcessUpdate();
 
-                static bool ProcessUpdate(Creature*);
+                static bool ProcessUpdate(Creature*, uint32 minUpdateTime);
                 static bool ProcessUpdate(WorldObject*);
 
                 time_t GetTimeElapsed() const { return m_obj->m_updateTracker.timeElapsed(); }
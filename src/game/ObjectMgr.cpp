@@ -213,6 +213,7 @@ CreatureInfo const* ObjectMgr::GetCreatureTemplate(uint32 id)
 void ObjectMgr::LoadCreatureLocales()
 {
     mCreatureLocaleMap.clear();                              // need for reload case
+    ChatPacketCache::Invalidate();                           // cached creature texts have the old names
 
     QueryResultAutoPtr result = GameDataDatabase.Query("SELECT entry,name_loc1,subname_loc1,name_loc2,subname_loc2,name_loc3,subname_loc3,name_loc4,subname_loc4,name_loc5,subname_loc5,name_loc6,subname_loc6,name_loc7,subname_loc7,name_loc8,subname_loc8 FROM locales_creature");
 
@@ -350,6 +351,7 @@ void ObjectMgr::LoadCreatureTemplates()
 {
     SQLCreatureLoader loader;
     loader.Load(sCreatureStorage);
+    ChatPacketCache::Invalidate();                           // cached creature texts have the old names
 
     sLog.outString(">> Loaded %u creature definitions", sCreatureStorage.RecordCount);
     sLog.outString();
@@ -5759,6 +5761,9 @@ bool ObjectMgr::LoadLooking4groupStrings(DatabaseType& db, char const* table, in
         }
     }
 
+    // cached creature texts have the old strings
+    ChatPacketCache::Invalidate();
+
     // cleanup affected map part for reloading case
     for (Looking4groupStringLocaleMap::iterator itr = mLooking4groupStringLocaleMap.begin(); itr != mLooking4groupStringLocaleMap.end();)
     {
@@ -345,7 +345,7 @@ OpcodeHandler opcodeTable[NUM_MSG_TYPES] =
     /*0x13A*/ { "MSG_CHANNEL_UPDATE",               STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_NULL                     },
     /*0x13B*/ { "CMSG_CANCEL_CHANNELLING",          STATUS_LOGGEDIN,    PROCESS_THREADUNSAFE,  &WorldSession::HandleCancelChanneling          },
     /*0x13C*/ { "SMSG_AI_REACTION",                 STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_ServerSide               },
-    /*0x13D*/ { "CMSG_SET_SELECTION",               STATUS_LOGGEDIN,    PROCESS_INPLACE,  &WorldSession::HandleSetSelectionOpcode        },
+    /*0x13D*/ { "CMSG_SET_SELECTION",               STATUS_LOGGEDIN,    PROCESS_INPLACE,  &WorldSession::HandleSetSelectionOpcode,       true },
     /*0x13E*/ { "CMSG_SET_TARGET_OBSOLETE",         STATUS_LOGGEDIN,    PROCESS_THREADUNSAFE,  &WorldSession::HandleSetTargetOpcode           },
     /*0x13F*/ { "CMSG_UNUSED",                      STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_NULL                     },
     /*0x140*/ { "CMSG_UNUSED2",                     STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_NULL                     },
@@ -1089,3 +1089,30 @@ OpcodeHandler opcodeTable[NUM_MSG_TYPES] =
     /*0x422*/ { "SMSG_SPLINE_MOVE_UNSET_FLYING",    STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_ServerSide               },
     /*0x423*/ { "SMSG_SUMMON_CANCEL",               STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_ServerSide               },
 };
+
+uint32 const opcodeTimeBucketLimits[OPCODE_TIME_BUCKETS - 1] = { 50, 100, 250, 500, 1000, 5000, 25000 };
+
+OpcodeTimeStats opcodeTimes[NUM_MSG_TYPES];
+
+void OpcodeTimeStats::Add(uint32 time)
+{
+    uint32 bucket = 0;
+    while (bucket < OPCODE_TIME_BUCKETS - 1 && time >= opcodeTimeBucketLimits[bucket])
+        ++bucket;
+
+    ++buckets[bucket];
+    totalTime += time;
+
+    if (long(time) > maxTime.value())
+        maxTime = long(time);
+}
+
+void OpcodeTimeStats::Reset()
+{
+    for (uint32 i = 0; i < OPCODE_TIME_BUCKETS; ++i)
+        buckets[i] = 0;
+
+    totalTime = 0;
+    maxTime = 0;
+    coalesced = 0;
+}
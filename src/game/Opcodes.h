@@ -33,6 +33,8 @@
 //       table opcodeTable in source when Opcode.h included but WorldSession.h not included
 #include "WorldSession.h"
 
+#include <ace/Atomic_Op.h>
+
 /// List of Opcodes
 enum Opcodes
 {
@@ -1125,10 +1127,33 @@ struct OpcodeHandler
     SessionStatus status;
     PacketProcessing packetProcessing;
     void (WorldSession::*handler)(WorldPacket& recvPacket);
+    bool coalesce;                                          // only latest of queued packets with this opcode is handled,
+                                                            // not for movement: fall damage and anticheat need every packet
 };
 
 extern OpcodeHandler opcodeTable[NUM_MSG_TYPES];
 
+#define OPCODE_TIME_BUCKETS 8
+
+// upper handler time limits (in microseconds) of all buckets but last one
+extern uint32 const opcodeTimeBucketLimits[OPCODE_TIME_BUCKETS - 1];
+
+/// Handler times of one opcode, updated from world and map threads
+struct OpcodeTimeStats
+{
+    void Add(uint32 time);
+    void Reset();
+
+    typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> Counter;
+
+    Counter buckets[OPCODE_TIME_BUCKETS];
+    ACE_Atomic_Op<ACE_Thread_Mutex, uint64> totalTime;
+    Counter maxTime;                                        // may miss a maximum set at the same time by another thread
+    Counter coalesced;                                      // packets dropped because same opcode followed
+};
+
+extern OpcodeTimeStats opcodeTimes[NUM_MSG_TYPES];
+
 /// Lookup opcode name for human understandable logging
 inline const char* LookupOpcodeName(uint16 id)
 {
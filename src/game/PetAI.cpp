@@ -340,8 +340,8 @@ void PetAI::UpdateAI(const uint32 diff)
             }
             else
             {
-                std::list<HostilReference*>& m_threatlist = m_creature->getThreatManager().getThreatList();
-                std::list<HostilReference*>::iterator itr;
+                std::list<HostilReference*> const& m_threatlist = m_creature->getThreatManager().getThreatList();
+                std::list<HostilReference*>::const_iterator itr;
 
                 for(itr = m_threatlist.begin(); itr != m_threatlist.end(); ++itr)
                 {
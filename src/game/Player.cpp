@@ -440,6 +440,9 @@ Player::Player (WorldSession *session): Unit(), m_reputationMgr(this), m_camera(
 
     m_spellPenetrationItemMod = 0;
 
+    m_statUpdateMask = 0;
+    m_statUpdateBatchDepth = 0;
+
     // Honor System
     m_lastHonorUpdateTime = time(NULL);
 
@@ -1190,6 +1193,13 @@ void Player::Update(uint32 update_diff, uint32 p_time)
 
     positionStatus.Update(update_diff);
 
+    // batches are flushed when closed, nothing should be left pending here
+    FlushStatUpdates();
+    m_statUpdateTotal.performed += m_statUpdateCounters.performed;
+    m_statUpdateTotal.avoided += m_statUpdateCounters.avoided;
+    m_statUpdateLastTick = m_statUpdateCounters;
+    m_statUpdateCounters = PlayerStatUpdateCounters();
+
     // undelivered mail
     if (m_nextMailDelivereTime && m_nextMailDelivereTime <= time(NULL))
     {
@@ -1452,8 +1462,10 @@ void Player::Update(uint32 update_diff, uint32 p_time)
         }
     }
 
-    // group update
-    SendUpdateToOutOfRangeGroupMembers();
+    // group update, sent by the world thread together with the other members
+    if (m_groupUpdateMask != GROUP_UPDATE_FLAG_NONE)
+        if (Group* group = GetGroup())
+            group->QueueMemberStatsUpdate();
 
     _preventUpdate = false;
     updateMutex.release();
@@ -5096,6 +5108,8 @@ float Player::OCTRegenMPPerSpirit()
 
 void Player::ApplyRatingMod(CombatRating cr, int32 value, bool apply)
 {
+    PlayerStatUpdateBatch batch(this);
+
     ApplyModUInt32Value(PLAYER_FIELD_COMBAT_RATING_1 + cr, value, apply);
 
     float RatingCoeffecient = GetRatingCoefficient(cr);
@@ -6827,6 +6841,9 @@ void Player::_ApplyItemBonuses(ItemPrototype const *proto,uint8 slot,bool apply)
     if (slot >= INVENTORY_SLOT_BAG_END || !proto)
         return;
 
+    // stats, ratings, armor and damage of one item recalculate dependent values once
+    PlayerStatUpdateBatch batch(this);
+
     for (int i = 0; i < MAX_ITEM_PROTO_STATS; i++)
     {
         float val = float (proto->ItemStat[i].ItemStatValue);
@@ -19013,27 +19030,27 @@ bool Player::IsVisibleGloballyfor (Player* u) const
 }
 
 template<class T>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, T* target, std::set<WorldObject*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, T* target, std::set<WorldObject*>& v)
 {
     s64.insert(target->GetGUID());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, GameObject* target, std::set<WorldObject*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, GameObject* target, std::set<WorldObject*>& v)
 {
     if(!target->IsTransport())
         s64.insert(target->GetGUID());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Creature* target, std::set<WorldObject*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, Creature* target, std::set<WorldObject*>& v)
 {
     s64.insert(target->GetGUID());
     v.insert(target);
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Player* target, std::set<WorldObject*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, Player* target, std::set<WorldObject*>& v)
 {
     s64.insert(target->GetGUID());
     v.insert(target);
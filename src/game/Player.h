@@ -417,6 +417,41 @@ enum PlayerStateType
     PLAYER_STATE_FLAG_ALL          = 0xFF000000,
 };
 
+// derived player stats, while a PlayerStatUpdateBatch is open their recalculation
+// is only marked here and done once when the outermost batch ends
+// max health and max power are never deferred, current health/power is clamped by them
+enum PlayerStatUpdateFlags
+{
+    PLAYER_STAT_UPDATE_ARMOR                = 0x00000001,
+    PLAYER_STAT_UPDATE_RESISTANCE_HOLY      = 0x00000002,   // one flag per school up to arcane
+    PLAYER_STAT_UPDATE_ATTACK_POWER         = 0x00000080,
+    PLAYER_STAT_UPDATE_RANGED_ATTACK_POWER  = 0x00000100,
+    PLAYER_STAT_UPDATE_DAMAGE_MAINHAND      = 0x00000200,
+    PLAYER_STAT_UPDATE_DAMAGE_OFFHAND       = 0x00000400,
+    PLAYER_STAT_UPDATE_DAMAGE_RANGED        = 0x00000800,
+    PLAYER_STAT_UPDATE_CRIT_FROM_AGILITY    = 0x00001000,
+    PLAYER_STAT_UPDATE_CRIT_MAINHAND        = 0x00002000,
+    PLAYER_STAT_UPDATE_CRIT_OFFHAND         = 0x00004000,
+    PLAYER_STAT_UPDATE_CRIT_RANGED          = 0x00008000,
+    PLAYER_STAT_UPDATE_SPELL_CRIT_NORMAL    = 0x00010000,   // one flag per school up to arcane
+    PLAYER_STAT_UPDATE_BLOCK                = 0x00800000,
+    PLAYER_STAT_UPDATE_PARRY                = 0x01000000,
+    PLAYER_STAT_UPDATE_DODGE                = 0x02000000,
+    PLAYER_STAT_UPDATE_SHIELD_BLOCK         = 0x04000000,
+    PLAYER_STAT_UPDATE_EXPERTISE_MAINHAND   = 0x08000000,
+    PLAYER_STAT_UPDATE_EXPERTISE_OFFHAND    = 0x10000000,
+    PLAYER_STAT_UPDATE_SPELL_BONUS          = 0x20000000,
+    PLAYER_STAT_UPDATE_MANA_REGEN           = 0x40000000
+};
+
+struct PlayerStatUpdateCounters
+{
+    PlayerStatUpdateCounters() : performed(0), avoided(0) {}
+
+    uint64 performed;                                       // derived stat recalculations done
+    uint64 avoided;                                         // requests merged into an already pending recalculation
+};
+
 enum PlayerFlags
 {
     PLAYER_FLAGS_GROUP_LEADER   = 0x00000001,
@@ -1711,6 +1746,12 @@ class LOOKING4GROUP_EXPORT Player : public Unit
         void UpdateExpertise(WeaponAttackType attType);
         void UpdateManaRegen();
 
+        void BeginStatUpdateBatch() { ++m_statUpdateBatchDepth; }
+        void EndStatUpdateBatch();
+        void FlushStatUpdates();
+        PlayerStatUpdateCounters const& GetStatUpdateCountersLastTick() const { return m_statUpdateLastTick; }
+        PlayerStatUpdateCounters const& GetStatUpdateCountersTotal() const { return m_statUpdateTotal; }
+
         const uint64& GetLootGUID() const { return m_lootGuid; }
         void SetLootGUID(const uint64 &guid) { m_lootGuid = guid; }
 
@@ -2158,7 +2199,7 @@ class LOOKING4GROUP_EXPORT Player : public Unit
         bool TeleportToHomebind(uint32 options = 0) { return TeleportTo(m_homebindMapId, m_homebindX, m_homebindY, m_homebindZ, GetOrientation(), options); }
 
         // currently visible objects at player client
-        typedef std::set<uint64> ClientGUIDs;
+        typedef FlatHashSet<uint64, 0> ClientGUIDs;     // guid 0 is never at client
         ClientGUIDs m_clientGUIDs;
 
         bool HaveAtClient(WorldObject const* u) const { return u == this || m_clientGUIDs.find(u->GetGUID()) != m_clientGUIDs.end(); }
@@ -2439,6 +2480,14 @@ class LOOKING4GROUP_EXPORT Player : public Unit
 
         int32 m_spellPenetrationItemMod;
 
+        bool DeferStatUpdate(uint32 flag);
+
+        uint32 m_statUpdateMask;
+        uint32 m_statUpdateBatchDepth;
+        PlayerStatUpdateCounters m_statUpdateCounters;      // current tick
+        PlayerStatUpdateCounters m_statUpdateLastTick;
+        PlayerStatUpdateCounters m_statUpdateTotal;
+
         uint64 m_resurrectGUID;
         uint32 m_resurrectMap;
         float m_resurrectX, m_resurrectY, m_resurrectZ;
@@ -2582,6 +2631,27 @@ class LOOKING4GROUP_EXPORT Player : public Unit
         InstanceTimeMap _instanceResetTimes;
 };
 
+/// Defers derived stat recalculation of a player target until the outermost batch
+/// ends, so chains of modifier changes recalculate every affected value only once
+class PlayerStatUpdateBatch
+{
+    public:
+        explicit PlayerStatUpdateBatch(Unit* unit) : m_player(unit->GetTypeId() == TYPEID_PLAYER ? (Player*)unit : NULL)
+        {
+            if (m_player)
+                m_player->BeginStatUpdateBatch();
+        }
+
+        ~PlayerStatUpdateBatch()
+        {
+            if (m_player)
+                m_player->EndStatUpdateBatch();
+        }
+
+    private:
+        Player* m_player;
+};
+
 typedef std::set<Player*> PlayerSet;
 typedef std::list<Player*> PlayerList;
 
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2005-2009 MaNGOS <http://getmangos.com/>
+ *
+ * Copyright (C) 2008-2009 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ScriptScheduler.h"
+
+#include <algorithm>
+
+ScriptScheduler::ScriptScheduler() : m_current(0), m_overduePos(0)
+{
+    for (uint32 i = 0; i < SCRIPT_WHEEL_SLOTS; ++i)
+    {
+        m_slotHead[i] = SCRIPT_NO_NODE;
+        m_slotTail[i] = SCRIPT_NO_NODE;
+    }
+}
+
+void ScriptScheduler::Schedule(ScriptAction const& action, uint32 delay, uint32 now)
+{
+    if (empty())
+        m_current = now;
+
+    uint32 index;
+    if (!m_freeNodes.empty())
+    {
+        index = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        index = m_nodes.size();
+        m_nodes.push_back(Node());
+    }
+
+    Node& node = m_nodes[index];
+    node.action = action;
+    node.due = now + delay;
+    node.next = SCRIPT_NO_NODE;
+    node.overdue = false;
+
+    uint32 slot = node.due & (SCRIPT_WHEEL_SLOTS - 1);
+    node.prev = m_slotTail[slot];
+
+    if (m_slotTail[slot] != SCRIPT_NO_NODE)
+        m_nodes[m_slotTail[slot]].next = index;
+    else
+        m_slotHead[slot] = index;
+
+    m_slotTail[slot] = index;
+
+    if (action.sourceGUID)
+        m_bySource[action.sourceGUID].push_back(index);
+
+    ++m_stats.scheduled;
+    if (++m_stats.queued > m_stats.peak)
+        m_stats.peak = m_stats.queued;
+}
+
+void ScriptScheduler::Unlink(uint32 index)
+{
+    Node& node = m_nodes[index];
+    uint32 slot = node.due & (SCRIPT_WHEEL_SLOTS - 1);
+
+    if (node.prev != SCRIPT_NO_NODE)
+        m_nodes[node.prev].next = node.next;
+    else
+        m_slotHead[slot] = node.next;
+
+    if (node.next != SCRIPT_NO_NODE)
+        m_nodes[node.next].prev = node.prev;
+    else
+        m_slotTail[slot] = node.prev;
+
+    if (node.action.sourceGUID)
+    {
+        SourceIndex::iterator itr = m_bySource.find(node.action.sourceGUID);
+        if (itr != m_bySource.end())
+        {
+            std::vector<uint32>& nodes = itr->second;
+            std::vector<uint32>::iterator pos = std::find(nodes.begin(), nodes.end(), index);
+            if (pos != nodes.end())
+            {
+                *pos = nodes.back();
+                nodes.pop_back();
+            }
+
+            if (nodes.empty())
+                m_bySource.erase(itr);
+        }
+    }
+
+    node.overdue = false;
+    m_freeNodes.push_back(index);
+    --m_stats.queued;
+}
+
+struct ScriptNodeDueOrder
+{
+    ScriptNodeDueOrder(std::vector<uint32> const& due, uint32 now) : m_due(due), m_now(now) {}
+
+    bool operator()(uint32 left, uint32 right) const
+    {
+        return int32(m_due[left] - m_now) < int32(m_due[right] - m_now);
+    }
+
+    std::vector<uint32> const& m_due;
+    uint32 m_now;
+};
+
+// slots hold actions of many due times by now, take all due ones out of the wheel order
+void ScriptScheduler::CollectOverdue(uint32 now)
+{
+    m_overdue.clear();
+    m_overduePos = 0;
+
+    std::vector<uint32> due(m_nodes.size());
+    for (uint32 slot = 0; slot < SCRIPT_WHEEL_SLOTS; ++slot)
+    {
+        for (uint32 index = m_slotHead[slot]; index != SCRIPT_NO_NODE; index = m_nodes[index].next)
+        {
+            if (int32(m_nodes[index].due - now) > 0)
+                continue;
+
+            m_nodes[index].overdue = true;
+            m_overdue.push_back(index);
+            due[index] = m_nodes[index].due;
+        }
+    }
+
+    // actions of same due time share the slot and were collected in order they were scheduled
+    std::stable_sort(m_overdue.begin(), m_overdue.end(), ScriptNodeDueOrder(due, now));
+
+    // everything due at now is taken, actions scheduled from now on go to open slot of now
+    m_current = now;
+}
+
+bool ScriptScheduler::PopDue(uint32 now, ScriptAction& action)
+{
+    if (empty())
+    {
+        m_current = now;
+        m_overdue.clear();
+        m_overduePos = 0;
+        return false;
+    }
+
+    // after long pause wheel order is not due order
+    if (m_overduePos == m_overdue.size() && now - m_current >= SCRIPT_WHEEL_SLOTS)
+        CollectOverdue(now);
+
+    while (m_overduePos < m_overdue.size())
+    {
+        uint32 index = m_overdue[m_overduePos++];
+        if (!m_nodes[index].overdue)                        // cancelled meanwhile
+            continue;
+
+        action = m_nodes[index].action;
+        Unlink(index);
+        ++m_stats.executed;
+        return true;
+    }
+
+    while (true)
+    {
+        uint32 slot = m_current & (SCRIPT_WHEEL_SLOTS - 1);
+        for (uint32 index = m_slotHead[slot]; index != SCRIPT_NO_NODE; index = m_nodes[index].next)
+        {
+            if (int32(m_nodes[index].due - now) > 0)
+                continue;
+
+            action = m_nodes[index].action;
+            Unlink(index);
+            ++m_stats.executed;
+            return true;
+        }
+
+        // current slot stays open, actions scheduled without delay go there
+        if (m_current == now)
+            return false;
+
+        ++m_current;
+    }
+}
+
+uint32 ScriptScheduler::CancelBySource(uint64 sourceGUID, bool (*filter)(ScriptAction const&))
+{
+    SourceIndex::iterator itr = m_bySource.find(sourceGUID);
+    if (itr == m_bySource.end())
+        return 0;
+
+    std::vector<uint32> nodes;
+    if (filter)
+    {
+        for (std::vector<uint32>::const_iterator node = itr->second.begin(); node != itr->second.end(); ++node)
+            if (filter(m_nodes[*node].action))
+                nodes.push_back(*node);
+    }
+    else
+        nodes = itr->second;
+
+    // Unlink() updates the index
+    for (std::vector<uint32>::const_iterator node = nodes.begin(); node != nodes.end(); ++node)
+        Unlink(*node);
+
+    m_stats.cancelled += nodes.size();
+    return nodes.size();
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2005-2009 MaNGOS <http://getmangos.com/>
+ *
+ * Copyright (C) 2008-2009 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOOKING4GROUP_SCRIPTSCHEDULER_H
+#define LOOKING4GROUP_SCRIPTSCHEDULER_H
+
+#include "Common.h"
+#include "Utilities/UnorderedMap.h"
+
+#include <vector>
+
+struct ScriptInfo;
+
+struct ScriptAction
+{
+    uint64 sourceGUID;
+    uint64 targetGUID;
+    uint64 ownerGUID;                                       // owner of source if source is item
+    ScriptInfo const* script;                               // pointer to static script data
+};
+
+#define SCRIPT_WHEEL_SLOTS      1024                        // one slot per millisecond, must be power of 2
+#define SCRIPT_NO_NODE          0xFFFFFFFF
+
+struct ScriptSchedulerStats
+{
+    ScriptSchedulerStats() : queued(0), peak(0), scheduled(0), executed(0), cancelled(0) {}
+
+    uint32 queued;                                          // actions waiting now
+    uint32 peak;                                            // most actions waiting at once
+    uint64 scheduled;
+    uint64 executed;
+    uint64 cancelled;
+};
+
+/// Timing wheel of delayed script actions of one map, used only from map update thread.
+/// Actions are kept in pooled nodes linked into the slot of their millisecond; actions
+/// due later than one wheel turn stay in their slot and are skipped until due.
+/// Actions run in order of due time, actions of same due time in order they were scheduled,
+/// also after a pause longer than one wheel turn.
+/// Nodes are reused, but the per-source index allocates a vector for every source with
+/// waiting actions.
+class ScriptScheduler
+{
+    public:
+        ScriptScheduler();
+
+        void Schedule(ScriptAction const& action, uint32 delay, uint32 now);
+
+        // take next action due at now, false if there is none
+        bool PopDue(uint32 now, ScriptAction& action);
+
+        // drop waiting actions of source, filter selects which of them
+        uint32 CancelBySource(uint64 sourceGUID, bool (*filter)(ScriptAction const&) = NULL);
+
+        bool empty() const { return m_stats.queued == 0; }
+        uint32 size() const { return m_stats.queued; }
+
+        ScriptSchedulerStats const& GetStats() const { return m_stats; }
+
+    private:
+        struct Node
+        {
+            ScriptAction action;
+            uint32 due;
+            uint32 prev;
+            uint32 next;
+            bool overdue;                                   // listed in m_overdue
+        };
+
+        void CollectOverdue(uint32 now);
+
+        void Unlink(uint32 index);
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32> m_freeNodes;
+
+        uint32 m_slotHead[SCRIPT_WHEEL_SLOTS];
+        uint32 m_slotTail[SCRIPT_WHEEL_SLOTS];
+        uint32 m_current;                                   // first slot time not fully processed
+
+        // actions found due after a pause longer than one wheel turn, in due order
+        std::vector<uint32> m_overdue;
+        uint32 m_overduePos;
+
+        typedef UNORDERED_MAP<uint64, std::vector<uint32> > SourceIndex;
+        SourceIndex m_bySource;
+
+        ScriptSchedulerStats m_stats;
+};
+
+#endif
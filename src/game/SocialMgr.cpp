@@ -33,6 +33,7 @@
 PlayerSocial::PlayerSocial()
 {
     m_playerGUID = 0;
+    memset(m_ignoreFilter, 0, sizeof(m_ignoreFilter));
 }
 
 PlayerSocial::~PlayerSocial()
@@ -82,6 +83,10 @@ bool PlayerSocial::AddToSocialList(uint32 friend_guid, bool ignore)
         fi.Flags |= flag;
         m_playerSocialMap[friend_guid] = fi;
     }
+
+    if (ignore)
+        UpdateIgnoreFilter();
+
     return true;
 }
 
@@ -105,6 +110,9 @@ void PlayerSocial::RemoveFromSocialList(uint32 friend_guid, bool ignore)
     {
         RealmDataDatabase.PExecute("UPDATE character_social SET flags = (flags & ~%u) WHERE guid = '%u' AND friend = '%u'", flag, GetPlayerGUID(), friend_guid);
     }
+
+    if (ignore)
+        UpdateIgnoreFilter();
 }
 
 void PlayerSocial::SetFriendNote(uint32 friend_guid, std::string note)
@@ -163,8 +171,39 @@ bool PlayerSocial::HasFriend(uint32 friend_guid)
     return false;
 }
 
+static inline uint32 IgnoreFilterBit(uint32 guid, uint32 seed)
+{
+    return ((guid ^ seed) * 2654435761U >> 24) % SOCIALMGR_IGNORE_FILTER_BITS;
+}
+
+void PlayerSocial::UpdateIgnoreFilter()
+{
+    memset(m_ignoreFilter, 0, sizeof(m_ignoreFilter));
+
+    for (PlayerSocialMap::const_iterator itr = m_playerSocialMap.begin(); itr != m_playerSocialMap.end(); ++itr)
+    {
+        if (!(itr->second.Flags & SOCIAL_FLAG_IGNORED))
+            continue;
+
+        uint32 bit1 = IgnoreFilterBit(itr->first, 0);
+        uint32 bit2 = IgnoreFilterBit(itr->first, 0x5BD1E995);
+        m_ignoreFilter[bit1 / 32] |= 1U << (bit1 % 32);
+        m_ignoreFilter[bit2 / 32] |= 1U << (bit2 % 32);
+    }
+}
+
+bool PlayerSocial::MayIgnore(uint32 ignore_guid) const
+{
+    uint32 bit1 = IgnoreFilterBit(ignore_guid, 0);
+    uint32 bit2 = IgnoreFilterBit(ignore_guid, 0x5BD1E995);
+    return (m_ignoreFilter[bit1 / 32] & (1U << (bit1 % 32))) && (m_ignoreFilter[bit2 / 32] & (1U << (bit2 % 32)));
+}
+
 bool PlayerSocial::HasIgnore(uint32 ignore_guid)
 {
+    if (!MayIgnore(ignore_guid))
+        return false;
+
     PlayerSocialMap::iterator itr = m_playerSocialMap.find(ignore_guid);
     if (itr != m_playerSocialMap.end())
         return itr->second.Flags & SOCIAL_FLAG_IGNORED;
@@ -332,6 +371,8 @@ PlayerSocial *SocialMgr::LoadFromDB(QueryResultAutoPtr result, uint32 guid)
             break;
     }
     while (result->NextRow());
+
+    social->UpdateIgnoreFilter();
     return social;
 }
 
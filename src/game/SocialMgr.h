@@ -115,6 +115,8 @@ enum FriendsResult
 #define SOCIALMGR_FRIEND_LIMIT  50
 #define SOCIALMGR_IGNORE_LIMIT  25
 
+#define SOCIALMGR_IGNORE_FILTER_BITS    256                 // 25 ignores with 2 hashes give ~3% false positives
+
 class PlayerSocial
 {
     friend class SocialMgr;
@@ -134,8 +136,13 @@ class PlayerSocial
         void SetPlayerGUID(uint32 guid) { m_playerGUID = guid; }
         uint32 GetNumberOfSocialsWithFlag(SocialFlag flag);
     private:
+        // bloom filter of ignored guids, most HasIgnore calls (channel and chat fan-out) end here
+        void UpdateIgnoreFilter();
+        bool MayIgnore(uint32 ignore_guid) const;
+
         PlayerSocialMap m_playerSocialMap;
         uint32 m_playerGUID;
+        uint32 m_ignoreFilter[SOCIALMGR_IGNORE_FILTER_BITS / 32];
 };
 
 class SocialMgr
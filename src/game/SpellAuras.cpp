@@ -2336,7 +2336,8 @@ void Aura::TriggerSpell()
             {
                 if (caster->CanHaveThreatList())
                 {
-                    std::list<HostilReference*>& m_threatlist = caster->getThreatManager().getThreatList();
+                    // copy, erasing from the real threat list would leave its index stale
+                    std::list<HostilReference*> m_threatlist(caster->getThreatManager().getThreatList());
                     std::list<HostilReference*>::iterator i = m_threatlist.begin();
                     while (m_threatlist.size())
                     {
@@ -36,6 +36,9 @@ bool Player::UpdateStats(Stats stat)
     if (stat > STAT_SPIRIT)
         return false;
 
+    // dependent values requested several times below (attack power for agility etc.) are recalculated once
+    PlayerStatUpdateBatch batch(this);
+
     // value = ((base_value * base_pct) + total_value) * total_pct
     float value  = GetTotalStatValue(stat);
 
@@ -85,6 +88,9 @@ bool Player::UpdateStats(Stats stat)
 
 void Player::UpdateSpellDamageAndHealingBonus()
 {
+    if (DeferStatUpdate(PLAYER_STAT_UPDATE_SPELL_BONUS))
+        return;
+
     // Magic damage modifiers implemented in Unit::SpellDamageBonus
     // This information for client side use only
     // Get healing bonus for all schools
@@ -96,6 +102,8 @@ void Player::UpdateSpellDamageAndHealingBonus()
 
 bool Player::UpdateAllStats()
 {
+    PlayerStatUpdateBatch batch(this);
+
     for (int i = STAT_STRENGTH; i < MAX_STATS; i++)
     {
         float value = GetTotalStatValue(Stats(i));
@@ -128,6 +136,9 @@ void Player::UpdateResistances(uint32 school)
 {
     if (school > SPELL_SCHOOL_NORMAL)
     {
+        if (DeferStatUpdate(PLAYER_STAT_UPDATE_RESISTANCE_HOLY << (school - SPELL_SCHOOL_HOLY)))
+            return;
+
         float value  = GetTotalAuraModValue(UnitMods(UNIT_MOD_RESISTANCE_START + school));
         SetResistance(SpellSchools(school), int32(value));
 
@@ -141,6 +152,9 @@ void Player::UpdateResistances(uint32 school)
 
 void Player::UpdateArmor()
 {
+    if (DeferStatUpdate(PLAYER_STAT_UPDATE_ARMOR))
+        return;
+
     float value = 0.0f;
     UnitMods unitMod = UNIT_MOD_ARMOR;
 
@@ -225,6 +239,9 @@ void Player::UpdateMaxPower(Powers power)
 
 void Player::UpdateAttackPowerAndDamage(bool ranged)
 {
+    if (DeferStatUpdate(ranged ? PLAYER_STAT_UPDATE_RANGED_ATTACK_POWER : PLAYER_STAT_UPDATE_ATTACK_POWER))
+        return;
+
     float val2 = 0.0f;
     float level = float(getLevel());
 
@@ -353,6 +370,9 @@ void Player::UpdateAttackPowerAndDamage(bool ranged)
 
 void Player::UpdateShieldBlockValue()
 {
+    if (DeferStatUpdate(PLAYER_STAT_UPDATE_SHIELD_BLOCK))
+        return;
+
     SetUInt32Value(PLAYER_SHIELD_BLOCK, GetShieldBlockValue());
 }
 
@@ -419,6 +439,23 @@ void Player::CalculateMinMaxDamage(WeaponAttackType attType, bool normalized, fl
 
 void Player::UpdateDamagePhysical(WeaponAttackType attType)
 {
+    switch (attType)
+    {
+        case BASE_ATTACK:
+        default:
+            if (DeferStatUpdate(PLAYER_STAT_UPDATE_DAMAGE_MAINHAND))
+                return;
+            break;
+        case OFF_ATTACK:
+            if (DeferStatUpdate(PLAYER_STAT_UPDATE_DAMAGE_OFFHAND))
+                return;
+            break;
+        case RANGED_ATTACK:
+            if (DeferStatUpdate(PLAYER_STAT_UPDATE_DAMAGE_RANGED))
+                return;
+            break;
+    }
+
     float mindamage;
     float maxdamage;
 
@@ -451,6 +488,9 @@ void Player::UpdateDefenseBonusesMod()
 
 void Player::UpdateBlockPercentage()
 {
+    if (DeferStatUpdate(PLAYER_STAT_UPDATE_BLOCK))
+        return;
+
     // No block
     float value = 0.0f;
     if (CanBlock())
@@ -473,6 +513,7 @@ void Player::UpdateCritPercentage(WeaponAttackType attType)
     BaseModGroup modGroup;
     uint16 index;
     CombatRating cr;
+    uint32 updateFlag;
 
     switch (attType)
     {
@@ -480,20 +521,26 @@ void Player::UpdateCritPercentage(WeaponAttackType attType)
             modGroup = OFFHAND_CRIT_PERCENTAGE;
             index = PLAYER_OFFHAND_CRIT_PERCENTAGE;
             cr = CR_CRIT_MELEE;
+            updateFlag = PLAYER_STAT_UPDATE_CRIT_OFFHAND;
             break;
         case RANGED_ATTACK:
             modGroup = RANGED_CRIT_PERCENTAGE;
             index = PLAYER_RANGED_CRIT_PERCENTAGE;
             cr = CR_CRIT_RANGED;
+            updateFlag = PLAYER_STAT_UPDATE_CRIT_RANGED;
             break;
         case BASE_ATTACK:
         default:
             modGroup = CRIT_PERCENTAGE;
             index = PLAYER_CRIT_PERCENTAGE;
             cr = CR_CRIT_MELEE;
+            updateFlag = PLAYER_STAT_UPDATE_CRIT_MAINHAND;
             break;
     }
 
+    if (DeferStatUpdate(updateFlag))
+        return;
+
     float value = GetTotalPercentageModValue(modGroup) + GetRatingBonusValue(cr);
     // Modify crit from weapon skill and maximized defense skill of same level victim difference
     value += (int32(GetWeaponSkillValue(attType)) - int32(GetMaxSkillValueForLevel())) * 0.04f;
@@ -503,6 +550,9 @@ void Player::UpdateCritPercentage(WeaponAttackType attType)
 
 void Player::UpdateAllCritPercentages()
 {
+    if (DeferStatUpdate(PLAYER_STAT_UPDATE_CRIT_FROM_AGILITY))
+        return;
+
     float value = GetMeleeCritFromAgility();
 
     SetBaseModValue(CRIT_PERCENTAGE, PCT_MOD, value);
@@ -516,6 +566,9 @@ void Player::UpdateAllCritPercentages()
 
 void Player::UpdateParryPercentage()
 {
+    if (DeferStatUpdate(PLAYER_STAT_UPDATE_PARRY))
+        return;
+
     // No parry
     float value = 0.0f;
     if (CanParry())
@@ -535,6 +588,9 @@ void Player::UpdateParryPercentage()
 
 void Player::UpdateDodgePercentage()
 {
+    if (DeferStatUpdate(PLAYER_STAT_UPDATE_DODGE))
+        return;
+
     // Dodge from agility
     float value = GetDodgeFromAgility();
     // Modify value from defense skill
@@ -549,6 +605,9 @@ void Player::UpdateDodgePercentage()
 
 void Player::UpdateSpellCritChance(uint32 school)
 {
+    if (DeferStatUpdate(PLAYER_STAT_UPDATE_SPELL_CRIT_NORMAL << school))
+        return;
+
     // For normal school set zero crit chance
     if (school == SPELL_SCHOOL_NORMAL)
     {
@@ -581,6 +640,9 @@ void Player::UpdateExpertise(WeaponAttackType attack)
     if (attack==RANGED_ATTACK)
         return;
 
+    if (DeferStatUpdate(attack == BASE_ATTACK ? PLAYER_STAT_UPDATE_EXPERTISE_MAINHAND : PLAYER_STAT_UPDATE_EXPERTISE_OFFHAND))
+        return;
+
     int32 expertise = int32(GetRatingBonusValue(CR_EXPERTISE));
 
     Item *weapon = GetWeaponForAttack(attack);
@@ -609,6 +671,9 @@ void Player::UpdateExpertise(WeaponAttackType attack)
 
 void Player::UpdateManaRegen()
 {
+    if (DeferStatUpdate(PLAYER_STAT_UPDATE_MANA_REGEN))
+        return;
+
     float Intellect = GetStat(STAT_INTELLECT);
     // Mana regen from spirit and intellect
     float power_regen = sqrt(Intellect) * OCTRegenMPPerSpirit();
@@ -645,6 +710,91 @@ void Player::UpdateManaRegen()
     SetStatFloatValue(PLAYER_FIELD_MOD_MANA_REGEN, power_regen_mp5 + power_regen);
 }
 
+bool Player::DeferStatUpdate(uint32 flag)
+{
+    if (m_statUpdateBatchDepth)
+    {
+        if (m_statUpdateMask & flag)
+            ++m_statUpdateCounters.avoided;
+
+        m_statUpdateMask |= flag;
+        return true;
+    }
+
+    // recalculated now, drop pending request for the same value
+    m_statUpdateMask &= ~flag;
+    ++m_statUpdateCounters.performed;
+    return false;
+}
+
+void Player::EndStatUpdateBatch()
+{
+    if (!m_statUpdateBatchDepth || --m_statUpdateBatchDepth)
+        return;
+
+    FlushStatUpdates();
+}
+
+void Player::FlushStatUpdates()
+{
+    if (m_statUpdateBatchDepth)
+        return;
+
+    // order follows dependencies: attack power updates weapon damage and
+    // crit from agility updates per attack crit, their flags are dropped there
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_ARMOR)
+        UpdateArmor();
+
+    for (uint32 i = SPELL_SCHOOL_HOLY; i < MAX_SPELL_SCHOOL; ++i)
+        if (m_statUpdateMask & (PLAYER_STAT_UPDATE_RESISTANCE_HOLY << (i - SPELL_SCHOOL_HOLY)))
+            UpdateResistances(i);
+
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_ATTACK_POWER)
+        UpdateAttackPowerAndDamage();
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_RANGED_ATTACK_POWER)
+        UpdateAttackPowerAndDamage(true);
+
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_DAMAGE_MAINHAND)
+        UpdateDamagePhysical(BASE_ATTACK);
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_DAMAGE_OFFHAND)
+        UpdateDamagePhysical(OFF_ATTACK);
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_DAMAGE_RANGED)
+        UpdateDamagePhysical(RANGED_ATTACK);
+
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_CRIT_FROM_AGILITY)
+        UpdateAllCritPercentages();
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_CRIT_MAINHAND)
+        UpdateCritPercentage(BASE_ATTACK);
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_CRIT_OFFHAND)
+        UpdateCritPercentage(OFF_ATTACK);
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_CRIT_RANGED)
+        UpdateCritPercentage(RANGED_ATTACK);
+
+    for (uint32 i = SPELL_SCHOOL_NORMAL; i < MAX_SPELL_SCHOOL; ++i)
+        if (m_statUpdateMask & (PLAYER_STAT_UPDATE_SPELL_CRIT_NORMAL << i))
+            UpdateSpellCritChance(i);
+
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_BLOCK)
+        UpdateBlockPercentage();
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_PARRY)
+        UpdateParryPercentage();
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_DODGE)
+        UpdateDodgePercentage();
+
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_SHIELD_BLOCK)
+        UpdateShieldBlockValue();
+
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_EXPERTISE_MAINHAND)
+        UpdateExpertise(BASE_ATTACK);
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_EXPERTISE_OFFHAND)
+        UpdateExpertise(OFF_ATTACK);
+
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_SPELL_BONUS)
+        UpdateSpellDamageAndHealingBonus();
+    if (m_statUpdateMask & PLAYER_STAT_UPDATE_MANA_REGEN)
+        UpdateManaRegen();
+}
+
 void Player::_ApplyAllStatBonuses()
 {
     SetCanModifyStats(false);
@@ -23,6 +23,7 @@
 #include "Creature.h"
 #include "CreatureAI.h"
 #include "World.h"
+#include "Map.h"
 
 #include "Spell.h"
 
@@ -37,6 +38,9 @@ void TargetedMovementGeneratorMedium<T,D>::_setTargetLocation(T &owner)
     if (!_target.isValid() || !_target->IsInWorld())
         return;
 
+    // queued path update is replaced by this one
+    _pathTicket = 0;
+
     float x, y, z;
     bool targetIsVictim = owner.getVictimGUID() == _target->GetGUID();
 
@@ -79,7 +83,10 @@ void TargetedMovementGeneratorMedium<T,D>::_setTargetLocation(T &owner)
     }
 
     if (!_path)
+    {
         _path = new PathFinder(&owner);
+        _path->setShareCorridors(true);
+    }
     // allow pets following their master to cheat while generating paths
     bool forceDest = (owner.GetObjectGuid().IsPet() && owner.hasUnitState(UNIT_STAT_FOLLOW));
     bool result = _path->calculate(x, y, z, forceDest);
@@ -90,6 +97,7 @@ void TargetedMovementGeneratorMedium<T,D>::_setTargetLocation(T &owner)
             _path->BuildShortcut();
             owner.addUnitState(UNIT_STAT_IGNORE_PATHFINDING);
             _path = new PathFinder(&owner);
+            _path->setShareCorridors(true);
         }
     }
     else if (owner.GetObjectGuid().IsPet())
@@ -107,6 +115,31 @@ void TargetedMovementGeneratorMedium<T,D>::_setTargetLocation(T &owner)
     init.Launch();
 }
 
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T,D>::_requestTargetLocation(T &owner)
+{
+    // without time budget paths are updated in place
+    if (!sWorld.getConfig(CONFIG_PATHFINDING_BATCH_BUDGET))
+    {
+        _setTargetLocation(owner);
+        return;
+    }
+
+    PathService& service = owner.GetMap()->GetPathService();
+    if (!service.IsPending(_pathTicket))
+        _pathTicket = service.QueueRequest(owner.GetGUID());
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T,D>::ProcessPathRequest(Unit &u)
+{
+    T &owner = *((T*)&u);
+    if (!owner.isAlive() || static_cast<D*>(this)->_lostTarget(owner))
+        return;
+
+    _setTargetLocation(owner);
+}
+
 template<>
 void TargetedMovementGeneratorMedium<Player,ChaseMovementGenerator<Player> >::UpdateFinalDistance(float /*fDistance*/)
 {
@@ -176,7 +209,7 @@ bool TargetedMovementGeneratorMedium<T,D>::Update(T &owner, const uint32 & time_
         }
 
         if (targetMoved)
-            _setTargetLocation(owner);
+            _requestTargetLocation(owner);
     }
 
     if (owner.IsStopped())
@@ -355,6 +388,10 @@ template bool TargetedMovementGeneratorMedium<Player,ChaseMovementGenerator<Play
 template bool TargetedMovementGeneratorMedium<Player,FollowMovementGenerator<Player> >::Update(Player &, const uint32 &);
 template bool TargetedMovementGeneratorMedium<Creature,ChaseMovementGenerator<Creature> >::Update(Creature &, const uint32 &);
 template bool TargetedMovementGeneratorMedium<Creature,FollowMovementGenerator<Creature> >::Update(Creature &, const uint32 &);
+template void TargetedMovementGeneratorMedium<Player,ChaseMovementGenerator<Player> >::ProcessPathRequest(Unit &);
+template void TargetedMovementGeneratorMedium<Player,FollowMovementGenerator<Player> >::ProcessPathRequest(Unit &);
+template void TargetedMovementGeneratorMedium<Creature,ChaseMovementGenerator<Creature> >::ProcessPathRequest(Unit &);
+template void TargetedMovementGeneratorMedium<Creature,FollowMovementGenerator<Creature> >::ProcessPathRequest(Unit &);
 
 template void ChaseMovementGenerator<Player>::_reachTarget(Player &);
 template void ChaseMovementGenerator<Creature>::_reachTarget(Creature &);
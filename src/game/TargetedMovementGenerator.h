@@ -45,7 +45,7 @@ class TargetedMovementGeneratorMedium
         TargetedMovementGeneratorMedium(Unit &target, float offset, float angle) :
             TargetedMovementGeneratorBase(target), _offset(offset), _angle(angle),
             _targetReached(false), _recheckDistance(0),
-            _path(NULL)
+            _path(NULL), _pathTicket(0)
         {
         }
         ~TargetedMovementGeneratorMedium() { delete _path; }
@@ -62,8 +62,11 @@ class TargetedMovementGeneratorMedium
 
         void UpdateFinalDistance(float fDistance);
 
+        void ProcessPathRequest(Unit &u);
+
     protected:
         void _setTargetLocation(T &);
+        void _requestTargetLocation(T &);
 
         TimeTracker _recheckDistance;
         float _offset;
@@ -71,6 +74,7 @@ class TargetedMovementGeneratorMedium
         bool _targetReached : 1;
 
         PathFinder* _path;
+        uint32 _pathTicket;                                 // path update queued in map path service
 };
 
 template<class T>
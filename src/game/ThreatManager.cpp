@@ -215,27 +215,93 @@ void ThreatContainer::clearReferences()
         delete (*i);
     }
     iThreatList.clear();
+    iThreatOrder.clear();
+    iThreatIndex.clear();
+}
+
+//============================================================
+
+void ThreatContainer::addReference(HostilReference* pHostilReference)
+{
+    ThreatIndexEntry& entry = iThreatIndex[pHostilReference->getUnitGuid()];
+    entry.listPos = iThreatList.insert(iThreatList.end(), pHostilReference);
+    entry.orderPos = iThreatOrder.insert(ThreatOrderMap::value_type(pHostilReference->getThreat(), pHostilReference));
+
+    // appended to the list, so it stays in order only if the reference is last in threat order too
+    ThreatOrderMap::iterator next = entry.orderPos;
+    if (++next != iThreatOrder.end())
+        iDirty = true;
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostilReference* pRef)
+{
+    ThreatIndexMap::iterator itr = iThreatIndex.find(pRef->getUnitGuid());
+    if (itr == iThreatIndex.end() || *itr->second.listPos != pRef)
+        return;
+
+    iThreatList.erase(itr->second.listPos);
+    iThreatOrder.erase(itr->second.orderPos);
+    iThreatIndex.erase(itr);
+}
+
+//============================================================
+
+void ThreatContainer::updateThreatOrder(HostilReference* pRef)
+{
+    ThreatIndexMap::iterator itr = iThreatIndex.find(pRef->getUnitGuid());
+    if (itr == iThreatIndex.end() || *itr->second.listPos != pRef)
+        return;
+
+    ThreatOrderMap::iterator& orderPos = itr->second.orderPos;
+    if (orderPos->first == pRef->getThreat())
+        return;
+
+    ThreatOrderMap::iterator next = orderPos;
+    ++next;
+
+    HostilReference* oldPrev = NULL;
+    if (orderPos != iThreatOrder.begin())
+    {
+        ThreatOrderMap::iterator prev = orderPos;
+        oldPrev = (--prev)->second;
+    }
+    HostilReference* oldNext = next != iThreatOrder.end() ? next->second : NULL;
+
+    // old position as hint, small threat changes keep most references in place
+    iThreatOrder.erase(orderPos);
+    orderPos = iThreatOrder.insert(next, ThreatOrderMap::value_type(pRef->getThreat(), pRef));
+
+    next = orderPos;
+    ++next;
+
+    HostilReference* newPrev = NULL;
+    if (orderPos != iThreatOrder.begin())
+    {
+        ThreatOrderMap::iterator prev = orderPos;
+        newPrev = (--prev)->second;
+    }
+    HostilReference* newNext = next != iThreatOrder.end() ? next->second : NULL;
+
+    if (oldPrev != newPrev || oldNext != newNext)
+        iDirty = true;
 }
 
 //============================================================
 // Return the HostilReference of NULL, if not found
 HostilReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
 {
-    HostilReference* result = NULL;
     if (!pVictim)
         return NULL;
 
-    uint64 guid = pVictim->GetGUID();
-    for (std::list<HostilReference*>::iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
-    {
-        if ((*i)->getUnitGuid() == guid)
-        {
-            result = (*i);
-            break;
-        }
-    }
+    return getReferenceByGuid(pVictim->GetGUID());
+}
 
-    return result;
+HostilReference* ThreatContainer::getReferenceByGuid(uint64 pGuid)
+{
+    ThreatIndexMap::const_iterator itr = iThreatIndex.find(pGuid);
+    return itr != iThreatIndex.end() ? *itr->second.listPos : NULL;
 }
 
 //============================================================
@@ -274,13 +340,15 @@ bool HostilReferenceSortPredicate(const HostilReference* lhs, const HostilRefere
 }
 
 //============================================================
-// Check if the list is dirty and sort if necessary
+// Check if the list is dirty and reorder if necessary
 
 void ThreatContainer::update()
 {
     if (iDirty && iThreatList.size() >1)
     {
-        iThreatList.sort(HostilReferenceSortPredicate);
+        // move every node to the end in threat order, list iterators stay valid
+        for (ThreatOrderMap::const_iterator itr = iThreatOrder.begin(); itr != iThreatOrder.end(); ++itr)
+            iThreatList.splice(iThreatList.end(), iThreatList, iThreatIndex[itr->second->getUnitGuid()].listPos);
     }
     iDirty = false;
 }
@@ -625,9 +693,11 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
     switch(threatRefStatusChangeEvent->getType())
     {
         case UEV_THREAT_REF_THREAT_CHANGE:
-            if ((getCurrentVictim() == hostilReference && threatRefStatusChangeEvent->getFValue()<0.0f) ||
-                (getCurrentVictim() != hostilReference && threatRefStatusChangeEvent->getFValue()>0.0f))
-                setDirty(true);                             // the order in the threat list might have changed
+            // the container marks itself dirty if the order in the threat list changed
+            if (hostilReference->isOnline())
+                iThreatContainer.updateThreatOrder(hostilReference);
+            else
+                iThreatOfflineContainer.updateThreatOrder(hostilReference);
             break;
         case UEV_THREAT_REF_ONLINE_STATUS:
             if (!hostilReference->isOnline())
@@ -642,8 +712,6 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
             }
             else
             {
-                if (getCurrentVictim() && hostilReference->getThreat() > (1.1f * getCurrentVictim()->getThreat()))
-                    setDirty(true);
                 iThreatContainer.addReference(hostilReference);
                 iThreatOfflineContainer.remove(hostilReference);
             }
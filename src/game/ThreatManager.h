@@ -25,8 +25,11 @@
 #include "SharedDefines.h"
 #include "Utilities/LinkedReference/Reference.h"
 #include "UnitEvents.h"
+#include "Utilities/UnorderedMap.h"
 
 #include <list>
+#include <map>
+#include <functional>
 
 //==============================================================
 
@@ -132,18 +135,35 @@ class LOOKING4GROUP_IMPORT_EXPORT HostilReference : public Reference<Unit, Threa
 //==============================================================
 class ThreatManager;
 
+// The threat list keeps its order between update() calls, so it can be iterated
+// while threat changes. The real order is kept in iThreatOrder, updated for the
+// changed reference only, and update() moves the list nodes into that order.
 class LOOKING4GROUP_IMPORT_EXPORT ThreatContainer
 {
     private:
+        typedef std::multimap<float, HostilReference*, std::greater<float> > ThreatOrderMap;
+
+        struct ThreatIndexEntry
+        {
+            std::list<HostilReference*>::iterator listPos;
+            ThreatOrderMap::iterator orderPos;
+        };
+
+        typedef UNORDERED_MAP<uint64, ThreatIndexEntry> ThreatIndexMap;
+
         std::list<HostilReference*> iThreatList;
+        ThreatOrderMap iThreatOrder;
+        ThreatIndexMap iThreatIndex;                        // unit guid -> positions
         bool iDirty;
     protected:
         friend class ThreatManager;
 
-        void remove(HostilReference* pRef) { iThreatList.remove(pRef); }
-        void addReference(HostilReference* pHostilReference) { iThreatList.push_back(pHostilReference); }
+        void remove(HostilReference* pRef);
+        void addReference(HostilReference* pHostilReference);
         void clearReferences();
-        // Sort the list if necessary
+        // Reposition the reference after its threat changed
+        void updateThreatOrder(HostilReference* pRef);
+        // Bring the list into threat order if necessary
         void update();
     public:
         ThreatContainer() { iDirty = false; }
@@ -164,8 +184,9 @@ class LOOKING4GROUP_IMPORT_EXPORT ThreatContainer
         HostilReference* getMostHated() { return iThreatList.empty() ? NULL : iThreatList.front(); }
 
         HostilReference* getReferenceByTarget(Unit* pVictim);
+        HostilReference* getReferenceByGuid(uint64 pGuid);
 
-        std::list<HostilReference*>& getThreatList() { return iThreatList; }
+        std::list<HostilReference*> const& getThreatList() const { return iThreatList; }
 };
 
 //=================================================
@@ -204,8 +225,8 @@ class LOOKING4GROUP_IMPORT_EXPORT ThreatManager
 
         // methods to access the lists from the outside to do sume dirty manipulation (scriping and such)
         // I hope they are used as little as possible.
-        std::list<HostilReference*>& getThreatList() { return iThreatContainer.getThreatList(); }
-        std::list<HostilReference*>& getOfflieThreatList() { return iThreatOfflineContainer.getThreatList(); }
+        std::list<HostilReference*> const& getThreatList() const { return iThreatContainer.getThreatList(); }
+        std::list<HostilReference*> const& getOfflieThreatList() const { return iThreatOfflineContainer.getThreatList(); }
         ThreatContainer& getOnlineContainer() { return iThreatContainer; }
         ThreatContainer& getOfflineContainer() { return iThreatOfflineContainer; }
 
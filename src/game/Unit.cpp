@@ -151,7 +151,7 @@ bool IsPassiveStackableSpell(uint32 spellId)
 
     for (int j = 0; j < 3; ++j)
     {
-        if (std::find(procAuraTypes.begin(),procAuraTypes.end(),spellProto->EffectApplyAuraName[j])!=procAuraTypes.end())
+        if (procAuraTypes.find(AuraType(spellProto->EffectApplyAuraName[j])) != procAuraTypes.end())
             return false;
     }
 
@@ -4721,6 +4721,8 @@ void Unit::RemoveAura(AuraMap::iterator &i, AuraRemoveMode mode)
 
 void Unit::RemoveAllAuras()
 {
+    PlayerStatUpdateBatch statBatch(this);
+
     while (!m_Auras.empty())
     {
         AuraMap::iterator iter = m_Auras.begin();
@@ -4732,6 +4734,8 @@ void Unit::RemoveArenaAuras(bool onleave)
 {
     // in join, remove positive buffs, on end, remove negative
     // used to remove positive visible auras in arenas
+    PlayerStatUpdateBatch statBatch(this);
+
     for (AuraMap::iterator iter = m_Auras.begin(); iter != m_Auras.end();)
     {
         if (!(iter->second->GetSpellProto()->AttributesEx4 & (1<<21)) // don't remove stances, shadowform, pally/hunter auras
@@ -4749,6 +4753,8 @@ void Unit::RemoveAllAurasOnDeath()
 {
     // used just after dieing to remove all visible auras
     // and disable the mods for the passive ones
+    PlayerStatUpdateBatch statBatch(this);
+
     for (AuraMap::iterator iter = m_Auras.begin(); iter != m_Auras.end();)
     {
         if (!iter->second->IsPassive() && !iter->second->IsDeathPersistent())
@@ -32,6 +32,7 @@
 #include "FollowerReference.h"
 #include "FollowerRefManager.h"
 #include "Utilities/EventProcessor.h"
+#include "Utilities/FlatContainers.h"
 #include "StateMgr.h"
 #include "MotionMaster.h"
 #include "DBCStructure.h"
@@ -831,13 +832,13 @@ struct SpellProcEventEntry;                                 // used only private
 class LOOKING4GROUP_IMPORT_EXPORT Unit : public WorldObject
 {
     public:
-        typedef std::set<Unit*> AttackerSet;
+        typedef FlatSet<Unit*, 8> AttackerSet;
         typedef std::pair<uint32, uint8> spellEffectPair;
         typedef std::multimap< spellEffectPair, Aura*> AuraMap;
         typedef std::list<Aura *> AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
-        typedef std::set<AuraType> AuraTypeSet;
-        typedef std::set<uint32> ComboPointHolderSet;
+        typedef FlatSet<AuraType, 16> AuraTypeSet;
+        typedef FlatSet<uint32, 4> ComboPointHolderSet;
 
         virtual ~Unit ();
 
@@ -885,15 +886,11 @@ class LOOKING4GROUP_IMPORT_EXPORT Unit : public WorldObject
 
         void _addAttacker(Unit *pAttacker)                  // must be called only from Unit::Attack(Unit*)
         {
-            AttackerSet::iterator itr = m_attackers.find(pAttacker);
-            if (itr == m_attackers.end())
-                m_attackers.insert(pAttacker);
+            m_attackers.insert(pAttacker);
         }
         void _removeAttacker(Unit *pAttacker)               // must be called only from Unit::AttackStop()
         {
-            AttackerSet::iterator itr = m_attackers.find(pAttacker);
-            if (itr != m_attackers.end())
-                m_attackers.erase(itr);
+            m_attackers.erase(pAttacker);
         }
         Unit * getAttackerForHelper()                       // If someone wants to help, who to give them
         {
@@ -1655,7 +1652,7 @@ class LOOKING4GROUP_IMPORT_EXPORT Unit : public WorldObject
         AuraMap::iterator m_AurasUpdateIterator;
         uint32 m_removedAurasCount;
 
-        typedef std::list<uint64> DynObjectGUIDs;
+        typedef SmallVector<uint64, 4> DynObjectGUIDs;
         DynObjectGUIDs m_dynObjGUIDs;
 
         typedef std::list<GameObject*> GameObjectList;
@@ -67,7 +67,9 @@
 #include "WardenDataStorage.h"
 #include "WorldEventProcessor.h"
 #include "GuildMgr.h"
+#include "WorldLoader.h"
 #include "Guild.h"
+#include "Mail.h"
 
 //#include "Timer.h"
 
@@ -632,6 +634,10 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
        sMapMgr.SetGridCleanUpDelay(m_configs[CONFIG_INTERVAL_GRIDCLEAN]);
 
+    m_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD] = sConfig.GetIntDefault("GridPreloadLookAhead", 0);
+    if (reload && m_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD])
+        sTerrainMgr.ActivatePreloader();
+
     m_configs[CONFIG_BATTLEGROUND_ANNOUNCE_START] = sConfig.GetIntDefault("BattleGround.AnnounceStart", 0);
     m_configs[CONFIG_BATTLEGROUND_QUEUE_INFO] = sConfig.GetIntDefault("BattleGround.QueueInfo", 0);
     m_configs[CONFIG_BATTLEGROUND_TIMER_INFO] = sConfig.GetBoolDefault("BattleGround.TimerInfo");
@@ -1047,6 +1053,8 @@ void World::LoadConfigSettings(bool reload)
         sLog.outString("Using DataDir %s",m_dataPath.c_str());
     }
 
+    SQLStorageSnapshot::SetDirectory(sConfig.GetStringDefault("StaticDataSnapshotDir", ""));
+
     m_configs[CONFIG_VMAP_LOS_ENABLED] = sConfig.GetIntDefault("vmap.enableLOS", true);
     sLog.outString("WORLD: vmap los %sabled", getConfig(CONFIG_VMAP_LOS_ENABLED) ? "en" : "dis");
 
@@ -1087,6 +1095,15 @@ void World::LoadConfigSettings(bool reload)
 
     m_configs[CONFIG_MAPUPDATE_MAXVISITORS] = sConfig.GetIntDefault("MapUpdate.UpdateVisitorsMax", 0);
 
+    m_configs[CONFIG_CREATURE_UPDATE_NEAR_DISTANCE] = sConfig.GetIntDefault("MapUpdate.CreatureNearDistance", 0);
+    m_configs[CONFIG_CREATURE_UPDATE_FAR_RATE] = sConfig.GetIntDefault("MapUpdate.CreatureFarRate", 4);
+    if (m_configs[CONFIG_CREATURE_UPDATE_FAR_RATE] < 1)
+        m_configs[CONFIG_CREATURE_UPDATE_FAR_RATE] = 1;
+
+    m_configs[CONFIG_CREATURE_UPDATE_EDGE_RATE] = sConfig.GetIntDefault("MapUpdate.CreatureEdgeRate", 10);
+    if (m_configs[CONFIG_CREATURE_UPDATE_EDGE_RATE] < m_configs[CONFIG_CREATURE_UPDATE_FAR_RATE])
+        m_configs[CONFIG_CREATURE_UPDATE_EDGE_RATE] = m_configs[CONFIG_CREATURE_UPDATE_FAR_RATE];
+
     std::string forbiddenmaps = sConfig.GetStringDefault("ForbiddenMaps", "");
     char * forbiddenMaps = new char[forbiddenmaps.length() + 1];
     forbiddenMaps[forbiddenmaps.length()] = 0;
@@ -1148,6 +1165,9 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_MMAP_ENABLED] = sConfig.GetIntDefault("mmap.enabled", true);
     sLog.outString("WORLD: mmap pathfinding %sabled", getConfig(CONFIG_MMAP_ENABLED) ? "en" : "dis");
 
+    m_configs[CONFIG_PATHFINDING_BATCH_BUDGET] = sConfig.GetIntDefault("mmap.batchBudget", 0);
+    m_configs[CONFIG_PATHFINDING_CACHE_LIFETIME] = sConfig.GetIntDefault("mmap.corridorCacheTime", 2000);
+
     m_configs[CONFIG_COREBALANCER_ENABLED] = sConfig.GetBoolDefault("CoreBalancer.Enable", false);
     m_configs[CONFIG_COREBALANCER_PLAYABLE_DIFF] = sConfig.GetIntDefault("CoreBalancer.PlayableDiff", 200);
     m_configs[CONFIG_COREBALANCER_INTERVAL] = sConfig.GetIntDefault("CoreBalancer.BalanceInterval", 300000);
@@ -1157,79 +1177,19 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_DAILY_MAX_PER_DAY] = sConfig.GetIntDefault("DailyQuest.MaxPerDay", 25);
 
     m_configs[CONFIG_CREATURE_RESTORE_STATE] = sConfig.GetIntDefault("Creature.RestoreStateTimer", 5000);
+
+    m_configs[CONFIG_STARTUP_LOADER_THREADS] = sConfig.GetIntDefault("StartupLoader.Threads", 1);
 }
 
-/// Initialize the World
-void World::SetInitialWorldSettings()
+void World::LoadDBCData()
 {
-    ///- Initialize the random number generator
-    srand((unsigned int)time(NULL));
-
-    dtAllocSetCustom(dtCustomAlloc, dtCustomFree);
-
-    ///- Initialize config settings
-    LoadConfigSettings();
-
-    ///- Init highest guids before any table loading to prevent using not initialized guids in some code.
-    sObjectMgr.SetHighestGuids();
-
-    ///- Check the existence of the map files for all races' startup areas.
-    if ( !MapManager::ExistMapAndVMap(0,-6240.32f, 331.033f)
-        ||!MapManager::ExistMapAndVMap(0,-8949.95f,-132.493f)
-        ||!MapManager::ExistMapAndVMap(0,-8949.95f,-132.493f)
-        ||!MapManager::ExistMapAndVMap(1,-618.518f,-4251.67f)
-        ||!MapManager::ExistMapAndVMap(0, 1676.35f, 1677.45f)
-        ||!MapManager::ExistMapAndVMap(1, 10311.3f, 832.463f)
-        ||!MapManager::ExistMapAndVMap(1,-2917.58f,-257.98f)
-        ||m_configs[CONFIG_EXPANSION] && (
-        !MapManager::ExistMapAndVMap(530,10349.6f,-6357.29f) || !MapManager::ExistMapAndVMap(530,-3961.64f,-13931.2f)))
-    {
-        sLog.outLog(LOG_DEFAULT, "ERROR: Correct *.map files not found in path '%smaps' or *.vmap/*vmdir files in '%svmaps'. Please place *.map/*.vmap/*.vmdir files in appropriate directories or correct the DataDir value in the Trinityd.conf file.",m_dataPath.c_str(),m_dataPath.c_str());
-        exit(1);
-    }
-
-    ///- Loading strings. Getting no records means core load has to be canceled because no error message can be output.
-    sLog.outString("");
-    sLog.outString("Loading Looking4group strings...");
-    if (!sObjectMgr.LoadLooking4groupStrings())
-        exit(1);                                            // Error message displayed in function already
-
-    ///- Update the realm entry in the database with the realm type from the config file
-    //No SQL injection as values are treated as integers
-
-    // not send custom type REALM_FFA_PVP to realm list
-    uint32 server_type = IsFFAPvPRealm() ? REALM_TYPE_PVP : getConfig(CONFIG_GAME_TYPE);
-    uint32 realm_zone = getConfig(CONFIG_REALM_ZONE);
-    AccountsDatabase.PExecute("UPDATE realms SET icon = %u, timezone = %u WHERE realm_id = '%u'", server_type, realm_zone, realmID);
-
-    ///- Remove the bones after a restart
-    RealmDataDatabase.PExecute("DELETE FROM corpse WHERE corpse_type = '0'");
-
-    ///- Load the DBC files
-    sLog.outString("Initialize data stores...");
     LoadDBCStores(m_dataPath);
     DetectDBCLang();
+}
 
-    sLog.outString("Loading Terrain specific data...");
-    sTerrainMgr.LoadTerrainSpecifics();
-
-    sLog.outString("Loading Script Names...");
-    sScriptMgr.LoadScriptNames();
-
-    sLog.outString("Loading InstanceTemplate");
-    sObjectMgr.LoadInstanceTemplate();
-
-    sLog.outString("Loading SkillLineAbilityMultiMap Data...");
-    sSpellMgr.LoadSkillLineAbilityMap();
-
-    ///- Clean up and pack instances
-    sLog.outString("Cleaning up instances...");
-    sInstanceSaveManager.CleanupInstances();                              // must be called before `creature_respawn`/`gameobject_respawn` tables
-
-    //sLog.outString("Packing instances...");
-    //sInstanceSaveManager.PackInstances();
-
-    sLog.outString("Loading Localization strings...");
+// grouped startup loaders, steps inside one group depend on each other
+static void LoadLocalizationStrings()
+{
     sObjectMgr.LoadCreatureLocales();
     sObjectMgr.LoadGameObjectLocales();
     sObjectMgr.LoadItemLocales();
@@ -1237,14 +1197,11 @@ void World::SetInitialWorldSettings()
     sObjectMgr.LoadNpcTextLocales();
     sObjectMgr.LoadPageTextLocales();
     sObjectMgr.LoadNpcOptionLocales();
-    sObjectMgr.SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
-
-    sLog.outString("Loading Page Texts...");
-    sObjectMgr.LoadPageTexts();
-
-    sLog.outString("Loading Game Object Templates...");   // must be after LoadPageTexts
-    sObjectMgr.LoadGameobjectInfo();
+    sObjectMgr.SetDBCLocaleIndex(sWorld.GetDefaultDbcLocale());   // Get once for all the locale index of DBC language (console/broadcasts)
+}
 
+static void LoadSpellData()
+{
     sLog.outString("Loading Spell Chain Data...");
     sSpellMgr.LoadSpellChains();
 
@@ -1266,36 +1223,12 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Aggro Spells Definitions...");
     sSpellMgr.LoadSpellThreats();
 
-    sLog.outString("Loading Unqueued Account List...");
-    sObjectMgr.LoadUnqueuedAccountList();
-
-    sLog.outString("Loading NPC Texts...");
-    sObjectMgr.LoadGossipText();
-
     sLog.outString("Loading Enchant Spells Proc datas...");
     sSpellMgr.LoadSpellEnchantProcData();
+}
 
-    sLog.outString("Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
-
-    sLog.outString("Loading Items...");                   // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr.LoadItemPrototypes();
-
-    sLog.outString("Loading Item Texts...");
-    sObjectMgr.LoadItemTexts();
-
-    sLog.outString("Loading Creature Model Based Info Data...");
-    sObjectMgr.LoadCreatureModelInfo();
-
-    sLog.outString("Loading Equipment templates...");
-    sObjectMgr.LoadEquipmentTemplates();
-
-    sLog.outString("Loading Creature templates...");
-    sObjectMgr.LoadCreatureTemplates();
-
-    sLog.outString("Loading SpellsScriptTarget...");
-    sSpellMgr.LoadSpellScriptTarget();                       // must be after LoadCreatureTemplates and LoadGameobjectInfo
-
+static void LoadReputationData()
+{
     sLog.outString( "Loading Reputation Reward Rates...");
     sObjectMgr.LoadReputationRewardRate();
 
@@ -1304,10 +1237,10 @@ void World::SetInitialWorldSettings()
 
     sLog.outString( "Loading Reputation Spillover Data..." );
     sObjectMgr.LoadReputationSpilloverTemplate();
+}
 
-    sLog.outString("Loading Pet Create Spells...");
-    sObjectMgr.LoadPetCreateSpells();
-
+static void LoadWorldObjects()
+{
     sLog.outString("Loading Creature Data...");
     sObjectMgr.LoadCreatures();
 
@@ -1325,22 +1258,10 @@ void World::SetInitialWorldSettings()
 
     sLog.outString("Loading Gameobject Respawn Data..."); // must be after PackInstances()
     sObjectMgr.LoadGameobjectRespawnTimes();
+}
 
-    sLog.outString("Loading Objects Pooling Data...");
-    sPoolMgr.LoadFromDB();
-
-    sLog.outString("Loading Game Event Data...");
-    sGameEventMgr.LoadFromDB();
-
-    sLog.outString("Loading Weather Data...");
-    sObjectMgr.LoadWeatherZoneChances();
-
-    sLog.outString("Loading Quests...");
-    sObjectMgr.LoadQuests();                                    // must be loaded after DBCs, creature_template, item_template, gameobject tables
-
-    sLog.outString("Loading Quests Relations...");
-    sObjectMgr.LoadQuestRelations();                            // must be after quest load
-
+static void LoadAreaTriggerData()
+{
     sLog.outString("Loading AreaTrigger definitions...");
     sObjectMgr.LoadAreaTriggerTeleports();
 
@@ -1355,7 +1276,10 @@ void World::SetInitialWorldSettings()
 
     sLog.outString("Loading AreaTrigger script names...");
     sScriptMgr.LoadAreaTriggerScripts();
+}
 
+static void LoadScriptNameBindings()
+{
     sLog.outString("Loading CompletedCinematic script names...");
     sScriptMgr.LoadCompletedCinematicScripts();
 
@@ -1364,10 +1288,10 @@ void World::SetInitialWorldSettings()
 
     sLog.outString("Loading spell id script names...");
     sScriptMgr.LoadSpellIdScripts();
+}
 
-    sLog.outString("Loading Graveyard-zone links...");
-    sObjectMgr.LoadGraveyardZones();
-
+static void LoadSpellExtraData()
+{
     sLog.outString("Loading Spell target coordinates...");
     sSpellMgr.LoadSpellTargetPositions();
 
@@ -1376,123 +1300,194 @@ void World::SetInitialWorldSettings()
 
     sLog.outString("Loading spell pet auras...");
     sSpellMgr.LoadSpellPetAuras();
+}
 
-    sLog.outString("Loading spell extra attributes...(TODO)");
+static void LoadSpellCustomData()
+{
     sSpellMgr.LoadSpellCustomAttr();
 
     sLog.outString("Loading linked spells...");
     sSpellMgr.LoadSpellLinked();
+}
 
-    sLog.outString("Loading player Create Info & Level Stats...");
-    sObjectMgr.LoadPlayerInfo();
-
-    sLog.outString("Loading Exploration BaseXP Data...");
-    sObjectMgr.LoadExplorationBaseXP();
-
-    sLog.outString("Loading Pet Name Parts...");
-    sObjectMgr.LoadPetNames();
-
-    sLog.outString("Loading the max pet number...");
-    sObjectMgr.LoadPetNumber();
-
-    sLog.outString("Loading pet level stats...");
-    sObjectMgr.LoadPetLevelInfo();
-
-    sLog.outString("Loading Player Corpses...");
-    sObjectMgr.LoadCorpses();
-
-    sLog.outString("Loading Disabled Spells...");
-    sObjectMgr.LoadSpellDisabledEntrys();
-
-    sLog.outString("Loading Loot Tables...");
-    LoadLootTables();
-
-    sLog.outString("Loading Skill Discovery Table...");
-    LoadSkillDiscoveryTable();
-
-    sLog.outString("Loading Skill Extra Item Table...");
-    LoadSkillExtraItemTable();
-
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
-
-    ///- Load dynamic data tables from the database
-    sLog.outString("Loading Auctions...");
+static void LoadAuctionData()
+{
     sAuctionMgr.LoadAuctionItems();
     sAuctionMgr.LoadAuctions();
+}
 
-    sLog.outString("Loading Guilds...");
-    sGuildMgr.LoadGuilds();
+static void ReturnOldMails()
+{
+    sObjectMgr.ReturnOrDeleteOldMails(false);
+}
 
-    sLog.outString("Loading ArenaTeams...");
-    sObjectMgr.LoadArenaTeams();
+static void LoadDbScripts()
+{
+    sScriptMgr.LoadQuestStartScripts();                         // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+    sScriptMgr.LoadQuestEndScripts();                           // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+    sScriptMgr.LoadSpellScripts();                              // must be after load Creature/Gameobject(Template/Data)
+    sScriptMgr.LoadGameObjectScripts();                         // must be after load Creature/Gameobject(Template/Data)
+    sScriptMgr.LoadEventScripts();                              // must be after load Creature/Gameobject(Template/Data)
+    sScriptMgr.LoadWaypointScripts();
+}
 
-    sLog.outString("Loading Groups...");
-    sObjectMgr.LoadGroups();
+static void LoadCreatureEventAITexts()
+{
+    sCreatureEAIMgr.LoadCreatureEventAI_Texts(false);       // false, will checked in LoadCreatureEventAI_Scripts
+}
 
-    sLog.outString("Loading ReservedNames...");
-    sObjectMgr.LoadReservedPlayersNames();
+static void LoadCreatureEventAISummons()
+{
+    sCreatureEAIMgr.LoadCreatureEventAI_Summons(false);     // false, will checked in LoadCreatureEventAI_Scripts
+}
 
-    //sLog.outString("Loading GameObject for quests...");
-    //sObjectMgr.LoadGameObjectForQuests();
+static void LoadCreatureEventAIScripts()
+{
+    sCreatureEAIMgr.LoadCreatureEventAI_Scripts();
+}
 
-    sLog.outString("Loading BattleMasters...");
-    sBattleGroundMgr.LoadBattleMastersEntry();
+/// Initialize the World
+void World::SetInitialWorldSettings()
+{
+    ///- Initialize the random number generator
+    srand((unsigned int)time(NULL));
 
-    sLog.outString("Loading GameTeleports...");
-    sObjectMgr.LoadGameTele();
+    dtAllocSetCustom(dtCustomAlloc, dtCustomFree);
 
-    sLog.outString("Loading Npc Text Id...");
-    sObjectMgr.LoadNpcTextId();                                 // must be after load Creature and NpcText
+    ///- Initialize config settings
+    LoadConfigSettings();
 
-    sLog.outString("Loading Npc Options...");
-    sObjectMgr.LoadNpcOptions();
+    ///- Init highest guids before any table loading to prevent using not initialized guids in some code.
+    sObjectMgr.SetHighestGuids();
 
-    sLog.outString("Loading vendors...");
-    sObjectMgr.LoadVendors();                                   // must be after load CreatureTemplate and ItemTemplate
+    ///- Check the existence of the map files for all races' startup areas.
+    if ( !MapManager::ExistMapAndVMap(0,-6240.32f, 331.033f)
+        ||!MapManager::ExistMapAndVMap(0,-8949.95f,-132.493f)
+        ||!MapManager::ExistMapAndVMap(0,-8949.95f,-132.493f)
+        ||!MapManager::ExistMapAndVMap(1,-618.518f,-4251.67f)
+        ||!MapManager::ExistMapAndVMap(0, 1676.35f, 1677.45f)
+        ||!MapManager::ExistMapAndVMap(1, 10311.3f, 832.463f)
+        ||!MapManager::ExistMapAndVMap(1,-2917.58f,-257.98f)
+        ||m_configs[CONFIG_EXPANSION] && (
+        !MapManager::ExistMapAndVMap(530,10349.6f,-6357.29f) || !MapManager::ExistMapAndVMap(530,-3961.64f,-13931.2f)))
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: Correct *.map files not found in path '%smaps' or *.vmap/*vmdir files in '%svmaps'. Please place *.map/*.vmap/*.vmdir files in appropriate directories or correct the DataDir value in the Trinityd.conf file.",m_dataPath.c_str(),m_dataPath.c_str());
+        exit(1);
+    }
 
-    sLog.outString("Loading trainers...");
-    sObjectMgr.LoadTrainerSpell();                              // must be after load CreatureTemplate
+    ///- Loading strings. Getting no records means core load has to be canceled because no error message can be output.
+    sLog.outString("");
+    sLog.outString("Loading Looking4group strings...");
+    if (!sObjectMgr.LoadLooking4groupStrings())
+        exit(1);                                            // Error message displayed in function already
 
-    sLog.outString("Loading opcodes cooldown...");
-    sObjectMgr.LoadOpcodesCooldown();
+    ///- Update the realm entry in the database with the realm type from the config file
+    //No SQL injection as values are treated as integers
 
-    sLog.outString("Loading Waypoints...");
-    sWaypointMgr.Load();
+    // not send custom type REALM_FFA_PVP to realm list
+    uint32 server_type = IsFFAPvPRealm() ? REALM_TYPE_PVP : getConfig(CONFIG_GAME_TYPE);
+    uint32 realm_zone = getConfig(CONFIG_REALM_ZONE);
+    AccountsDatabase.PExecute("UPDATE realms SET icon = %u, timezone = %u WHERE realm_id = '%u'", server_type, realm_zone, realmID);
 
-    sLog.outString("Loading Creature Formations...");
-    CreatureGroupManager::LoadCreatureFormations();
+    ///- Remove the bones after a restart
+    RealmDataDatabase.PExecute("DELETE FROM corpse WHERE corpse_type = '0'");
 
-    sLog.outString("Loading GM tickets...");
-    sTicketMgr.LoadGMTickets();
+    ///- Load static data, every loader waits only for the loaders it really depends on
+    ///- and independent ones run in parallel when StartupLoader.Threads > 1
+    typedef WorldLoader::TaskId TaskId;
+    typedef Looking4group::Callback<ObjectMgr> ObjectMgrLoader;
+    typedef Looking4group::Callback<SpellMgr> SpellMgrLoader;
+    typedef Looking4group::Callback<ScriptMgr> ScriptMgrLoader;
+    typedef Looking4group::SCallback StaticLoader;
+
+    WorldLoader loader;
+
+    TaskId dbc = loader.AddTask("data stores", new Looking4group::Callback<World>(this, &World::LoadDBCData));
+    loader.AddTask("Terrain specific data", new Looking4group::Callback<TerrainManager>(&sTerrainMgr, &TerrainManager::LoadTerrainSpecifics), dbc);
+    TaskId scriptNames = loader.AddTask("Script Names", new ScriptMgrLoader(&sScriptMgr, &ScriptMgr::LoadScriptNames));
+    TaskId instanceTemplate = loader.AddTask("InstanceTemplate", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadInstanceTemplate), dbc, scriptNames);
+    TaskId skillLineAbility = loader.AddTask("SkillLineAbilityMultiMap Data", new SpellMgrLoader(&sSpellMgr, &SpellMgr::LoadSkillLineAbilityMap), dbc);
+
+    // must be called before `creature_respawn`/`gameobject_respawn` tables
+    TaskId instanceCleanup = loader.AddTask("instances cleanup", new Looking4group::Callback<InstanceSaveManager>(&sInstanceSaveManager, &InstanceSaveManager::CleanupInstances), instanceTemplate);
+
+    TaskId locales = loader.AddTask("Localization strings", new StaticLoader(&LoadLocalizationStrings), dbc);
+    TaskId pageTexts = loader.AddTask("Page Texts", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadPageTexts));
+    TaskId goTemplates = loader.AddTask("Game Object Templates", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadGameobjectInfo), dbc, pageTexts, scriptNames);
+    TaskId spells = loader.AddTask("Spell Data", new StaticLoader(&LoadSpellData), dbc, skillLineAbility);
+    loader.AddTask("Unqueued Account List", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadUnqueuedAccountList));
+    TaskId gossipTexts = loader.AddTask("NPC Texts", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadGossipText));
+    TaskId randomEnchantments = loader.AddTask("Item Random Enchantments Table", new StaticLoader(&LoadRandomEnchantmentsTable), dbc);
+    TaskId items = loader.AddTask("Items", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadItemPrototypes), dbc, randomEnchantments, pageTexts, scriptNames);
+    loader.AddTask("Item Texts", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadItemTexts));
+    TaskId modelInfo = loader.AddTask("Creature Model Based Info Data", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadCreatureModelInfo), dbc);
+    TaskId equipment = loader.AddTask("Equipment templates", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadEquipmentTemplates), dbc, items);
+    TaskId creatureTemplates = loader.AddTask("Creature templates", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadCreatureTemplates), dbc, modelInfo, equipment, scriptNames);
+    loader.AddTask("SpellsScriptTarget", new SpellMgrLoader(&sSpellMgr, &SpellMgr::LoadSpellScriptTarget), spells, creatureTemplates, goTemplates);
+    loader.AddTask("Reputation Data", new StaticLoader(&LoadReputationData), dbc, creatureTemplates);
+    loader.AddTask("Pet Create Spells", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadPetCreateSpells), dbc, creatureTemplates);
+
+    // creatures, gameobjects and corpses share grid guid storage, they can't be loaded at the same time
+    TaskId worldObjects = loader.AddTask("Creature and Gameobject Data", new StaticLoader(&LoadWorldObjects), creatureTemplates, goTemplates, instanceCleanup);
+    TaskId pools = loader.AddTask("Objects Pooling Data", new Looking4group::Callback<PoolManager>(&sPoolMgr, &PoolManager::LoadFromDB), worldObjects);
+    TaskId gameEvents = loader.AddTask("Game Event Data", new Looking4group::Callback<GameEventMgr>(&sGameEventMgr, &GameEventMgr::LoadFromDB), worldObjects, pools, items, gossipTexts);
+    loader.AddTask("Weather Data", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadWeatherZoneChances), dbc);
+
+    // must be loaded after DBCs, creature_template, item_template, gameobject tables
+    TaskId quests = loader.AddTask("Quests", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadQuests), items, creatureTemplates, goTemplates, spells, gameEvents);
+    loader.AddTask("Quests Relations", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadQuestRelations), quests, worldObjects, gameEvents);
+    loader.AddTask("AreaTrigger Data", new StaticLoader(&LoadAreaTriggerData), quests, items, scriptNames);
+    loader.AddTask("Event and Spell script names", new StaticLoader(&LoadScriptNameBindings), dbc, scriptNames);
+    loader.AddTask("Graveyard-zone links", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadGraveyardZones), dbc);
+    loader.AddTask("Spell target, affect and pet aura data", new StaticLoader(&LoadSpellExtraData), spells, creatureTemplates);
+
+    // spell extra attributes are written into SpellEntry, so everything reading spells loaded so far has to finish first
+    TaskId spellCustomAttr = loader.AddBarrierTask("spell extra attributes", new StaticLoader(&LoadSpellCustomData));
+
+    loader.AddTask("player Create Info & Level Stats", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadPlayerInfo), spellCustomAttr);
+    loader.AddTask("Exploration BaseXP Data", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadExplorationBaseXP), spellCustomAttr);
+    loader.AddTask("Pet Name Parts", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadPetNames), spellCustomAttr);
+    loader.AddTask("the max pet number", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadPetNumber), spellCustomAttr);
+    loader.AddTask("pet level stats", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadPetLevelInfo), spellCustomAttr);
+    loader.AddTask("Player Corpses", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadCorpses), spellCustomAttr, worldObjects);
+    loader.AddTask("Disabled Spells", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadSpellDisabledEntrys), spellCustomAttr);
+    loader.AddTask("Loot Tables", new StaticLoader(&LoadLootTables), spellCustomAttr);
+    loader.AddTask("Skill Discovery Table", new StaticLoader(&LoadSkillDiscoveryTable), spellCustomAttr);
+    loader.AddTask("Skill Extra Item Table", new StaticLoader(&LoadSkillExtraItemTable), spellCustomAttr);
+    loader.AddTask("Skill Fishing base level requirements", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadFishingBaseSkillLevel), spellCustomAttr);
 
-    ///- Handle outdated emails (delete/return)
-    sLog.outString("Returning old mails...");
-    sObjectMgr.ReturnOrDeleteOldMails(false);
+    ///- Load dynamic data tables from the database
+    // auctions, guild banks and returned mails all create items, load them one by one
+    TaskId auctions = loader.AddTask("Auctions", new StaticLoader(&LoadAuctionData), spellCustomAttr);
+    TaskId guilds = loader.AddTask("Guilds", new Looking4group::Callback<GuildMgr>(&sGuildMgr, &GuildMgr::LoadGuilds), auctions);
+    TaskId arenaTeams = loader.AddTask("ArenaTeams", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadArenaTeams), spellCustomAttr);
+    loader.AddTask("Groups", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadGroups), arenaTeams);
+    loader.AddTask("ReservedNames", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadReservedPlayersNames), spellCustomAttr);
+    loader.AddTask("BattleMasters", new Looking4group::Callback<BattleGroundMgr>(&sBattleGroundMgr, &BattleGroundMgr::LoadBattleMastersEntry), spellCustomAttr);
+    loader.AddTask("GameTeleports", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadGameTele), spellCustomAttr);
+    loader.AddTask("Npc Text Id", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadNpcTextId), spellCustomAttr);
+    loader.AddTask("Npc Options", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadNpcOptions), spellCustomAttr);
+    loader.AddTask("vendors", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadVendors), spellCustomAttr);
+    loader.AddTask("trainers", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadTrainerSpell), spellCustomAttr);
+    loader.AddTask("opcodes cooldown", new ObjectMgrLoader(&sObjectMgr, &ObjectMgr::LoadOpcodesCooldown), spellCustomAttr);
+    TaskId waypoints = loader.AddTask("Waypoints", new Looking4group::Callback<WaypointMgr>(&sWaypointMgr, &WaypointMgr::Load), spellCustomAttr);
+    loader.AddTask("Creature Formations", new StaticLoader(&CreatureGroupManager::LoadCreatureFormations), spellCustomAttr);
+    loader.AddTask("GM tickets", new Looking4group::Callback<TicketMgr>(&sTicketMgr, &TicketMgr::LoadGMTickets), spellCustomAttr);
 
-    sLog.outString("Loading Autobroadcasts...");
-    LoadAutobroadcasts();
+    ///- Handle outdated emails (delete/return)
+    loader.AddTask("old mails to return", new StaticLoader(&ReturnOldMails), guilds);
+    loader.AddTask("Autobroadcasts", new Looking4group::Callback<World>(this, &World::LoadAutobroadcasts), spellCustomAttr);
 
     ///- Load and initialize scripts
-    sLog.outString("Loading Scripts...");
-    sScriptMgr.LoadQuestStartScripts();                         // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadQuestEndScripts();                           // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadSpellScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadGameObjectScripts();                         // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadEventScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadWaypointScripts();
-
-    sLog.outString("Loading Scripts text locales...");    // must be after Load*Scripts calls
-    sScriptMgr.LoadDbScriptStrings();
+    TaskId dbScripts = loader.AddTask("Scripts", new StaticLoader(&LoadDbScripts), spellCustomAttr, waypoints);
+    TaskId dbScriptStrings = loader.AddTask("Scripts text locales", new ScriptMgrLoader(&sScriptMgr, &ScriptMgr::LoadDbScriptStrings), dbScripts, locales);
 
-    sLog.outString("Loading CreatureEventAI Texts...");
-    sCreatureEAIMgr.LoadCreatureEventAI_Texts(false);       // false, will checked in LoadCreatureEventAI_Scripts
+    // CreatureEventAI texts add string locales the same way as script texts
+    TaskId eventAITexts = loader.AddTask("CreatureEventAI Texts", new StaticLoader(&LoadCreatureEventAITexts), spellCustomAttr, dbScriptStrings);
+    TaskId eventAISummons = loader.AddTask("CreatureEventAI Summons", new StaticLoader(&LoadCreatureEventAISummons), spellCustomAttr);
+    loader.AddTask("CreatureEventAI Scripts", new StaticLoader(&LoadCreatureEventAIScripts), eventAITexts, eventAISummons);
 
-    sLog.outString("Loading CreatureEventAI Summons...");
-    sCreatureEAIMgr.LoadCreatureEventAI_Summons(false);     // false, will checked in LoadCreatureEventAI_Scripts
-
-    sLog.outString("Loading CreatureEventAI Scripts...");
-    sCreatureEAIMgr.LoadCreatureEventAI_Scripts();
+    loader.Run(getConfig(CONFIG_STARTUP_LOADER_THREADS));
 
     sLog.outString("Initializing Scripts...");
     sScriptMgr.LoadScriptLibrary(LOOKING4GROUP_SCRIPT_NAME);
@@ -1737,7 +1732,7 @@ void World::Update(uint32 diff)
         extmail_timer.Update(diff);
         if (extmail_timer.Passed())
         {
-            WorldSession::SendExternalMails();
+            sExternalMailMgr.Update();
             extmail_timer.Reset();
         }
     }    
@@ -1790,6 +1785,9 @@ void World::Update(uint32 diff)
         for (ObjectMgr::GroupSet::iterator itr = sObjectMgr.GetGroupSetBegin(); itr != sObjectMgr.GetGroupSetEnd(); ++itr)
             (*itr)->Update(diff);
 
+        // battleground raids too, they are not in the group set
+        Group::SendQueuedMemberStats();
+
         diffRecorder.RecordTimeFor("UpdateGroups");
     }
 
@@ -2383,10 +2381,18 @@ BanReturn World::BanAccount(BanMode mode, std::string nameIPOrMail, std::string
     switch (mode)
     {
         case BAN_IP:
+        {
             //No SQL injection as strings are escaped
-            resultAccounts = AccountsDatabase.PQuery("SELECT account_id FROM account WHERE last_ip = '%s'", nameIPOrMail.c_str());
+            uint32 net;
+            uint8 prefixLen;
+            if (nameIPOrMail.find('/') != std::string::npos && ParseIPNetwork(nameIPOrMail, net, prefixLen))
+                resultAccounts = AccountsDatabase.PQuery("SELECT account_id FROM account WHERE (INET_ATON(last_ip) & %u) = %u",
+                    IPNetworkMask(prefixLen), net & IPNetworkMask(prefixLen));
+            else
+                resultAccounts = AccountsDatabase.PQuery("SELECT account_id FROM account WHERE last_ip = '%s'", nameIPOrMail.c_str());
             AccountsDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s', UNIX_TIMESTAMP(), UNIX_TIMESTAMP()+%u, '%s', '%s')", nameIPOrMail.c_str(), duration_secs, safe_author.c_str(), reason.c_str());
             break;
+        }
         case BAN_ACCOUNT:
             //No SQL injection as string is escaped
             resultAccounts = AccountsDatabase.PQuery("SELECT account_id FROM account WHERE username = '%s'", nameIPOrMail.c_str());
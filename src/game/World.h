@@ -102,6 +102,7 @@ enum WorldConfigs
     CONFIG_VMAP_INDOOR_CHECK,
     CONFIG_INTERVAL_SAVE,
     CONFIG_INTERVAL_GRIDCLEAN,
+    CONFIG_GRID_PRELOAD_LOOKAHEAD,
     CONFIG_INTERVAL_MAPUPDATE,
     CONFIG_INTERVAL_CHANGEWEATHER,
     CONFIG_INTERVAL_DISCONNECT_TOLERANCE,
@@ -258,6 +259,9 @@ enum WorldConfigs
     CONFIG_NUMTHREADS,
     CONFIG_CUMULATIVE_LOG_METHOD,
     CONFIG_MAPUPDATE_MAXVISITORS,
+    CONFIG_CREATURE_UPDATE_NEAR_DISTANCE,
+    CONFIG_CREATURE_UPDATE_FAR_RATE,
+    CONFIG_CREATURE_UPDATE_EDGE_RATE,
     CONFIG_AUTOBROADCAST_INTERVAL,
     CONFIG_GUILD_ANN_INTERVAL,
     CONFIG_GUILD_ANN_COOLDOWN,
@@ -328,6 +332,8 @@ enum WorldConfigs
 
     CONFIG_VMAP_LOS_ENABLED,
     CONFIG_MMAP_ENABLED,
+    CONFIG_PATHFINDING_BATCH_BUDGET,
+    CONFIG_PATHFINDING_CACHE_LIFETIME,
 
     CONFIG_COREBALANCER_ENABLED,
     CONFIG_COREBALANCER_PLAYABLE_DIFF,
@@ -340,6 +346,8 @@ enum WorldConfigs
     CONFIG_CREATURE_RESTORE_STATE,
     CONFIG_FFA_DISALLOWGROUP,
 
+    CONFIG_STARTUP_LOADER_THREADS,
+
     CONFIG_VALUE_COUNT
 };
 
@@ -887,6 +895,7 @@ class LOOKING4GROUP_EXPORT World
         LocaleConstant m_defaultDbcLocale;                     // from config for one from loaded DBC locales
         uint32 m_availableDbcLocaleMask;                       // by loaded DBC
         void DetectDBCLang();
+        void LoadDBCData();
         bool m_allowMovement;
         std::string m_motd;
         std::string m_dataPath;
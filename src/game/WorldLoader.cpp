@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * Copyright (C) 2008 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "WorldLoader.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "ProgressBar.h"
+#include "Timer.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+class WorldLoaderThreadStartReq : public ACE_Method_Request
+{
+    public:
+        WorldLoaderThreadStartReq() {}
+        virtual int call(void)
+        {
+            GameDataDatabase.ThreadStart();
+            return 0;
+        }
+};
+
+class WorldLoaderThreadEndReq : public ACE_Method_Request
+{
+    public:
+        WorldLoaderThreadEndReq() {}
+        virtual int call(void)
+        {
+            GameDataDatabase.ThreadEnd();
+            return 0;
+        }
+};
+
+class WorldLoaderRequest : public ACE_Method_Request
+{
+    public:
+        WorldLoaderRequest(WorldLoader& loader, WorldLoader::TaskId id) : m_loader(loader), m_id(id) {}
+
+        virtual int call(void)
+        {
+            // print output of the loader at once when it is done
+            std::vector<std::string> lines;
+            sLog.SetConsoleCapture(&lines);
+            m_loader.ExecuteTask(m_id);
+            sLog.SetConsoleCapture(NULL);
+            sLog.outCapturedLines(lines);
+
+            m_loader.TaskFinished(m_id);
+            return 0;
+        }
+
+    private:
+        WorldLoader& m_loader;
+        WorldLoader::TaskId m_id;
+};
+
+WorldLoader::WorldLoader() : m_startTime(0), m_executor(), m_mutex(), m_condition(m_mutex), m_pendingTasks(0)
+{
+}
+
+WorldLoader::~WorldLoader()
+{
+    for (std::vector<Task>::iterator itr = m_tasks.begin(); itr != m_tasks.end(); ++itr)
+        delete itr->loader;
+}
+
+WorldLoader::TaskId WorldLoader::AddTask(char const* name, Looking4group::ICallback* loader, TaskId dep1, TaskId dep2, TaskId dep3, TaskId dep4, TaskId dep5, TaskId dep6)
+{
+    Task task;
+    task.name = name;
+    task.loader = loader;
+    task.pendingDependencies = 0;
+    task.startTime = 0;
+    task.endTime = 0;
+
+    TaskId id = m_tasks.size();
+    m_tasks.push_back(task);
+
+    TaskId deps[] = { dep1, dep2, dep3, dep4, dep5, dep6 };
+    for (uint8 i = 0; i < 6; ++i)
+        if (deps[i] != WORLD_LOADER_NO_TASK)
+            AddDependency(id, deps[i]);
+
+    return id;
+}
+
+WorldLoader::TaskId WorldLoader::AddBarrierTask(char const* name, Looking4group::ICallback* loader)
+{
+    TaskId id = AddTask(name, loader);
+
+    for (TaskId dep = 0; dep < id; ++dep)
+        AddDependency(id, dep);
+
+    return id;
+}
+
+void WorldLoader::AddDependency(TaskId task, TaskId dependency)
+{
+    if (task >= m_tasks.size() || dependency >= task)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: WorldLoader: task %u can't depend on task %u, dependencies must be added before dependent task", task, dependency);
+        return;
+    }
+
+    std::vector<TaskId>& deps = m_tasks[task].dependencies;
+    if (std::find(deps.begin(), deps.end(), dependency) != deps.end())
+        return;
+
+    deps.push_back(dependency);
+    m_tasks[dependency].dependents.push_back(task);
+}
+
+void WorldLoader::Run(uint32 threads)
+{
+    m_startTime = WorldTimer::getMSTime();
+
+    if (threads <= 1 || m_tasks.size() <= 1)
+        RunSequential();
+    else
+        RunParallel(threads);
+
+    ReportTimings(WorldTimer::getMSTimeDiffToNow(m_startTime));
+}
+
+void WorldLoader::RunSequential()
+{
+    for (TaskId id = 0; id < m_tasks.size(); ++id)
+        ExecuteTask(id);
+}
+
+void WorldLoader::RunParallel(uint32 threads)
+{
+    sLog.outString("Running %u startup loaders in %u threads...", uint32(m_tasks.size()), threads);
+
+    if (m_executor.activate(threads, new WorldLoaderThreadStartReq, new WorldLoaderThreadEndReq) == -1)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: WorldLoader: can't start loader threads, loading sequentially");
+        RunSequential();
+        return;
+    }
+
+    // bars of loaders running at once would overwrite each other
+    BarGoLink::SetSuppressed(true);
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+        m_pendingTasks = m_tasks.size();
+
+        for (TaskId id = 0; id < m_tasks.size(); ++id)
+            m_tasks[id].pendingDependencies = m_tasks[id].dependencies.size();
+
+        for (TaskId id = 0; id < m_tasks.size(); ++id)
+            if (!m_tasks[id].pendingDependencies)
+                ScheduleTask(id);
+
+        while (m_pendingTasks > 0)
+            m_condition.wait();
+    }
+
+    m_executor.deactivate();
+
+    BarGoLink::SetSuppressed(false);
+}
+
+void WorldLoader::ExecuteTask(TaskId id)
+{
+    Task& task = m_tasks[id];
+
+    sLog.outString("Loading %s...", task.name.c_str());
+
+    task.startTime = WorldTimer::getMSTimeDiffToNow(m_startTime);
+    task.loader->Execute();
+    task.endTime = WorldTimer::getMSTimeDiffToNow(m_startTime);
+}
+
+void WorldLoader::TaskFinished(TaskId id)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    std::vector<TaskId> const& dependents = m_tasks[id].dependents;
+    for (std::vector<TaskId>::const_iterator itr = dependents.begin(); itr != dependents.end(); ++itr)
+        if (--m_tasks[*itr].pendingDependencies == 0)
+            ScheduleTask(*itr);
+
+    --m_pendingTasks;
+    m_condition.broadcast();
+}
+
+// must be called with m_mutex held
+void WorldLoader::ScheduleTask(TaskId id)
+{
+    if (m_executor.execute(new WorldLoaderRequest(*this, id)) == -1)
+    {
+        // run in place, dependents are released the same way as from worker thread
+        sLog.outLog(LOG_DEFAULT, "ERROR: WorldLoader: can't schedule loader '%s', running in place", m_tasks[id].name.c_str());
+
+        m_mutex.release();
+        ExecuteTask(id);
+        m_mutex.acquire();
+
+        std::vector<TaskId> const& dependents = m_tasks[id].dependents;
+        for (std::vector<TaskId>::const_iterator itr = dependents.begin(); itr != dependents.end(); ++itr)
+            if (--m_tasks[*itr].pendingDependencies == 0)
+                ScheduleTask(*itr);
+
+        --m_pendingTasks;
+    }
+}
+
+void WorldLoader::ReportTimings(uint32 wallTime) const
+{
+    // longest chain of loader durations, tasks are already in topological order
+    std::vector<uint32> pathTime(m_tasks.size(), 0);
+    std::vector<TaskId> pathPrev(m_tasks.size(), WORLD_LOADER_NO_TASK);
+
+    uint32 totalTime = 0;
+    TaskId pathEnd = WORLD_LOADER_NO_TASK;
+
+    sLog.outString();
+    sLog.outString("Startup loader timings:");
+
+    for (TaskId id = 0; id < m_tasks.size(); ++id)
+    {
+        Task const& task = m_tasks[id];
+        uint32 duration = task.endTime - task.startTime;
+
+        for (std::vector<TaskId>::const_iterator itr = task.dependencies.begin(); itr != task.dependencies.end(); ++itr)
+        {
+            if (pathTime[*itr] > pathTime[id])
+            {
+                pathTime[id] = pathTime[*itr];
+                pathPrev[id] = *itr;
+            }
+        }
+
+        pathTime[id] += duration;
+        totalTime += duration;
+
+        if (pathEnd == WORLD_LOADER_NO_TASK || pathTime[id] > pathTime[pathEnd])
+            pathEnd = id;
+
+        sLog.outString("  %-32s %7u ms (start %7u ms)", task.name.c_str(), duration, task.startTime);
+    }
+
+    sLog.outString("Startup loaders: %u ms wall time, %u ms summed loader time", wallTime, totalTime);
+
+    if (pathEnd == WORLD_LOADER_NO_TASK)
+        return;
+
+    sLog.outString("Critical path (%u ms):", pathTime[pathEnd]);
+
+    std::vector<TaskId> path;
+    for (TaskId id = pathEnd; id != WORLD_LOADER_NO_TASK; id = pathPrev[id])
+        path.push_back(id);
+
+    for (std::vector<TaskId>::const_reverse_iterator itr = path.rbegin(); itr != path.rend(); ++itr)
+        sLog.outString("  %-32s %7u ms", m_tasks[*itr].name.c_str(), m_tasks[*itr].endTime - m_tasks[*itr].startTime);
+
+    sLog.outString();
+}
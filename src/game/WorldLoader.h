@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2005-2008 MaNGOS <http://www.mangosproject.org/>
+ *
+ * Copyright (C) 2008 Trinity <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup world
+/// @{
+/// \file
+
+#ifndef _WORLD_LOADER_H_INCLUDED
+#define _WORLD_LOADER_H_INCLUDED
+
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include "Common.h"
+#include "DelayExecutor.h"
+#include "Utilities/Callback.h"
+
+#define WORLD_LOADER_NO_TASK    0xFFFFFFFF
+
+/// Dependency graph of the static data loaders run at server startup
+/// Tasks may only depend on tasks added before them, so the declaration
+/// order is always a valid sequential load order.
+class WorldLoader
+{
+    public:
+        typedef uint32 TaskId;
+
+        WorldLoader();
+        ~WorldLoader();
+
+        friend class WorldLoaderRequest;
+
+        /// add loader, takes ownership of the callback
+        TaskId AddTask(char const* name, Looking4group::ICallback* loader,
+            TaskId dep1 = WORLD_LOADER_NO_TASK, TaskId dep2 = WORLD_LOADER_NO_TASK,
+            TaskId dep3 = WORLD_LOADER_NO_TASK, TaskId dep4 = WORLD_LOADER_NO_TASK,
+            TaskId dep5 = WORLD_LOADER_NO_TASK, TaskId dep6 = WORLD_LOADER_NO_TASK);
+
+        /// add loader that depends on every task added before it
+        TaskId AddBarrierTask(char const* name, Looking4group::ICallback* loader);
+
+        void AddDependency(TaskId task, TaskId dependency);
+
+        /// run all loaders, sequentially for threads <= 1, and print timing report
+        void Run(uint32 threads);
+
+    private:
+        struct Task
+        {
+            std::string name;
+            Looking4group::ICallback* loader;
+            std::vector<TaskId> dependencies;
+            std::vector<TaskId> dependents;
+            uint32 pendingDependencies;
+            uint32 startTime;
+            uint32 endTime;
+        };
+
+        void RunSequential();
+        void RunParallel(uint32 threads);
+
+        void ExecuteTask(TaskId id);
+        void TaskFinished(TaskId id);
+        void ScheduleTask(TaskId id);
+
+        void ReportTimings(uint32 wallTime) const;
+
+        std::vector<Task> m_tasks;
+        uint32 m_startTime;
+
+        DelayExecutor m_executor;
+        ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_condition;
+        uint32 m_pendingTasks;
+};
+
+#endif
+/// @}
@@ -68,6 +68,11 @@ bool MapSessionFilter::Process(WorldPacket * packet)
     return plr->IsInWorld();
 }
 
+bool CoalesceFilter::Process(WorldPacket* packet)
+{
+    return packet->GetOpcode() == m_opcode && m_filter.Process(packet);
+}
+
 //we should process ALL packets when player is not in world/logged in
 //OR packet handler is not thread-safe!
 
@@ -97,8 +102,6 @@ m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex
 _logoutTime(0), m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerSave(false), m_playerRecentlyLogout(false), m_latency(0),
 m_accFlags(accFlags), m_Warden(NULL)
 {
-    _mailSendTimer.Reset(5*IN_MILISECONDS);
-
     _kickTimer.Reset(sWorld.getConfig(CONFIG_SESSION_UPDATE_IDLE_KICK));
 
     if (sock)
@@ -339,7 +342,8 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 {
     RecordSessionTimeDiff(NULL);
     uint32 verbose = sWorld.getConfig(CONFIG_SESSION_UPDATE_VERBOSE_LOG);
-    std::vector<VerboseLogInfo> packetOpcodeInfo;
+    std::vector<SessionOpcodeTime> packetOpcodeInfo;
+    uint32 packetCount = 0;
 
     if (updater.ProcessTimersUpdate())
     {
@@ -352,16 +356,6 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         else
             _kickTimer.Reset(sWorld.getConfig(CONFIG_SESSION_UPDATE_IDLE_KICK));
 
-        if (GetPlayer() && GetPlayer()->IsInWorld())
-        {
-            _mailSendTimer.Update(diff);
-            if (_mailSendTimer.Passed())
-            {
-                SendExternalMails();
-                _mailSendTimer.Reset(sWorld.getConfig(CONFIG_EXTERNAL_MAIL_INTERVAL)*MINUTE*IN_MILISECONDS);
-            }
-        }
-
         for (OpcodesCooldown::iterator itr = _opcodesCooldown.begin(); itr != _opcodesCooldown.end(); ++itr)
             itr->second.Update(diff);
     }
@@ -374,14 +368,47 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     {
         while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet, updater))
         {
-            if (verbose > 0)
+            uint16 opcode = packet->GetOpcode();
+            if (opcode >= NUM_MSG_TYPES)
             {
-                RecordVerboseTimeDiff(true);
                 ProcessPacket(packet);
-                packetOpcodeInfo.push_back(VerboseLogInfo(packet->GetOpcode(), RecordVerboseTimeDiff(false)));
+                delete packet;
+                continue;
+            }
+
+            // burst of idempotent packets, only latest one matters
+            if (opcodeTable[opcode].coalesce)
+            {
+                CoalesceFilter filter(opcode, updater);
+                WorldPacket* later;
+                while (_recvQueue.next(later, filter))
+                {
+                    delete packet;
+                    packet = later;
+                    ++opcodeTimes[opcode].coalesced;
+                }
+            }
+
+            ACE_Time_Value startTime = ACE_OS::gettimeofday();
+            ProcessPacket(packet);
+            ACE_Time_Value spent = ACE_OS::gettimeofday() - startTime;
+
+            uint32 time = uint32(spent.sec() * 1000000 + spent.usec());
+            opcodeTimes[opcode].Add(time);
+            ++packetCount;
+
+            if (verbose > 0)
+            {
+                std::vector<SessionOpcodeTime>::iterator itr = packetOpcodeInfo.begin();
+                while (itr != packetOpcodeInfo.end() && itr->opcode != opcode)
+                    ++itr;
+
+                if (itr == packetOpcodeInfo.end())
+                    itr = packetOpcodeInfo.insert(itr, SessionOpcodeTime(opcode));
+
+                ++itr->count;
+                itr->time += time;
             }
-            else
-                ProcessPacket(packet);
 
             delete packet;
         }
@@ -439,11 +466,11 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         overtimeText << "\n#################################################\n";
         overtimeText << "Overtime verbose info for account " << GetAccountId();
         overtimeText << "\nPacket Processing Time: " << overtimediff;
-        overtimeText << "\nPacket count: " << packetOpcodeInfo.size();
-        overtimeText << "\nPacket info:\n";
+        overtimeText << "\nPacket count: " << packetCount;
+        overtimeText << "\nPacket info (opcode, count, time in us):\n";
 
-        for (std::vector<VerboseLogInfo>::const_iterator itr = packetOpcodeInfo.begin(); itr != packetOpcodeInfo.end(); ++itr)
-            overtimeText << "  " << (*itr).opcode << " (" << (*itr).diff << ")\n";
+        for (std::vector<SessionOpcodeTime>::const_iterator itr = packetOpcodeInfo.begin(); itr != packetOpcodeInfo.end(); ++itr)
+            overtimeText << "  " << LookupOpcodeName(itr->opcode) << " " << itr->count << " (" << itr->time << ")\n";
 
         overtimeText << "#################################################";
         sLog.outLog(LOG_SESSION_DIFF, overtimeText.str().c_str());
@@ -826,19 +853,3 @@ uint32 WorldSession::RecordSessionTimeDiff(const char *text, ...)
 
     return diff;
 }
-
-uint32 WorldSession::RecordVerboseTimeDiff(bool reset)
-{
-    if (reset)
-    {
-        m_currentVerboseTime = WorldTimer::getMSTime();
-        return 0;
-    }
-
-    uint32 thisTime = WorldTimer::getMSTime();
-    uint32 diff = WorldTimer::getMSTimeDiff(m_currentVerboseTime, thisTime);
-
-    m_currentVerboseTime = thisTime;
-
-    return diff;
-}
@@ -33,6 +33,13 @@
 #include "WardenBase.h"
 #include "Item.h"
 
+// LockFreeQueue needs <atomic>, missing before VC110
+#if defined(_MSC_VER) && _MSC_VER < 1700
+#include "LockedQueue.h"
+#else
+#include "LockFreeQueue.h"
+#endif
+
 struct ItemPrototype;
 struct AuctionEntry;
 struct AuctionHouseEntry;
@@ -149,6 +156,19 @@ class WorldSessionFilter : public PacketFilter
         bool ProcessWardenUpdate() const { return true; }
 };
 
+//accepts next queued packet only if it has given opcode and the update filter accepts it too
+class CoalesceFilter
+{
+    public:
+        CoalesceFilter(uint16 opcode, PacketFilter& filter) : m_opcode(opcode), m_filter(filter) {}
+
+        bool Process(WorldPacket* packet);
+
+    private:
+        uint16 m_opcode;
+        PacketFilter& m_filter;
+};
+
 /// Player session in the World
 class LOOKING4GROUP_IMPORT_EXPORT WorldSession
 {
@@ -177,7 +197,6 @@ class LOOKING4GROUP_IMPORT_EXPORT WorldSession
         void SendAreaTriggerMessage(const char* Text, ...) ATTR_PRINTF(2,3);
 
         uint32 RecordSessionTimeDiff(const char *text, ...);
-        uint32 RecordVerboseTimeDiff(bool reset);
 
         uint64 GetPermissions() const { return m_permissions; }
         bool HasPermissions(uint64 perms) const { return m_permissions & perms; }
@@ -261,10 +280,6 @@ class LOOKING4GROUP_IMPORT_EXPORT WorldSession
 
         bool SendItemInfo(uint32 itemid, WorldPacket data);
 
-        // External Mail
-        static void SendExternalMails();
-        TimeTrackerSmall _mailSendTimer;
-
         //auction
         void SendAuctionHello(Unit *unit);
         void SendAuctionCommandResult(AuctionEntry *auc, AuctionAction Action, AuctionError ErrorCode, InventoryResult invError = EQUIP_ERR_OK);
@@ -789,19 +804,25 @@ class LOOKING4GROUP_IMPORT_EXPORT WorldSession
         typedef UNORDERED_MAP<uint16,ShortIntervalTimer> OpcodesCooldown;
         OpcodesCooldown _opcodesCooldown;
 
+        // filled by network thread, taken by map or world thread, never both at once
+#if defined(_MSC_VER) && _MSC_VER < 1700
         ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _recvQueue;
+#else
+        ACE_Based::LockFreeQueue<WorldPacket*> _recvQueue;
+#endif
 
         uint32 m_currentSessionTime;
-        uint32 m_currentVerboseTime;
         uint32 lastMoveTimeServer;
         uint32 lastMoveTimeClient;
 };
 
-struct VerboseLogInfo
+// handler times of one opcode during one session update, for verbose log
+struct SessionOpcodeTime
 {
-    VerboseLogInfo(uint16 op, uint32 df) : opcode(op), diff(df) {}
+    explicit SessionOpcodeTime(uint16 op) : opcode(op), count(0), time(0) {}
     uint16 opcode;
-    uint32 diff;
+    uint32 count;
+    uint32 time;
 };
 
 #endif
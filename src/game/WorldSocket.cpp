@@ -40,6 +40,7 @@
 #include "AddonHandler.h"
 #include "Opcodes.h"
 #include "Database/DatabaseEnv.h"
+#include "Database/SqlOperations.h"
 #include "Auth/BigNumber.h"
 #include "Auth/Sha1.h"
 #include "WorldSession.h"
@@ -72,6 +73,28 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+enum WorldSocketAuthQuery
+{
+    AUTH_QUERY_ACCOUNT      = 0,
+    AUTH_QUERY_BAN,
+    AUTH_QUERY_MUTE,
+    AUTH_QUERY_PERMISSIONS,
+    MAX_AUTH_QUERY
+};
+
+/// CMSG_AUTH_SESSION content kept while its account queries run
+class WorldSocketAuthHolder : public SqlQueryHolder
+{
+    public:
+        explicit WorldSocketAuthHolder(WorldPacket const& packet) : authPacket(packet), clientSeed(0) {}
+        bool Initialize();
+
+        WorldPacket authPacket;                             // read position is at addon data
+        std::string account;
+        uint32 clientSeed;
+        uint8 digest[20];
+};
+
 WorldSocket::WorldSocket(void) :
 WorldHandler(),
 m_LastPingTime(ACE_Time_Value::zero),
@@ -82,8 +105,15 @@ m_RecvPct(),
 m_Header(sizeof(ClientPktHeader)),
 m_OutBuffer(0),
 m_OutBufferSize(65536),
+m_OutFlushDelay(0),
+m_OutPendingSince(0),
+m_SendCalls(0),
+m_SentPackets(0),
+m_RecvCalls(0),
 m_OutActive(false),
-m_Seed(static_cast<uint32>(rand32()))
+m_Seed(static_cast<uint32>(rand32())),
+m_AuthPending(false),
+m_AuthResult(NULL)
 {
     reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
 }
@@ -103,6 +133,8 @@ WorldSocket::~WorldSocket(void)
     WorldPacket* pct;
     while (m_PacketQueue.dequeue_head(pct) == 0)
         delete pct;
+
+    delete m_AuthResult;
 }
 
 bool WorldSocket::IsClosed(void) const
@@ -300,6 +332,10 @@ int WorldSocket::handle_output(ACE_HANDLE)
     if (send_len == 0)
         return cancel_wakeup_output(Guard);
 
+    iEncryptHeaders();
+
+    ++m_SendCalls;
+
 #ifdef MSG_NOSIGNAL
     ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
 #else
@@ -365,9 +401,35 @@ int WorldSocket::Update(void)
     if (closing_)
         return -1;
 
+    if (m_AuthPending)
+    {
+        WorldSocketAuthHolder* holder;
+        {
+            ACE_GUARD_RETURN(LockType, Guard, m_SessionLock, -1);
+            holder = m_AuthResult;
+            m_AuthResult = NULL;
+        }
+
+        if (holder)
+        {
+            m_AuthPending = false;
+
+            int result = CompleteAuthSession(*holder);
+            delete holder;
+
+            if (result == -1)
+                return -1;
+        }
+    }
+
     if (m_OutActive || m_OutBuffer->length() == 0)
         return 0;
 
+    // let more packets gather for the same send, unless the buffer is filling up
+    if (m_OutFlushDelay && m_OutBuffer->length() < m_OutBufferSize / 4 &&
+        WorldTimer::getMSTimeDiffToNow(m_OutPendingSince) < m_OutFlushDelay)
+        return 0;
+
     return handle_output(get_handle());
 }
 
@@ -395,7 +457,14 @@ int WorldSocket::handle_input_header(void)
 
     header.size -= 4;
 
-    ACE_NEW_RETURN(m_RecvWPct, WorldPacket((uint16) header.cmd, header.size), -1);
+    // packet and storage come from the pool of this network thread, the session gives them back when the packet is deleted
+    PacketBufferPool& pool = PacketBufferPool::ThreadInstance();
+    m_RecvWPct = new (pool) WorldPacket((uint16) header.cmd, header.size, pool);
+    if (!m_RecvWPct)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
 
     if (header.size > 0)
     {
@@ -454,6 +523,8 @@ int WorldSocket::handle_input_missing_data(void)
     const ssize_t n = peer().recv(message_block.wr_ptr(),
                                           recv_size);
 
+    ++m_RecvCalls;
+
     if (n <= 0)
         return(int)n;
 
@@ -604,7 +675,7 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
             case CMSG_PING:
                 return HandlePing(*new_pct);
             case CMSG_AUTH_SESSION:
-                if (m_Session)
+                if (m_Session || m_AuthPending)
                 {
                     sLog.outLog(LOG_DEFAULT, "ERROR: WorldSocket::ProcessIncoming: Player send CMSG_AUTH_SESSION again");
                     return -1;
@@ -666,21 +737,65 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
     ACE_NOTREACHED(return 0);
 }
 
+bool WorldSocketAuthHolder::Initialize()
+{
+    SetSize(MAX_AUTH_QUERY);
+
+    std::string safe_account = account; // Duplicate, else will screw the SHA hash verification below
+    AccountsDatabase.escape_string(safe_account);
+    // No SQL injection, username escaped.
+
+    bool res = true;
+    res &= SetPQuery(AUTH_QUERY_ACCOUNT, "SELECT "
+                                "account.account_id, "          //0
+                                "permission_mask, "             //1
+                                "session_key, "                 //2
+                                "last_ip, "                     //3
+                                "account_state_id, "            //4
+                                "v, "                           //5
+                                "s, "                           //6
+                                "expansion_id, "                //7
+                                "locale_id, "                   //8
+                                "account_flags, "               //9
+                                "opcodes_disabled, "            //10
+                                "client_os_version_id, "        //11
+                                "last_local_ip "                //12
+                                "FROM account JOIN account_permissions ON account.account_id = account_permissions.account_id "
+                                "   JOIN account_session ON account.account_id = account_session.account_id "
+                                "WHERE username = '%s' AND realm_id = '%u'",
+                                safe_account.c_str(), realmID);
+
+    // Re-check account ban(same check as in realmd)
+    res &= SetPQuery(AUTH_QUERY_BAN, "SELECT "
+                                "punishment_date, "
+                                "expiration_date "
+                                "FROM account_punishment JOIN account ON account_punishment.account_id = account.account_id "
+                                "WHERE username = '%s' "
+                                "AND punishment_type_id = '%u' "
+                                "AND expiration_date > UNIX_TIMESTAMP()",
+                                safe_account.c_str(), PUNISHMENT_BAN);
+
+    res &= SetPQuery(AUTH_QUERY_MUTE, "SELECT "
+                                "expiration_date, "
+                                "reason "
+                                "FROM account_punishment JOIN account ON account_punishment.account_id = account.account_id "
+                                "WHERE username = '%s' "
+                                "AND expiration_date > UNIX_TIMESTAMP() "
+                                "ORDER BY expiration_date DESC LIMIT 1",
+                                safe_account.c_str());
+
+    // Check locked state for server
+    res &= SetPQuery(AUTH_QUERY_PERMISSIONS, "SELECT required_permission_mask FROM realms WHERE realm_id = '%u'", realmID);
+
+    return res;
+}
+
 int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 {
     // NOTE: ATM the socket is singlethread, have this in mind ...
-    uint8 digest[20];
-    uint32 clientSeed;
     uint32 unk2;
     uint32 BuiltNumberClient;
-    uint32 id;
-    uint64 permissionMask;
-    uint8 expansion = 0;
-    LocaleConstant locale;
-    std::string account;
-    Sha1Hash sha1;
-    BigNumber v, s, g, N, K;
-    WorldPacket packet, SendAddonPacked;
+    WorldPacket packet;
 
     if (recvPacket.size() <(4 + 4 + 1 + 4 + 20))
     {
@@ -688,25 +803,29 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
         return -1;
     }
 
+    WorldSocketAuthHolder* holder = new WorldSocketAuthHolder(recvPacket);
+    WorldPacket& authPacket = holder->authPacket;
+
     // Read the content of the packet
-    recvPacket >> BuiltNumberClient;
-    recvPacket >> unk2;
-    recvPacket >> account;
+    authPacket >> BuiltNumberClient;
+    authPacket >> unk2;
+    authPacket >> holder->account;
 
-    if (recvPacket.size() <(4 + 4 +(account.size() + 1) + 4 + 20))
+    if (authPacket.size() <(4 + 4 +(holder->account.size() + 1) + 4 + 20))
     {
         sLog.outLog(LOG_DEFAULT, "ERROR: WorldSocket::HandleAuthSession: wrong packet size second check");
+        delete holder;
         return -1;
     }
 
-    recvPacket >> clientSeed;
-    recvPacket.read(digest, 20);
+    authPacket >> holder->clientSeed;
+    authPacket.read(holder->digest, 20);
 
     DEBUG_LOG("WorldSocket::HandleAuthSession: client %u, unk2 %u, account %s, clientseed %u",
                 BuiltNumberClient,
                 unk2,
-                account.c_str(),
-                clientSeed);
+                holder->account.c_str(),
+                holder->clientSeed);
 
     // Check the version of client trying to connect
     if (!IsAcceptableClientBuild(BuiltNumberClient))
@@ -717,33 +836,57 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
         SendPacket(packet);
 
         sLog.outLog(LOG_DEFAULT, "ERROR: WorldSocket::HandleAuthSession: Sent Auth Response(version mismatch).");
+        delete holder;
         return -1;
     }
 
-    // Get the account information from the realmd database
-    std::string safe_account = account; // Duplicate, else will screw the SHA hash verification below
-    AccountsDatabase.escape_string(safe_account);
-    // No SQL injection, username escaped.
+    if (!holder->Initialize())
+    {
+        delete holder;
+        return -1;
+    }
 
-    QueryResultAutoPtr result =
-          AccountsDatabase.PQuery("SELECT "
-                                "account.account_id, "          //0
-                                "permission_mask, "             //1
-                                "session_key, "                 //2
-                                "last_ip, "                     //3
-                                "account_state_id, "            //4
-                                "v, "                           //5
-                                "s, "                           //6
-                                "expansion_id, "                //7
-                                "locale_id, "                   //8
-                                "account_flags, "               //9
-                                "opcodes_disabled, "            //10
-                                "client_os_version_id, "        //11
-                                "last_local_ip "                //12
-                                "FROM account JOIN account_permissions ON account.account_id = account_permissions.account_id "
-                                "   JOIN account_session ON account.account_id = account_session.account_id "
-                                "WHERE username = '%s' AND realm_id = '%u'",
-                                safe_account.c_str(), realmID);
+    // Get the account information from the realmd database without blocking other sockets of this thread,
+    // further packets are not accepted until CompleteAuthSession() is done
+    AddReference();
+
+    if (!AccountsDatabase.DelayQueryHolder(sWorldSocketMgr->m_AuthResults, this, &WorldSocket::HandleAuthSessionCallback, (SqlQueryHolder*)holder))
+    {
+        RemoveReference();
+        delete holder;
+        return -1;
+    }
+
+    m_AuthPending = true;
+    return 0;
+}
+
+void WorldSocket::HandleAuthSessionCallback(QueryResultAutoPtr /*dummy*/, SqlQueryHolder* holder)
+{
+    {
+        ACE_GUARD(LockType, Guard, m_SessionLock);
+
+        if (IsClosed())
+            delete (WorldSocketAuthHolder*)holder;
+        else
+            m_AuthResult = (WorldSocketAuthHolder*)holder;
+    }
+
+    // may delete the socket
+    RemoveReference();
+}
+
+int WorldSocket::CompleteAuthSession(WorldSocketAuthHolder& holder)
+{
+    uint32 id;
+    uint64 permissionMask;
+    uint8 expansion = 0;
+    LocaleConstant locale;
+    std::string& account = holder.account;
+    BigNumber v, s, g, N, K;
+    WorldPacket packet, SendAddonPacked;
+
+    QueryResultAutoPtr result = holder.GetResult(AUTH_QUERY_ACCOUNT);
 
     // Stop if the account is not found
     if (!result)
@@ -805,18 +948,7 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     uint64 accFlags = fields[9].GetUInt64();
     uint16 opcDis = fields[10].GetUInt16();
 
-    // Re-check account ban(same check as in realmd)
-    QueryResultAutoPtr banresult =
-          AccountsDatabase.PQuery("SELECT "
-                                "punishment_date, "
-                                "expiration_date "
-                                "FROM account_punishment "
-                                "WHERE account_id = '%u' "
-                                "AND punishment_type_id = '%u' "
-                                "AND expiration_date > UNIX_TIMESTAMP()",
-                                id, PUNISHMENT_BAN);
-
-    if (banresult) // if account banned
+    if (holder.GetResult(AUTH_QUERY_BAN)) // if account banned
     {
         packet.Initialize(SMSG_AUTH_RESPONSE, 1);
         packet << uint8(AUTH_BANNED);
@@ -827,7 +959,9 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     }
 
     // Check locked state for server
-    sWorld.UpdateRequiredPermissions();
+    if (QueryResultAutoPtr permissionResult = holder.GetResult(AUTH_QUERY_PERMISSIONS))
+        sWorld.SetMinimumPermissionMask(permissionResult->Fetch()->GetUInt64());
+
     uint64 minimumPermissions = sWorld.GetMinimumPermissionMask();
     sLog.outDebug("Allowed Level: %u Player Level %u", minimumPermissions, permissionMask);
     if (!(permissionMask & minimumPermissions))
@@ -849,12 +983,12 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 
     sha.UpdateData(account);
     sha.UpdateData((uint8 *) & t, 4);
-    sha.UpdateData((uint8 *) & clientSeed, 4);
+    sha.UpdateData((uint8 *) & holder.clientSeed, 4);
     sha.UpdateData((uint8 *) & seed, 4);
     sha.UpdateBigNumbers(&K, NULL);
     sha.Finalize();
 
-    if (memcmp(sha.GetDigest(), digest, 20))
+    if (memcmp(sha.GetDigest(), holder.digest, 20))
     {
         packet.Initialize(SMSG_AUTH_RESPONSE, 1);
         packet << uint8(AUTH_FAILED);
@@ -883,15 +1017,7 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     SqlStatement stmt = AccountsDatabase.CreateStatement(updAccount, "UPDATE account SET last_ip = ? WHERE account_id = ?");
     stmt.PExecute(address.c_str(), id);
 
-    QueryResultAutoPtr muteresult =
-          AccountsDatabase.PQuery("SELECT "
-                                "expiration_date, "
-                                "reason "
-                                "FROM account_punishment "
-                                "WHERE account_id = '%u' "
-                                "AND expiration_date > UNIX_TIMESTAMP() "
-                                "ORDER BY expiration_date DESC LIMIT 1",
-                                id);
+    QueryResultAutoPtr muteresult = holder.GetResult(AUTH_QUERY_MUTE);
 
     time_t mutetime;
     std::string mutereason;
@@ -908,11 +1034,19 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
         mutereason = "";
     }
 
-    // NOTE ATM the socket is singlethreaded, have this in mind ...
-    ACE_NEW_RETURN(m_Session, WorldSession(id, this, permissionMask, expansion, locale, mutetime, mutereason, accFlags, opcDis), -1);
+    WorldSession* session;
+    ACE_NEW_RETURN(session, WorldSession(id, this, permissionMask, expansion, locale, mutetime, mutereason, accFlags, opcDis), -1);
 
-    m_Crypt.SetKey(&K);
-    m_Crypt.Init();
+    // Critical section
+    {
+        ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+        // headers written before the key is set go out plain
+        iEncryptHeaders();
+
+        m_Crypt.SetKey(&K);
+        m_Crypt.Init();
+    }
 
     AccountsDatabase.escape_string(lastLocalIp);
 
@@ -920,15 +1054,17 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 
     // Initialize Warden system only if it is enabled by config
     if (sWorld.getConfig(CONFIG_WARDEN_ENABLED))
-        m_Session->InitWarden(&K, operatingSystem);
+        session->InitWarden(&K, operatingSystem);
 
-    // In case needed sometime the second arg is in microseconds 1 000 000 = 1 sec
-    ACE_OS::sleep(ACE_Time_Value(0, 10000));
+    {
+        ACE_GUARD_RETURN(LockType, Guard, m_SessionLock, -1);
+        m_Session = session;
+    }
 
-    sWorld.AddSession(m_Session);
+    sWorld.AddSession(session);
 
     // Create and send the Addon packet
-    if (AddonHandler::BuildAddonPacket(&recvPacket, &SendAddonPacked))
+    if (AddonHandler::BuildAddonPacket(&holder.authPacket, &SendAddonPacked))
         SendPacket(SendAddonPacked);
 
     return 0;
@@ -1019,7 +1155,12 @@ int WorldSocket::iSendPacket(const WorldPacket& pct)
     header.size =(uint16) pct.size() + 2;
     EndianConvertReverse(header.size);
 
-    m_Crypt.EncryptSend((uint8*) & header, sizeof(header));
+    if (m_OutBuffer->length() == 0)
+        m_OutPendingSince = WorldTimer::getMSTime();
+
+    // encrypted by iEncryptHeaders() before it is sent
+    m_OutHeaders.push_back(m_OutBuffer->wr_ptr() - m_OutBuffer->base());
+    ++m_SentPackets;
 
     if (m_OutBuffer->copy((char*) & header, sizeof(header)) == -1)
         ACE_ASSERT(false);
@@ -1031,6 +1172,15 @@ int WorldSocket::iSendPacket(const WorldPacket& pct)
     return 0;
 }
 
+void WorldSocket::iEncryptHeaders()
+{
+    // the stream cipher needs the headers in the order they are sent
+    for (std::vector<size_t>::const_iterator itr = m_OutHeaders.begin(); itr != m_OutHeaders.end(); ++itr)
+        m_Crypt.EncryptSend((uint8*) m_OutBuffer->base() + *itr, sizeof(ServerPktHeader));
+
+    m_OutHeaders.clear();
+}
+
 bool WorldSocket::iFlushPacketQueue()
 {
     WorldPacket *pct;
@@ -1059,6 +1209,46 @@ bool WorldSocket::iFlushPacketQueue()
     return haveone;
 }
 
+void WorldSocket::CollectStats(uint32& sends, uint32& recvs, uint32& packets)
+{
+    recvs = m_RecvCalls;
+    m_RecvCalls = 0;
+
+    sends = packets = 0;
+
+    ACE_GUARD(LockType, Guard, m_OutBufferLock);
+
+    sends = m_SendCalls;
+    packets = m_SentPackets;
+    m_SendCalls = 0;
+    m_SentPackets = 0;
+}
+
+int WorldSocket::MoveToReactor(ACE_Reactor* target)
+{
+    // the reference of the reactor is dropped, the caller holds another one
+    if (reactor()->remove_handler(this, ACE_Event_Handler::DONT_CALL | ACE_Event_Handler::ALL_EVENTS_MASK) == -1)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: WorldSocket::MoveToReactor: unable to remove client handler errno = %s", ACE_OS::strerror(errno));
+        return -1;
+    }
+
+    reactor(target);
+
+    // m_OutActive only changes in the network thread
+    ACE_Reactor_Mask mask = ACE_Event_Handler::READ_MASK;
+    if (m_OutActive)
+        mask |= ACE_Event_Handler::WRITE_MASK;
+
+    if (target->register_handler(this, mask) == -1)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: WorldSocket::MoveToReactor: unable to register client handler errno = %s", ACE_OS::strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
 bool WorldSocket::IsChatOpcode(uint16 opcode)
 {
     switch(opcode)
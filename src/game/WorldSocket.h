@@ -44,10 +44,13 @@
 
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
+#include "Database/QueryResult.h"
 
 class ACE_Message_Block;
 class WorldPacket;
 class WorldSession;
+class SqlQueryHolder;
+class WorldSocketAuthHolder;
 
 /// Handler that can communicate over stream sockets.
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
@@ -68,10 +71,15 @@ typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
  * written to the output buffer the socket is not immediately
  * activated for output (again for the same reason), there
  * is 10ms celling (thats why there is Update() method).
+ * With Network.FlushDelay the buffer is held back until its
+ * oldest packet waited that long or it is a quarter full,
+ * so the packets of several updates leave in one send().
  * This concept is similar to TCP_CORK, but TCP_CORK
  * uses 200ms celling. As result overhead generated by
  * sending packets from "producer" threads is minimal,
  * and doing a lot of writes with small size is tolerated.
+ * Headers are copied plain and encrypted together just
+ * before the buffer is sent, by the network thread.
  *
  * The calls to Update () method are managed by WorldSocketMgr
  * and ReactorRunnable.
@@ -126,6 +134,9 @@ class WorldSocket : protected WorldHandler
         /// Remove reference to this object.
         long RemoveReference (void);
 
+        /// Called from a network thread when account queries of CMSG_AUTH_SESSION are done.
+        void HandleAuthSessionCallback (QueryResultAutoPtr dummy, SqlQueryHolder* holder);
+
     protected:
         /// things called by ACE framework.
         WorldSocket (void);
@@ -165,9 +176,12 @@ class WorldSocket : protected WorldHandler
         /// @param new_pct received packet ,note that you need to delete it.
         int ProcessIncoming (WorldPacket* new_pct);
 
-        /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
+        /// Called by ProcessIncoming() on CMSG_AUTH_SESSION, starts account queries.
         int HandleAuthSession (WorldPacket& recvPacket);
 
+        /// Called by Update() with results of account queries, creates the session.
+        int CompleteAuthSession (WorldSocketAuthHolder& holder);
+
         /// Called by ProcessIncoming() on CMSG_PING.
         int HandlePing (WorldPacket& recvPacket);
 
@@ -175,6 +189,10 @@ class WorldSocket : protected WorldHandler
         /// Need to be called with m_OutBufferLock lock held
         int iSendPacket (const WorldPacket& pct);
 
+        /// Encrypt the headers written to m_OutBuffer since the last send, in order
+        /// Need to be called with m_OutBufferLock lock held
+        void iEncryptHeaders ();
+
         /// Flush m_PacketQueue if there are packets in it
         /// Need to be called with m_OutBufferLock lock held
         /// @return true if it wrote to the buffer (AKA you need
@@ -184,6 +202,12 @@ class WorldSocket : protected WorldHandler
         // Use to check if custom chat only client can use such opcode
         bool IsChatOpcode(uint16 opcode);
 
+        /// Called by ReactorRunnable, returns and resets the syscall counters.
+        void CollectStats (uint32& sends, uint32& recvs, uint32& packets);
+
+        /// Called by ReactorRunnable in the thread of the current reactor, registers the socket with target instead.
+        int MoveToReactor (ACE_Reactor* target);
+
     private:
         /// Time in which the last ping was received
         ACE_Time_Value m_LastPingTime;
@@ -223,6 +247,22 @@ class WorldSocket : protected WorldHandler
         /// Size of the m_OutBuffer.
         size_t m_OutBufferSize;
 
+        /// Milliseconds Update() lets m_OutBuffer fill before sending it, 0 sends at once.
+        uint32 m_OutFlushDelay;
+
+        /// Time the oldest packet in m_OutBuffer was written.
+        uint32 m_OutPendingSince;
+
+        /// Offsets of the headers in m_OutBuffer not encrypted yet.
+        std::vector<size_t> m_OutHeaders;
+
+        /// send() calls and packets written since the last CollectStats(), protected by m_OutBufferLock.
+        uint32 m_SendCalls;
+        uint32 m_SentPackets;
+
+        /// recv() calls since the last CollectStats(), network thread only.
+        uint32 m_RecvCalls;
+
         /// Here are stored packets for which there was no space on m_OutBuffer,
         /// this allows not-to kick player if its buffer is overflowed.
         PacketQueueT m_PacketQueue;
@@ -232,6 +272,12 @@ class WorldSocket : protected WorldHandler
 
         uint32 m_Seed;
 
+        /// True while account queries of CMSG_AUTH_SESSION run, network thread only.
+        bool m_AuthPending;
+
+        /// Finished account queries waiting for network thread, protected by m_SessionLock.
+        WorldSocketAuthHolder* m_AuthResult;
+
         uint8 operatingSystem; // stores client's operating system
 };
 
@@ -33,23 +33,30 @@
 #include <ace/Dev_Poll_Reactor.h>
 #include <ace/Guard_T.h>
 #include <ace/Atomic_Op.h>
+#include <ace/OS_NS_sys_time.h>
+#include <ace/OS_NS_unistd.h>
 #include <ace/os_include/arpa/os_inet.h>
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_types.h>
 #include <ace/os_include/sys/os_socket.h>
 
 #include <set>
+#include <vector>
+#include <algorithm>
 
 #include "Log.h"
 #include "Common.h"
 #include "Config/Config.h"
 #include "Database/DatabaseEnv.h"
+#include "Database/SqlOperations.h"
 #include "WorldSocket.h"
+#include "Timer.h"
 
 /**
 * This is a helper class to WorldSocketMgr ,that manages
 * network threads, and assigning connections from acceptor thread
-* to other network threads
+* to other network threads, and moving them later from busy
+* threads to quiet ones
 */
 class ReactorRunnable : protected ACE_Task_Base
 {
@@ -57,7 +64,19 @@ class ReactorRunnable : protected ACE_Task_Base
         ReactorRunnable() :
             m_Reactor (0),
             m_Connections (0),
-            m_ThreadId (-1)
+            m_ThreadId (-1),
+            m_Index (0),
+            m_UpdateInterval (10),
+            m_StatsInterval (0),
+            m_BalanceInterval (0),
+            m_Cpu (-1),
+            m_Load (0),
+            m_StatSends (0),
+            m_StatRecvs (0),
+            m_StatPackets (0),
+            m_StatIterations (0),
+            m_StatLoopTime (0),
+            m_StatLoopMax (0)
         {
             ACE_Reactor_Impl* imp = 0;
 
@@ -124,6 +143,23 @@ class ReactorRunnable : protected ACE_Task_Base
             return m_Reactor;
         }
 
+        /// Load measured at the last sample, socket reads and writes per second
+        long Load()
+        {
+            return static_cast<long> (m_Load.value());
+        }
+
+        /// Set before Start(): thread number, milliseconds between socket updates, between stats reports
+        /// and between load balancing rounds (0 for none), core to pin the thread to (-1 for none)
+        void Configure (size_t index, uint32 update, uint32 stats, uint32 balance, int cpu)
+        {
+            m_Index = index;
+            m_UpdateInterval = update;
+            m_StatsInterval = stats;
+            m_BalanceInterval = balance;
+            m_Cpu = cpu;
+        }
+
     protected:
         void AddNewSockets()
         {
@@ -148,6 +184,139 @@ class ReactorRunnable : protected ACE_Task_Base
             m_NewSockets.clear();
         }
 
+        void SetAffinity()
+        {
+            if (m_Cpu < 0)
+                return;
+
+            #if defined(WIN32)
+
+            if (!SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << m_Cpu))
+                sLog.outLog(LOG_DEFAULT, "ERROR: Can't pin network thread %u to processor %d", uint32(m_Index), m_Cpu);
+
+            #elif defined(__linux__)
+
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            CPU_SET(m_Cpu, &mask);
+
+            // pid 0 is the calling thread
+            if (sched_setaffinity(0, sizeof(mask), &mask))
+                sLog.outLog(LOG_DEFAULT, "ERROR: Can't pin network thread %u to processor %d", uint32(m_Index), m_Cpu);
+
+            #endif
+        }
+
+        /// Collects the counters of all sockets, measures the load of the thread and moves sockets
+        /// to the least loaded thread if asked and this one is clearly busier
+        void Sample(uint32 elapsed, bool balance)
+        {
+            typedef std::vector<std::pair<uint32, WorldSocket*> > SocketLoads;
+            SocketLoads loads;
+            loads.reserve(m_Sockets.size());
+
+            uint64 total = 0;
+
+            for (SocketSet::const_iterator i = m_Sockets.begin(); i != m_Sockets.end(); ++i)
+            {
+                uint32 sends, recvs, packets;
+                (*i)->CollectStats(sends, recvs, packets);
+
+                m_StatSends += sends;
+                m_StatRecvs += recvs;
+                m_StatPackets += packets;
+
+                total += sends + recvs;
+                loads.push_back(std::make_pair(sends + recvs, *i));
+            }
+
+            m_Load = elapsed ? long(total * IN_MILISECONDS / elapsed) : 0;
+
+            if (!balance)
+                return;
+
+            ReactorRunnable* target = sWorldSocketMgr->LeastLoadedThread();
+            if (!target || target == this)
+                return;
+
+            long load = m_Load.value();
+            long targetLoad = target->Load();
+
+            // leave small differences alone, moving sockets back and forth costs more
+            if (load < BALANCE_MIN_LOAD || load * 4 < targetLoad * 5)
+                return;
+
+            // half the difference makes both threads even
+            uint64 excess = uint64(load - targetLoad) * elapsed / (2 * IN_MILISECONDS);
+            uint64 moved = 0;
+            uint32 count = 0;
+
+            // quiet sockets first, one busy socket would just make the other thread the hot one
+            std::sort(loads.begin(), loads.end());
+
+            for (SocketLoads::const_iterator i = loads.begin(); i != loads.end() && count < BALANCE_MAX_MOVES; ++i)
+            {
+                if (moved + i->first > excess)
+                    break;
+
+                WorldSocket* sock = i->second;
+
+                // closing sockets finish in the reactor they are registered with
+                if (sock->IsClosed())
+                    continue;
+
+                m_Sockets.erase(sock);
+
+                if (sock->MoveToReactor(target->GetReactor()) == -1)
+                {
+                    sock->CloseSocket();
+                    sock->RemoveReference();
+                    --m_Connections;
+                    continue;
+                }
+
+                // the target takes its own reference
+                target->AddSocket(sock);
+                sock->RemoveReference();
+                --m_Connections;
+
+                moved += i->first;
+                ++count;
+            }
+
+            if (!count)
+                return;
+
+            long movedLoad = long(moved * IN_MILISECONDS / elapsed);
+            m_Load -= movedLoad;
+            target->m_Load += movedLoad;
+
+            DEBUG_LOG("Network thread %u moved %u connections to network thread %u", uint32(m_Index), count, uint32(target->m_Index));
+        }
+
+        void ReportStats(uint32 elapsed)
+        {
+            uint64 sends = m_StatSends, recvs = m_StatRecvs, packets = m_StatPackets;
+            uint64 iterations = m_StatIterations, loopTime = m_StatLoopTime, loopMax = m_StatLoopMax;
+
+            m_StatSends = m_StatRecvs = m_StatPackets = 0;
+            m_StatIterations = m_StatLoopTime = m_StatLoopMax = 0;
+
+            if (m_Sockets.empty() || !elapsed || !iterations)
+                return;
+
+            double perConnection = double(IN_MILISECONDS) / (double(elapsed) * m_Sockets.size());
+
+            sLog.outDetail("Network thread %u: %u connections, %.1f send and %.1f recv calls per second per connection, %.1f packets per send",
+                uint32(m_Index), uint32(m_Sockets.size()), sends * perConnection, recvs * perConnection,
+                sends ? double(packets) / sends : 0.0);
+
+            // time between two updates of a socket, how long buffered packets may wait at worst
+            sLog.outDetail("Network thread %u: %.0f events and %.0f loops per second, loop time %.2f ms average, %.2f ms max",
+                uint32(m_Index), double(sends + recvs) * IN_MILISECONDS / elapsed, double(iterations) * IN_MILISECONDS / elapsed,
+                double(loopTime) / iterations / 1000.0, double(loopMax) / 1000.0);
+        }
+
         virtual int svc()
         {
             DEBUG_LOG ("Network Thread Starting");
@@ -156,19 +325,29 @@ class ReactorRunnable : protected ACE_Task_Base
 
             ACE_ASSERT(m_Reactor);
 
+            SetAffinity();
+
             SocketSet::iterator i, t;
 
+            uint32 sampleTime = WorldTimer::getMSTime();
+            uint32 statsTime = sampleTime;
+            uint32 balanceTime = sampleTime;
+
+            ACE_Time_Value loopStart = ACE_OS::gettimeofday();
+
             while (!m_Reactor->reactor_event_loop_done())
             {
                 // dont be too smart to move this outside the loop
                 // the run_reactor_event_loop will modify interval
-                ACE_Time_Value interval (0, 10000);
+                ACE_Time_Value interval (0, m_UpdateInterval * 1000);
 
                 if (m_Reactor->run_reactor_event_loop (interval) == -1)
                     break;
 
                 AddNewSockets();
 
+                sWorldSocketMgr->m_AuthResults->Update();
+
                 for (i = m_Sockets.begin(); i != m_Sockets.end();)
                 {
                     if ((*i)->Update() == -1)
@@ -183,6 +362,38 @@ class ReactorRunnable : protected ACE_Task_Base
                     else
                         ++i;
                 }
+
+                ACE_Time_Value loopEnd = ACE_OS::gettimeofday();
+                ACE_Time_Value loopTime = loopEnd - loopStart;
+                loopStart = loopEnd;
+
+                uint64 loopUs = uint64(loopTime.sec()) * 1000000 + loopTime.usec();
+                ++m_StatIterations;
+                m_StatLoopTime += loopUs;
+                if (loopUs > m_StatLoopMax)
+                    m_StatLoopMax = loopUs;
+
+                if (!m_StatsInterval && !m_BalanceInterval)
+                    continue;
+
+                uint32 now = WorldTimer::getMSTime();
+                bool report = m_StatsInterval && WorldTimer::getMSTimeDiff(statsTime, now) >= m_StatsInterval;
+                bool balance = m_BalanceInterval && WorldTimer::getMSTimeDiff(balanceTime, now) >= m_BalanceInterval;
+
+                if (!report && !balance)
+                    continue;
+
+                Sample(WorldTimer::getMSTimeDiff(sampleTime, now), balance);
+                sampleTime = now;
+
+                if (balance)
+                    balanceTime = now;
+
+                if (report)
+                {
+                    ReportStats(WorldTimer::getMSTimeDiff(statsTime, now));
+                    statsTime = now;
+                }
             }
 
             GameDataDatabase.ThreadEnd();
@@ -200,6 +411,28 @@ class ReactorRunnable : protected ACE_Task_Base
         AtomicInt m_Connections;
         int m_ThreadId;
 
+        enum
+        {
+            BALANCE_MIN_LOAD    = 1000,                     // reads and writes per second
+            BALANCE_MAX_MOVES   = 32                        // connections moved per round
+        };
+
+        size_t m_Index;
+        uint32 m_UpdateInterval;
+        uint32 m_StatsInterval;
+        uint32 m_BalanceInterval;
+        int m_Cpu;
+
+        AtomicInt m_Load;
+
+        // counted since the last report, network thread only
+        uint64 m_StatSends;
+        uint64 m_StatRecvs;
+        uint64 m_StatPackets;
+        uint64 m_StatIterations;
+        uint64 m_StatLoopTime;                              // microseconds
+        uint64 m_StatLoopMax;
+
         SocketSet m_Sockets;
 
         SocketSet m_NewSockets;
@@ -212,7 +445,9 @@ WorldSocketMgr::WorldSocketMgr():
     m_SockOutKBuff(-1),
     m_SockOutUBuff(65536),
     m_UseNoDelay(true),
-    m_Acceptor(0)
+    m_FlushDelay(0),
+    m_Acceptor(0),
+    m_AuthResults(new SqlResultQueue)
 {
 }
 
@@ -223,6 +458,10 @@ WorldSocketMgr::~WorldSocketMgr()
 
     if(m_Acceptor)
         delete m_Acceptor;
+
+    // drop results of sockets still waiting, releases their references
+    m_AuthResults->Update();
+    delete m_AuthResults;
 }
 
 int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
@@ -254,6 +493,33 @@ int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
         return -1;
     }
 
+    int flush_delay = sConfig.GetIntDefault("Network.FlushDelay", 0);
+
+    if (flush_delay < 0 || flush_delay > 10)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: Network.FlushDelay is wrong in your config file");
+        return -1;
+    }
+
+    m_FlushDelay = static_cast<uint32> (flush_delay);
+
+    int stats_interval = sConfig.GetIntDefault("Network.StatsInterval", 0);
+    int balance_interval = sConfig.GetIntDefault("Network.BalanceInterval", 0);
+    bool affinity = sConfig.GetBoolDefault("Network.Affinity", false);
+
+    long cpus = ACE_OS::num_processors_online();
+
+    for (size_t i = 0; i < m_NetThreadsCount; ++i)
+    {
+        // one connection thread per core, the acceptor thread stays free
+        int cpu = affinity && i && cpus > 0 ? int((i - 1) % cpus) : -1;
+
+        // update the sockets often enough to keep the flush delay
+        m_NetThreads[i].Configure(i, m_FlushDelay ? m_FlushDelay : 10,
+            stats_interval > 0 ? stats_interval * IN_MILISECONDS : 0,
+            balance_interval > 0 ? balance_interval * IN_MILISECONDS : 0, cpu);
+    }
+
     WorldSocket::Acceptor* acc = new WorldSocket::Acceptor;
     m_Acceptor = acc;
 
@@ -335,6 +601,7 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
     }
 
     sock->m_OutBufferSize = static_cast<size_t> (m_SockOutUBuff);
+    sock->m_OutFlushDelay = m_FlushDelay;
 
     // we skip the Acceptor Thread
     size_t min = 1;
@@ -348,6 +615,21 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
     return m_NetThreads[min].AddSocket (sock);
 }
 
+ReactorRunnable* WorldSocketMgr::LeastLoadedThread()
+{
+    // we skip the Acceptor Thread
+    if (m_NetThreadsCount < 3)
+        return NULL;
+
+    size_t min = 1;
+
+    for (size_t i = 2; i < m_NetThreadsCount; ++i)
+        if (m_NetThreads[i].Load() < m_NetThreads[min].Load())
+            min = i;
+
+    return &m_NetThreads[min];
+}
+
 WorldSocketMgr* WorldSocketMgr::Instance()
 {
     return ACE_Singleton<WorldSocketMgr, ACE_Thread_Mutex>::instance();
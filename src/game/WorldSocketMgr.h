@@ -36,12 +36,14 @@
 class WorldSocket;
 class ReactorRunnable;
 class ACE_Event_Handler;
+class SqlResultQueue;
 
 /// Manages all sockets connected to peers and network threads
 class WorldSocketMgr
 {
     public:
         friend class WorldSocket;
+        friend class ReactorRunnable;
         friend class ACE_Singleton<WorldSocketMgr, ACE_Thread_Mutex>;
 
         /// Start network, listen at address:port .
@@ -60,6 +62,9 @@ class WorldSocketMgr
         int OnSocketOpen(WorldSocket* sock);
         int StartReactiveIO(ACE_UINT16 port, const char* address);
 
+        /// Connection thread with the lowest measured load, NULL if there is only one.
+        ReactorRunnable* LeastLoadedThread();
+
         WorldSocketMgr();
         virtual ~WorldSocketMgr();
 
@@ -69,11 +74,15 @@ class WorldSocketMgr
         int m_SockOutKBuff;
         int m_SockOutUBuff;
         bool m_UseNoDelay;
+        ACE_UINT32 m_FlushDelay;
 
         std::string m_addr;
         ACE_UINT16 m_port;
 
         ACE_Event_Handler* m_Acceptor;
+
+        /// Results of CMSG_AUTH_SESSION account queries, run by whichever network thread loops first
+        SqlResultQueue* m_AuthResults;
 };
 
 #define sWorldSocketMgr WorldSocketMgr::Instance()
@@ -23,8 +23,36 @@
 #include "MoveMap.h"
 #include "MoveMapSharedDefines.h"
 
+#include "../../dep/recastnavigation/Detour/Include/DetourNode.h"
+#include "../../dep/recastnavigation/Detour/Include/DetourCommon.h"
+
+#include <ace/TSS_T.h>
+
 namespace MMAP
 {
+    // queries created by current thread, mapId to query
+    struct ThreadNavMeshQuery
+    {
+        uint32 serial;
+        dtNavMeshQuery* query;
+    };
+
+    struct ThreadNavMeshQueries
+    {
+        UNORDERED_MAP<uint32, ThreadNavMeshQuery> queries;
+    };
+
+    static ACE_TSS<ThreadNavMeshQueries> threadNavMeshQueries;
+
+    // detour doesn't report query size, sum of node pools and open list allocated by dtNavMeshQuery::init
+    static uint32 NavMeshQueryMemory(int maxNodes)
+    {
+        return sizeof(dtNavMeshQuery) +
+            sizeof(dtNodePool) + (sizeof(dtNode) + sizeof(unsigned short)) * maxNodes + sizeof(unsigned short) * dtNextPow2(maxNodes / 4) +
+            sizeof(dtNodePool) + (sizeof(dtNode) + sizeof(unsigned short)) * 64 + sizeof(unsigned short) * 32 +
+            sizeof(dtNodeQueue) + sizeof(dtNode*) * (maxNodes + 1);
+    }
+
     // ######################## MMapFactory ########################
     // our global singelton copy
     MMapManager *g_MMapManager = NULL;
@@ -93,8 +121,14 @@ namespace MMAP
 
         sLog.outDetail("MMAP:loadMapData: Loaded %03i.mmap", mapId);
 
+        uint32 serial;
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, queryLock, false);
+            serial = ++lastMapSerial;
+        }
+
         // store inside our map list
-        MMapData* mmap_data = new MMapData(mesh);
+        MMapData* mmap_data = new MMapData(mesh, serial);
         mmap_data->mmapLoadedTiles.clear();
 
         loadedMMaps.insert(std::pair<uint32, MMapData*>(mapId, mmap_data));
@@ -258,35 +292,15 @@ namespace MMAP
             }
         }
 
-        delete mmap;
-        loadedMMaps.erase(mapId);
-        sLog.outDetail("MMAP:unloadMap: Unloaded %03i.mmap", mapId);
-
-        return true;
-    }
-
-    bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
-    {
-        // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-        {
-            // file may not exist, therefore not loaded
-            sLog.outDebug("MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
-            return false;
-        }
-
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
         {
-            sLog.outDebug("MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-            return false;
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, queryLock, false);
+            navMeshQueryCount -= mmap->navMeshQueries.size();
+            navMeshQueryMemory -= uint64(mmap->navMeshQueries.size()) * NavMeshQueryMemory(MMAP_QUERY_MAX_NODES);
         }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
-        sLog.outDetail("MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
+        delete mmap;
+        loadedMMaps.erase(mapId);
+        sLog.outDetail("MMAP:unloadMap: Unloaded %03i.mmap", mapId);
 
         return true;
     }
@@ -299,28 +313,42 @@ namespace MMAP
         return loadedMMaps[mapId]->navMesh;
     }
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
+    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
             return NULL;
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        MMapData* mmap = itr->second;
+
+        // query cached by this thread is valid until its map is unloaded
+        ThreadNavMeshQuery& cached = threadNavMeshQueries->queries[mapId];
+        if (cached.query && cached.serial == mmap->serial)
+            return cached.query;
+
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        ASSERT(query);
+        if (DT_SUCCESS != query->init(mmap->navMesh, MMAP_QUERY_MAX_NODES))
         {
-             // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            ASSERT(query);
-            if(DT_SUCCESS != query->init(mmap->navMesh, 1024))
-            {
-                dtFreeNavMeshQuery(query);
-                sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-                return NULL;
-            }
+            dtFreeNavMeshQuery(query);
+            cached.query = NULL;
+            sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u", mapId);
+            return NULL;
+        }
 
-            sLog.outDetail("MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+        uint32 queryCount;
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, queryLock, NULL);
+            mmap->navMeshQueries.push_back(query);
+            queryCount = ++navMeshQueryCount;
+            navMeshQueryMemory += NavMeshQueryMemory(MMAP_QUERY_MAX_NODES);
         }
 
-        return mmap->navMeshQueries[instanceId];
+        cached.serial = mmap->serial;
+        cached.query = query;
+
+        sLog.outDetail("MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u, %u queries in all threads", mapId, queryCount);
+        return query;
     }
 }
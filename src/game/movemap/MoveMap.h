@@ -21,6 +21,9 @@
 
 #include "Utilities/UnorderedMap.h"
 
+#include <ace/Thread_Mutex.h>
+#include <vector>
+
 #include "../../dep/recastnavigation/Detour/Include/DetourAlloc.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMesh.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMeshQuery.h"
@@ -40,25 +43,29 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef UNORDERED_MAP<uint32, dtTileRef> MMapTileSet;
-    typedef UNORDERED_MAP<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::vector<dtNavMeshQuery*> NavMeshQueryList;
+
+    // node pool size of every dtNavMeshQuery
+    #define MMAP_QUERY_MAX_NODES    1024
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh, uint32 id) : navMesh(mesh), serial(id) {}
         ~MMapData()
         {
-            for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
-                dtFreeNavMeshQuery(i->second);
+            for (NavMeshQueryList::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
+                dtFreeNavMeshQuery(*i);
 
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
 
         dtNavMesh* navMesh;
+        uint32 serial;                      // unique for every loaded mmap, invalidates thread query caches
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // dtNavMeshQuery is not thread safe, every thread gets its own query for all instances of the map
+        NavMeshQueryList navMeshQueries;    // queries of all threads, owned here
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
     };
 
@@ -70,26 +77,32 @@ namespace MMAP
     class MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0) {}
+            MMapManager() : loadedTiles(0), lastMapSerial(0), navMeshQueryCount(0), navMeshQueryMemory(0) {}
             ~MMapManager();
 
             bool loadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // the returned [dtNavMeshQuery const*] belongs to calling thread, don't keep it between map updates
+            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+            uint32 getNavMeshQueryCount() const { return navMeshQueryCount; }
+            uint64 getNavMeshQueryMemory() const { return navMeshQueryMemory; }
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
 
             MMapDataSet loadedMMaps;
             uint32 loadedTiles;
+
+            ACE_Thread_Mutex queryLock;     // guards query lists and counters below
+            uint32 lastMapSerial;
+            uint32 navMeshQueryCount;
+            uint64 navMeshQueryMemory;
     };
 
     // static class
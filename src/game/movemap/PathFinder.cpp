@@ -20,6 +20,8 @@
 #include "GridMap.h"
 #include "Creature.h"
 #include "PathFinder.h"
+#include "PathService.h"
+#include "Map.h"
 #include "Log.h"
 
 #include "../recastnavigation/Detour/Include/DetourCommon.h"
@@ -27,7 +29,7 @@
 ////////////////// PathFinder //////////////////
 PathFinder::PathFinder(const Unit* owner) :
 m_polyLength(0), m_type(PATHFIND_BLANK),
-    m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
+    m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH), m_shareCorridors(false),
     m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL)
 {
     //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
@@ -43,7 +45,6 @@ m_polyLength(0), m_type(PATHFIND_BLANK),
         uint32 mapId = m_sourceUnit->GetMapId();
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
     }
 
     createFilter();
@@ -70,6 +71,10 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     m_forceDestination = forceDest;
 
+    // queries belong to threads, map may be updated by other thread than last time
+    if (m_navMesh)
+        m_navMeshQuery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(m_sourceUnit->GetMapId());
+
     //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
 
     // make sure navMesh works - we can run on map w/o mmap
@@ -353,14 +358,13 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
 
         // generate suffix
         uint32 suffixPolyLength = 0;
-        dtStatus dtResult = m_navMeshQuery->findPath(
+        dtStatus dtResult = findPolyPath(
             suffixStartPoly,    // start polygon
             endPoly,            // end polygon
             suffixEndPoint,     // start position
             endPoint,           // end position
-            &m_filter,            // polygon search filter
             m_pathPolyRefs + prefixPolyLength - 1,    // [out] path
-            (int*)&suffixPolyLength,
+            &suffixPolyLength,
             MAX_PATH_LENGTH-prefixPolyLength);   // max number of polygons in output path
 
         if (!suffixPolyLength || dtResult != DT_SUCCESS)
@@ -387,14 +391,13 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
         // free and invalidate old path data
         clear();
 
-        dtStatus dtResult = m_navMeshQuery->findPath(
+        dtStatus dtResult = findPolyPath(
             startPoly,          // start polygon
             endPoly,            // end polygon
             startPoint,         // start position
             endPoint,           // end position
-            &m_filter,           // polygon search filter
             m_pathPolyRefs,     // [out] path
-            (int*)&m_polyLength,
+            &m_polyLength,
             MAX_PATH_LENGTH);   // max number of polygons in output path
 
         if (!m_polyLength || dtResult != DT_SUCCESS)
@@ -417,6 +420,34 @@ void PathFinder::BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos)
     BuildPointPath(startPoint, endPoint);
 }
 
+dtStatus PathFinder::findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint,
+                                  dtPolyRef* path, uint32* pathLength, uint32 maxPathLength)
+{
+    // units chasing on the same map share recently found corridors
+    PathService* service = m_sourceUnit->IsInWorld() ? &m_sourceUnit->GetMap()->GetPathService() : NULL;
+    uint16 includeFlags = m_filter.getIncludeFlags();
+    uint16 excludeFlags = m_filter.getExcludeFlags();
+
+    if (service && m_shareCorridors && service->FindCorridor(m_navMesh, startPoly, endPoly, includeFlags, excludeFlags, path, *pathLength, maxPathLength))
+        return DT_SUCCESS;
+
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+
+    dtStatus dtResult = m_navMeshQuery->findPath(startPoly, endPoly, startPoint, endPoint, &m_filter, path, (int*)pathLength, maxPathLength);
+
+    if (service)
+    {
+        ACE_Time_Value spent = ACE_OS::gettimeofday() - start;
+        service->CountReplan(uint64(spent.sec()) * 1000000 + spent.usec());
+
+        // partial corridors are not reusable
+        if (m_shareCorridors && dtResult == DT_SUCCESS && *pathLength && path[*pathLength - 1] == endPoly)
+            service->StoreCorridor(path, *pathLength, includeFlags, excludeFlags);
+    }
+
+    return dtResult;
+}
+
 void PathFinder::BuildPointPath(const float *startPoint, const float *endPoint)
 {
     float pathPoints[MAX_POINT_PATH_LENGTH*VERTEX_SIZE];
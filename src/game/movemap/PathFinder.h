@@ -68,6 +68,7 @@ class PathFinder
         // option setters - use optional
         void setUseStrightPath(bool useStraightPath) { m_useStraightPath = useStraightPath; };
         void setPathLengthLimit(float distance) { m_pointPathLimit = std::min<uint32>(uint32(distance/SMOOTH_PATH_STEP_SIZE), MAX_POINT_PATH_LENGTH); };
+        void setShareCorridors(bool shareCorridors) { m_shareCorridors = shareCorridors; };
 
         // result getters
         Vector3 getStartPosition()      const { return m_startPosition; }
@@ -88,6 +89,7 @@ class PathFinder
         bool           m_useStraightPath;  // type of path will be generated
         bool           m_forceDestination; // when set, we will always arrive at given point
         uint32         m_pointPathLimit;   // limit point path size; min(this, MAX_POINT_PATH_LENGTH)
+        bool           m_shareCorridors;   // reuse and store poly corridors in map's PathService
 
         Vector3        m_startPosition;    // {x, y, z} of current location
         Vector3        m_endPosition;      // {x, y, z} of the destination
@@ -118,6 +120,8 @@ class PathFinder
         bool HaveTile(const Vector3 &p) const;
 
         void BuildPolyPath(const Vector3 &startPos, const Vector3 &endPos);
+        dtStatus findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint,
+                              dtPolyRef* path, uint32* pathLength, uint32 maxPathLength);
         void BuildPointPath(const float *startPoint, const float *endPoint);
 
         void NormalizePath();
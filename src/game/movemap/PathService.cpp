@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2005-2012 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PathService.h"
+#include "Map.h"
+#include "Unit.h"
+#include "MovementGenerator.h"
+#include "World.h"
+
+PathService::PathService() : m_clock(0), m_purgeTimer(PATH_SERVICE_PURGE_INTERVAL),
+    m_lastQueuedTicket(0), m_lastProcessedTicket(0)
+{
+}
+
+bool PathService::FindCorridor(dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, uint16 excludeFlags,
+    dtPolyRef* path, uint32& pathLength, uint32 maxPathLength)
+{
+    uint32 lifetime = sWorld.getConfig(CONFIG_PATHFINDING_CACHE_LIFETIME);
+    if (!lifetime)
+        return false;
+
+    CorridorMap::const_iterator itr = m_corridors.find(endPoly);
+    if (itr == m_corridors.end())
+        return false;
+
+    for (CorridorList::const_iterator corridor = itr->second.begin(); corridor != itr->second.end(); ++corridor)
+    {
+        if (corridor->includeFlags != includeFlags || corridor->excludeFlags != excludeFlags)
+            continue;
+
+        if (m_clock - corridor->storeTime > lifetime)
+            continue;
+
+        // sub-path of optimal path is optimal, so any corridor passing our poly will do
+        std::vector<dtPolyRef>::const_iterator start = std::find(corridor->polys.begin(), corridor->polys.end(), startPoly);
+        if (start == corridor->polys.end())
+            continue;
+
+        uint32 length = corridor->polys.end() - start;
+        if (length > maxPathLength)
+            continue;
+
+        // tiles may be unloaded since corridor was stored
+        bool valid = true;
+        for (std::vector<dtPolyRef>::const_iterator poly = start; poly != corridor->polys.end(); ++poly)
+        {
+            if (!navMesh->isValidPolyRef(*poly))
+            {
+                valid = false;
+                break;
+            }
+        }
+
+        if (!valid)
+            continue;
+
+        std::copy(start, corridor->polys.end(), path);
+        pathLength = length;
+
+        ++m_counters.cacheHits;
+        return true;
+    }
+
+    return false;
+}
+
+void PathService::StoreCorridor(dtPolyRef const* path, uint32 pathLength, uint16 includeFlags, uint16 excludeFlags)
+{
+    uint32 lifetime = sWorld.getConfig(CONFIG_PATHFINDING_CACHE_LIFETIME);
+    if (!lifetime || pathLength < 2)
+        return;
+
+    CorridorList& corridors = m_corridors[path[pathLength - 1]];
+
+    Corridor* slot = NULL;
+    if (corridors.size() < PATH_SERVICE_CORRIDORS_PER_END)
+    {
+        corridors.push_back(Corridor());
+        slot = &corridors.back();
+    }
+    else
+    {
+        slot = &corridors.front();
+        for (CorridorList::iterator itr = corridors.begin(); itr != corridors.end(); ++itr)
+            if (int32(itr->storeTime - slot->storeTime) < 0)
+                slot = &*itr;
+    }
+
+    slot->polys.assign(path, path + pathLength);
+    slot->includeFlags = includeFlags;
+    slot->excludeFlags = excludeFlags;
+    slot->storeTime = m_clock;
+}
+
+uint32 PathService::QueueRequest(uint64 guid)
+{
+    // ticket 0 means no request
+    if (!++m_lastQueuedTicket)
+        ++m_lastQueuedTicket;
+
+    Request request;
+    request.guid = guid;
+    request.ticket = m_lastQueuedTicket;
+    m_requests.push_back(request);
+
+    return request.ticket;
+}
+
+void PathService::Update(Map& map, uint32 diff)
+{
+    m_clock += diff;
+
+    if (m_purgeTimer <= diff)
+    {
+        PurgeCorridors();
+        m_purgeTimer = PATH_SERVICE_PURGE_INTERVAL;
+    }
+    else
+        m_purgeTimer -= diff;
+
+    ProcessRequests(map);
+
+    // counters collected since previous map update, including in place path calculations
+    m_countersLastTick = m_counters;
+    m_countersTotal.Add(m_counters);
+    m_counters = PathServiceCounters();
+}
+
+void PathService::ProcessRequests(Map& map)
+{
+    if (m_requests.empty())
+        return;
+
+    uint64 budget = uint64(sWorld.getConfig(CONFIG_PATHFINDING_BATCH_BUDGET)) * 1000;
+    uint64 elapsed = 0;
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+
+    // requests queued while processing this batch wait for next update
+    uint32 lastTicket = m_lastQueuedTicket;
+    uint32 processed = 0;
+
+    while (!m_requests.empty() && int32(m_requests.front().ticket - lastTicket) <= 0)
+    {
+        // at least one request is processed every update, budget 0 drains the queue
+        if (budget && processed && elapsed >= budget)
+            break;
+
+        Request request = m_requests.front();
+        m_requests.pop_front();
+        m_lastProcessedTicket = request.ticket;
+        ++processed;
+
+        Unit* unit = map.GetUnit(request.guid);
+        if (unit && unit->IsInWorld() && unit->GetMap() == &map)
+        {
+            MotionMaster* motion = unit->GetMotionMaster();
+            MovementGeneratorType type = motion->GetCurrentMovementGeneratorType();
+            if (type == CHASE_MOTION_TYPE || type == FOLLOW_MOTION_TYPE)
+                motion->top()->ProcessPathRequest(*unit);
+        }
+
+        ACE_Time_Value spent = ACE_OS::gettimeofday() - start;
+        elapsed = uint64(spent.sec()) * 1000000 + spent.usec();
+    }
+
+    m_counters.requests += processed;
+    m_counters.deferred = m_requests.size();
+    m_counters.batchTime += elapsed;
+}
+
+void PathService::PurgeCorridors()
+{
+    uint32 lifetime = sWorld.getConfig(CONFIG_PATHFINDING_CACHE_LIFETIME);
+
+    for (CorridorMap::iterator itr = m_corridors.begin(); itr != m_corridors.end();)
+    {
+        CorridorList& corridors = itr->second;
+        for (CorridorList::iterator corridor = corridors.begin(); corridor != corridors.end();)
+        {
+            if (m_clock - corridor->storeTime > lifetime)
+                corridor = corridors.erase(corridor);
+            else
+                ++corridor;
+        }
+
+        if (corridors.empty())
+            m_corridors.erase(itr++);
+        else
+            ++itr;
+    }
+}
+
+uint32 PathService::GetCachedCorridorCount() const
+{
+    uint32 count = 0;
+    for (CorridorMap::const_iterator itr = m_corridors.begin(); itr != m_corridors.end(); ++itr)
+        count += itr->second.size();
+
+    return count;
+}
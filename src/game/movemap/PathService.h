@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2005-2012 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATH_SERVICE_H
+#define MANGOS_PATH_SERVICE_H
+
+#include "Common.h"
+#include "Utilities/UnorderedMap.h"
+#include "../recastnavigation/Detour/Include/DetourNavMesh.h"
+
+#include <deque>
+
+class Map;
+
+// corridors kept per end polygon, oldest one is replaced
+#define PATH_SERVICE_CORRIDORS_PER_END  8
+// how often expired corridors are dropped
+#define PATH_SERVICE_PURGE_INTERVAL     5000
+
+struct PathServiceCounters
+{
+    PathServiceCounters() : requests(0), deferred(0), cacheHits(0), replans(0), batchTime(0), replanTime(0) {}
+
+    uint32 requests;                                        // batched path requests processed
+    uint32 deferred;                                        // requests left for next tick, budget exceeded
+    uint32 cacheHits;                                       // poly corridors taken from cache
+    uint32 replans;                                         // findPath calls
+    uint64 batchTime;                                       // microseconds spent processing batched requests
+    uint64 replanTime;                                      // microseconds spent in findPath
+
+    void Add(PathServiceCounters const& other)
+    {
+        requests += other.requests;
+        deferred += other.deferred;
+        cacheHits += other.cacheHits;
+        replans += other.replans;
+        batchTime += other.batchTime;
+        replanTime += other.replanTime;
+    }
+};
+
+/// Per map helper of PathFinder, must only be used from the map update thread.
+/// Keeps recently found poly corridors, so units chasing the same target reuse
+/// the corridor of the unit that planned first (from the poly they stand on),
+/// and queues target movement path updates processed in one batch per map
+/// update within configured time budget.
+class PathService
+{
+    public:
+        PathService();
+
+        // poly corridor cache, filter flags are part of the key
+        bool FindCorridor(dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, uint16 excludeFlags,
+            dtPolyRef* path, uint32& pathLength, uint32 maxPathLength);
+        void StoreCorridor(dtPolyRef const* path, uint32 pathLength, uint16 includeFlags, uint16 excludeFlags);
+
+        void CountReplan(uint64 time) { ++m_counters.replans; m_counters.replanTime += time; }
+
+        // batched requests, ticket is pending until IsPending returns false
+        uint32 QueueRequest(uint64 guid);
+        bool IsPending(uint32 ticket) const { return ticket && int32(ticket - m_lastProcessedTicket) > 0; }
+
+        void Update(Map& map, uint32 diff);
+
+        PathServiceCounters const& GetCountersLastTick() const { return m_countersLastTick; }
+        PathServiceCounters const& GetCountersTotal() const { return m_countersTotal; }
+        uint32 GetCachedCorridorCount() const;
+
+    private:
+        struct Corridor
+        {
+            std::vector<dtPolyRef> polys;
+            uint16 includeFlags;
+            uint16 excludeFlags;
+            uint32 storeTime;
+        };
+
+        struct Request
+        {
+            uint64 guid;
+            uint32 ticket;
+        };
+
+        typedef std::vector<Corridor> CorridorList;
+        typedef UNORDERED_MAP<dtPolyRef, CorridorList> CorridorMap;
+
+        void ProcessRequests(Map& map);
+        void PurgeCorridors();
+
+        CorridorMap m_corridors;
+        uint32 m_clock;
+        uint32 m_purgeTimer;
+
+        std::deque<Request> m_requests;
+        uint32 m_lastQueuedTicket;
+        uint32 m_lastProcessedTicket;
+
+        PathServiceCounters m_counters;
+        PathServiceCounters m_countersLastTick;
+        PathServiceCounters m_countersTotal;
+};
+
+#endif
@@ -931,8 +931,8 @@ void ScriptedAI::DoResetThreat()
         return;
     }
 
-    std::list<HostilReference*>& m_threatlist = m_creature->getThreatManager().getThreatList();
-    std::list<HostilReference*>::iterator itr;
+    std::list<HostilReference*> const& m_threatlist = m_creature->getThreatManager().getThreatList();
+    std::list<HostilReference*>::const_iterator itr;
 
     for(itr = m_threatlist.begin(); itr != m_threatlist.end(); ++itr)
     {
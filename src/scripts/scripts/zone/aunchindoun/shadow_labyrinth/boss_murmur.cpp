@@ -72,8 +72,8 @@ struct boss_murmurAI : public Scripted_NoMovementAI
     {
         if (target && target->isAlive() && spell && spell->Id == 38794)
         {
-            std::list<HostilReference*>& m_threatlist = me->getThreatManager().getThreatList();
-            for(std::list<HostilReference*>::iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
+            std::list<HostilReference*> const& m_threatlist = me->getThreatManager().getThreatList();
+            for(std::list<HostilReference*>::const_iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
             {
                 if (Unit* targets = Unit::GetUnit((*me),(*i)->getUnitGuid()))
                 {
@@ -121,8 +121,8 @@ struct boss_murmurAI : public Scripted_NoMovementAI
             // Thundering Storm cast to all which are too far away
             if (ThunderingStorm_Timer < diff)
             {
-                std::list<HostilReference*>& m_threatlist = me->getThreatManager().getThreatList();
-                for(std::list<HostilReference*>::iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
+                std::list<HostilReference*> const& m_threatlist = me->getThreatManager().getThreatList();
+                for(std::list<HostilReference*>::const_iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
                 {
                     if (Unit* target = Unit::GetUnit((*me),(*i)->getUnitGuid()))
                     {
@@ -139,8 +139,8 @@ struct boss_murmurAI : public Scripted_NoMovementAI
             // Sonic Shock cast to tank if someone is too far away
             if (SonicShock_Timer < diff)
             {
-                std::list<HostilReference*>& m_threatlist = me->getThreatManager().getThreatList();
-                for(std::list<HostilReference*>::iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
+                std::list<HostilReference*> const& m_threatlist = me->getThreatManager().getThreatList();
+                for(std::list<HostilReference*>::const_iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
                 {
                     if (Unit* target = Unit::GetUnit((*me),(*i)->getUnitGuid()))
                     {
@@ -193,8 +193,8 @@ struct boss_murmurAI : public Scripted_NoMovementAI
 
         if (!me->IsWithinMeleeRange(me->getVictim()))
         {
-            std::list<HostilReference*>& m_threatlist = me->getThreatManager().getThreatList();
-            for(std::list<HostilReference*>::iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
+            std::list<HostilReference*> const& m_threatlist = me->getThreatManager().getThreatList();
+            for(std::list<HostilReference*>::const_iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
             {
                 if (Unit* target = Unit::GetUnit((*me),(*i)->getUnitGuid()))
                 {
@@ -71,8 +71,8 @@ struct boss_azuregosAI : public ScriptedAI
         if(Teleport_Timer < diff)
         {
             DoScriptText(SAY_TELEPORT, m_creature);
-            std::list<HostilReference*>& m_threatlist = m_creature->getThreatManager().getThreatList();
-            std::list<HostilReference*>::iterator i = m_threatlist.begin();
+            std::list<HostilReference*> const& m_threatlist = m_creature->getThreatManager().getThreatList();
+            std::list<HostilReference*>::const_iterator i = m_threatlist.begin();
             for (i = m_threatlist.begin(); i!= m_threatlist.end();++i)
             {
                 Unit* pUnit = Unit::GetUnit((*m_creature), (*i)->getUnitGuid());
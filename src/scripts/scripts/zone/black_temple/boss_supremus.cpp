@@ -172,8 +172,8 @@ struct boss_supremusAI : public ScriptedAI
         uint32 health = 0;
         Unit* target = NULL;
 
-        std::list<HostilReference*>& m_threatlist = m_creature->getThreatManager().getThreatList();
-        std::list<HostilReference*>::iterator i = m_threatlist.begin();
+        std::list<HostilReference*> const& m_threatlist = m_creature->getThreatManager().getThreatList();
+        std::list<HostilReference*>::const_iterator i = m_threatlist.begin();
         for (i = m_threatlist.begin(); i!= m_threatlist.end();++i)
         {
             Unit* pUnit = Unit::GetUnit((*m_creature), (*i)->getUnitGuid());
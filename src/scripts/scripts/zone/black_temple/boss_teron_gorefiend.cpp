@@ -429,8 +429,8 @@ struct boss_teron_gorefiendAI : public ScriptedAI
     {
         if(!Blossom) return;
 
-        std::list<HostilReference*>& m_threatlist = m_creature->getThreatManager().getThreatList();
-        std::list<HostilReference*>::iterator i = m_threatlist.begin();
+        std::list<HostilReference*> const& m_threatlist = m_creature->getThreatManager().getThreatList();
+        std::list<HostilReference*>::const_iterator i = m_threatlist.begin();
         for(i = m_threatlist.begin(); i != m_threatlist.end(); i++)
         {
             Unit* pUnit = Unit::GetUnit((*m_creature), (*i)->getUnitGuid());
@@ -646,8 +646,8 @@ struct boss_high_nethermancer_zerevorAI : public illidari_council_baseAI
 
         if (m_aexpTimer < diff)
         {
-            std::list<HostilReference*>& m_threatlist = me->getThreatManager().getThreatList();
-            for (std::list<HostilReference*>::iterator i = m_threatlist.begin(); i!= m_threatlist.end();++i)
+            std::list<HostilReference*> const& m_threatlist = me->getThreatManager().getThreatList();
+            for (std::list<HostilReference*>::const_iterator i = m_threatlist.begin(); i!= m_threatlist.end();++i)
             {
                 if (Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid()))
                 {
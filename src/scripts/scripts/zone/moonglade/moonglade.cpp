@@ -1203,7 +1203,7 @@ public:
                         CAST_AI(npc_remulosAI, pRemulos->AI())->SetEscortPaused(false);
                     }
                     DoScriptText(ERANIKUS_YELL_10, me);
-                    for (std::set<Unit*>::const_iterator itr = me->getAttackers().begin(); itr != me->getAttackers().end(); ++itr)
+                    for (Unit::AttackerSet::const_iterator itr = me->getAttackers().begin(); itr != me->getAttackers().end(); ++itr)
                     {
                         float collision = (float)urand(-8, 8);
                         uint32 r = urand(0, 1) ? 1 : 0;
@@ -583,7 +583,7 @@ struct boss_headless_horsemanAI : public ScriptedAI
             caster->GetMotionMaster()->Clear(false);
             caster->GetMotionMaster()->MoveFollow(m_creature,6,rand()%6);
             //DoResetThreat();//not sure if need
-            std::list<HostilReference*>::iterator itr;
+            std::list<HostilReference*>::const_iterator itr;
             for(itr = caster->getThreatManager().getThreatList().begin(); itr != caster->getThreatManager().getThreatList().end(); ++itr)
             {
                 Unit* pUnit = Unit::GetUnit((*m_creature), (*itr)->getUnitGuid());
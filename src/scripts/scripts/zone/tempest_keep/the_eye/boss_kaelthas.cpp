@@ -1160,7 +1160,7 @@ struct boss_kaelthasAI : public ScriptedAI
                     //GravityLapse_Timer
                     if(GravityLapse_Timer < diff)
                     {
-                        std::list<HostilReference*>::iterator iter = m_creature->getThreatManager().getThreatList().begin();
+                        std::list<HostilReference*>::const_iterator iter = m_creature->getThreatManager().getThreatList().begin();
                         uint32 glapse_teleport_id = 35966;
 
                         float X, Y, Z;
@@ -1597,8 +1597,8 @@ struct boss_grand_astromancer_capernianAI : public advisorbase_ai
         if(ArcaneExplosion_Timer < diff)
         {
             bool InMeleeRange = false;
-            std::list<HostilReference*>& m_threatlist = m_creature->getThreatManager().getThreatList();
-            for (std::list<HostilReference*>::iterator i = m_threatlist.begin(); i!= m_threatlist.end();++i)
+            std::list<HostilReference*> const& m_threatlist = m_creature->getThreatManager().getThreatList();
+            for (std::list<HostilReference*>::const_iterator i = m_threatlist.begin(); i!= m_threatlist.end();++i)
             {
                 Unit* pUnit = Unit::GetUnit((*m_creature), (*i)->getUnitGuid());
                                                             //if in melee range
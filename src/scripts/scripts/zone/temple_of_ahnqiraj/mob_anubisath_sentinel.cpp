@@ -280,7 +280,7 @@ struct aqsentinelAI : public ScriptedAI
 
     Unit *GetHatedManaUser()
     {
-        std::list<HostilReference*>::iterator i;
+        std::list<HostilReference*>::const_iterator i;
         for (i = m_creature->getThreatManager().getThreatList().begin();i != m_creature->getThreatManager().getThreatList().end(); ++i)
         {
             Unit* pUnit = Unit::GetUnit((*m_creature), (*i)->getUnitGuid());
@@ -176,6 +176,9 @@ class Database
             bool DelayQueryHolder(Class *object, void (Class::*method)(QueryResultAutoPtr, SqlQueryHolder*), SqlQueryHolder *holder);
         template<class Class, typename ParamType1>
             bool DelayQueryHolder(Class *object, void (Class::*method)(QueryResultAutoPtr, SqlQueryHolder*, ParamType1), SqlQueryHolder *holder, ParamType1 param1);
+        // QueryHolder with callback queued to 'queue' instead of the one of ProcessResultQueue()
+        template<class Class>
+            bool DelayQueryHolder(SqlResultQueue *queue, Class *object, void (Class::*method)(QueryResultAutoPtr, SqlQueryHolder*), SqlQueryHolder *holder);
 
         bool Execute(const char *sql);
         bool PExecute(const char *format,...) ATTR_PRINTF(2,3);
@@ -186,6 +189,8 @@ class Database
         bool BeginTransaction();
         bool CommitTransaction();
         bool RollbackTransaction();
+        //true if BeginTransaction() was called in this thread and not yet committed or rolled back
+        bool InTransaction() { return m_TransStorage->get() != NULL; }
         //for sync transaction execution
         bool CommitTransactionDirect();
 
@@ -181,6 +181,14 @@ Database::DelayQueryHolder(Class *object, void (Class::*method)(QueryResultAutoP
     return holder->Execute(new Looking4group::QueryCallback<Class, SqlQueryHolder*, ParamType1>(object, method, (QueryResultAutoPtr)NULL, holder, param1), m_threadBody, m_pResultQueue);
 }
 
+template<class Class>
+bool
+Database::DelayQueryHolder(SqlResultQueue *queue, Class *object, void (Class::*method)(QueryResultAutoPtr, SqlQueryHolder*), SqlQueryHolder *holder)
+{
+    if (!holder || !queue) return false;
+    return holder->Execute(new Looking4group::QueryCallback<Class, SqlQueryHolder*>(object, method, (QueryResultAutoPtr)NULL, holder), m_threadBody, queue);
+}
+
 #undef ASYNC_QUERY_BODY
 #undef ASYNC_PQUERY_BODY
 #undef ASYNC_DELAYHOLDER_BODY
@@ -21,11 +21,13 @@
 
 #include "Common.h"
 #include "Database/DatabaseEnv.h"
+#include "Database/SQLStorageSnapshot.h"
 
 class SQLStorage
 {
     template<class T>
     friend struct SQLStorageLoaderBase;
+    friend class SQLStorageSnapshot;
 
     public:
 
@@ -109,6 +111,10 @@ struct SQLStorageLoaderBase
             void convert_from_str(uint32 field_pos, char* src, D& dst);
         void convert_str_to_str(uint32 field_pos, char* src, char *&dst);
     private:
+        template<class R>
+            void loadRecord(SQLStorage &store, R &row, char *p);
+        bool loadFromSnapshot(SQLStorage &store, SQLStorageSnapshot &snapshot, uint32 recordsize);
+
         template<class V>
             void storeValue(V value, SQLStorage &store, char *p, uint32 x, uint32 &offset);
         void storeValue(char const* value, SQLStorage &store, char *p, uint32 x, uint32 &offset);
@@ -120,11 +120,152 @@ void SQLStorageLoaderBase<T>::storeValue(char const* value, SQLStorage &store, c
     }
 }
 
+// current query row, raw values are copied into snapshot when it's going to be saved
+struct SQLStorageQueryRow
+{
+    SQLStorageQueryRow(Field *f, SQLStorageSnapshot *s) : fields(f), snapshot(s) {}
+
+    bool GetBool(uint32 x)
+    {
+        bool value = fields[x].GetUInt32() > 0;
+        if (snapshot)
+            snapshot->Append(uint8(value));
+        return value;
+    }
+
+    char GetByte(uint32 x)
+    {
+        char value = (char)fields[x].GetUInt8();
+        if (snapshot)
+            snapshot->Append(uint8(value));
+        return value;
+    }
+
+    uint32 GetUInt32(uint32 x)
+    {
+        uint32 value = fields[x].GetUInt32();
+        if (snapshot)
+            snapshot->Append(value);
+        return value;
+    }
+
+    float GetFloat(uint32 x)
+    {
+        float value = fields[x].GetFloat();
+        if (snapshot)
+            snapshot->Append(value);
+        return value;
+    }
+
+    char const* GetString(uint32 x)
+    {
+        char const* value = fields[x].GetString();
+        if (snapshot)
+            snapshot->Append(value);
+        return value;
+    }
+
+    Field *fields;
+    SQLStorageSnapshot *snapshot;
+};
+
+struct SQLStorageSnapshotRow
+{
+    explicit SQLStorageSnapshotRow(SQLStorageSnapshot &s) : snapshot(s) {}
+
+    bool GetBool(uint32 /*x*/) { return snapshot.ReadUInt8() != 0; }
+    char GetByte(uint32 /*x*/) { return (char)snapshot.ReadUInt8(); }
+    uint32 GetUInt32(uint32 /*x*/) { return snapshot.ReadUInt32(); }
+    float GetFloat(uint32 /*x*/) { return snapshot.ReadFloat(); }
+    char const* GetString(uint32 /*x*/) { return snapshot.ReadString(); }
+
+    SQLStorageSnapshot &snapshot;
+};
+
+template<class T>
+template<class R>
+void SQLStorageLoaderBase<T>::loadRecord(SQLStorage &store, R &row, char *p)
+{
+    uint32 offset = 0;
+    for(uint32 x = 0; x < store.iNumFields; x++)
+        switch(store.src_format[x])
+        {
+            case FT_LOGIC:
+                storeValue(row.GetBool(x), store, p, x, offset); break;
+            case FT_BYTE:
+                storeValue(row.GetByte(x), store, p, x, offset); break;
+            case FT_INT:
+                storeValue(row.GetUInt32(x), store, p, x, offset); break;
+            case FT_FLOAT:
+                storeValue(row.GetFloat(x), store, p, x, offset); break;
+            case FT_STRING:
+                storeValue(row.GetString(x), store, p, x, offset); break;
+        }
+}
+
+template<class T>
+bool SQLStorageLoaderBase<T>::loadFromSnapshot(SQLStorage &store, SQLStorageSnapshot &snapshot, uint32 recordsize)
+{
+    store.RecordCount = snapshot.GetRecordCount();
+    store.MaxEntry = snapshot.GetMaxEntry();
+
+    store.pIndex = new char*[store.MaxEntry];
+    memset(store.pIndex, 0, store.MaxEntry*sizeof(char*));
+
+    store.data = new char[store.RecordCount*recordsize];
+    memset(store.data, 0, store.RecordCount*recordsize);
+
+    SQLStorageSnapshotRow row(snapshot);
+    for (uint32 count = 0; count < store.RecordCount && !snapshot.IsOverrun(); ++count)
+    {
+        uint32 entry = snapshot.ReadUInt32();
+        if (entry >= store.MaxEntry || store.pIndex[entry])
+            break;
+
+        char *p = &store.data[recordsize*count];
+        store.pIndex[entry] = p;
+        loadRecord(store, row, p);
+    }
+
+    if (!snapshot.EndOfRows() || snapshot.IsOverrun())
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: Snapshot of %s table doesn't match its header, loading table from database", store.table);
+        store.Free();
+        store.pIndex = NULL;
+        store.data = NULL;
+        store.MaxEntry = 0;
+        store.RecordCount = 0;
+        return false;
+    }
+
+    sLog.outString("Table %s loaded from snapshot", store.table);
+    return true;
+}
+
 template<class T>
 void SQLStorageLoaderBase<T>::Load(SQLStorage &store)
 {
     uint32 maxi;
     Field *fields;
+
+    //get struct size
+    uint32 sc=0;
+    uint32 bo=0;
+    uint32 bb=0;
+    for(uint32 x=0; x< store.iNumFields; x++)
+        if(store.dst_format[x]==FT_STRING)
+            ++sc;
+        else if (store.dst_format[x]==FT_LOGIC)
+            ++bo;
+        else if (store.dst_format[x]==FT_BYTE)
+            ++bb;
+    uint32 recordsize=(store.iNumFields-sc-bo-bb)*4+sc*sizeof(char*)+bo*sizeof(bool)+bb*sizeof(char);
+
+    // static tables change only with content updates, use local copy while table checksum is the same
+    SQLStorageSnapshot snapshot(store);
+    if (snapshot.Prepare() && snapshot.Load() && loadFromSnapshot(store, snapshot, recordsize))
+        return;
+
     QueryResultAutoPtr result = GameDataDatabase.PQuery("SELECT MAX(%s) FROM %s", store.entry_field, store.table);
     if(!result)
     {
@@ -152,9 +293,6 @@ void SQLStorageLoaderBase<T>::Load(SQLStorage &store)
         return;
     }
 
-    uint32 recordsize = 0;
-    uint32 offset = 0;
-
     if(store.iNumFields != result->GetFieldCount())
     {
         store.RecordCount = 0;
@@ -162,19 +300,6 @@ void SQLStorageLoaderBase<T>::Load(SQLStorage &store)
         exit(1);                                            // Stop server at loading broken or non-compatible table.
     }
 
-    //get struct size
-    uint32 sc=0;
-    uint32 bo=0;
-    uint32 bb=0;
-    for(uint32 x=0; x< store.iNumFields; x++)
-        if(store.dst_format[x]==FT_STRING)
-            ++sc;
-        else if (store.dst_format[x]==FT_LOGIC)
-            ++bo;
-        else if (store.dst_format[x]==FT_BYTE)
-            ++bb;
-    recordsize=(store.iNumFields-sc-bo-bb)*4+sc*sizeof(char*)+bo*sizeof(bool)+bb*sizeof(char);
-
     char** newIndex=new char*[maxi];
     memset(newIndex,0,maxi*sizeof(char*));
 
@@ -188,21 +313,11 @@ void SQLStorageLoaderBase<T>::Load(SQLStorage &store)
         char *p=(char*)&_data[recordsize*count];
         newIndex[fields[0].GetUInt32()]=p;
 
-        offset=0;
-        for(uint32 x = 0; x < store.iNumFields; x++)
-            switch(store.src_format[x])
-            {
-                case FT_LOGIC:
-                    storeValue((bool)(fields[x].GetUInt32() > 0), store, p, x, offset); break;
-                case FT_BYTE:
-                    storeValue((char)fields[x].GetUInt8(), store, p, x, offset); break;
-                case FT_INT:
-                    storeValue((uint32)fields[x].GetUInt32(), store, p, x, offset); break;
-                case FT_FLOAT:
-                    storeValue((float)fields[x].GetFloat(), store, p, x, offset); break;
-                case FT_STRING:
-                    storeValue((char const*)fields[x].GetString(), store, p, x, offset); break;
-            }
+        if (snapshot.IsPrepared())
+            snapshot.AddRecord(fields[0].GetUInt32());
+
+        SQLStorageQueryRow row(fields, snapshot.IsPrepared() ? &snapshot : NULL);
+        loadRecord(store, row, p);
         ++count;
     }
     while (result->NextRow());
@@ -210,6 +325,9 @@ void SQLStorageLoaderBase<T>::Load(SQLStorage &store)
     store.pIndex = newIndex;
     store.MaxEntry = maxi;
     store.data = _data;
+
+    if (snapshot.IsPrepared())
+        snapshot.Save();
 }
 
 #endif
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "SQLStorageSnapshot.h"
+#include "SQLStorage.h"
+#include "Auth/Sha1.h"
+#include "Log.h"
+
+extern DatabaseType GameDataDatabase;
+
+std::string SQLStorageSnapshot::m_directory;
+
+SQLStorageSnapshot::SQLStorageSnapshot(SQLStorage const& store) : m_store(store), m_tableKey(0), m_prepared(false),
+    m_maxEntry(0), m_recordCount(0), m_readPos(0)
+{
+}
+
+void SQLStorageSnapshot::SetDirectory(std::string const& dir)
+{
+    m_directory = dir;
+
+    if (!m_directory.empty() && m_directory.at(m_directory.length()-1) != '/' && m_directory.at(m_directory.length()-1) != '\\')
+        m_directory.append("/");
+}
+
+std::string SQLStorageSnapshot::GetFileName() const
+{
+    return m_directory + m_store.GetTableName() + ".snapshot";
+}
+
+bool SQLStorageSnapshot::Prepare()
+{
+    if (m_directory.empty())
+        return false;
+
+    // live checksum is kept by the engine, NULL unless the table was created with CHECKSUM=1
+    QueryResultAutoPtr result = GameDataDatabase.PQuery("CHECKSUM TABLE %s QUICK", m_store.GetTableName());
+    if (!result || (*result)[1].IsNULL())
+    {
+        // otherwise (InnoDB) the server reads the rows, still without sending them
+        result = GameDataDatabase.PQuery("CHECKSUM TABLE %s", m_store.GetTableName());
+        if (!result || (*result)[1].IsNULL())
+            return false;
+    }
+
+    m_tableKey = (*result)[1].GetUInt64();
+    m_prepared = true;
+    return true;
+}
+
+bool SQLStorageSnapshot::Load()
+{
+    FILE* file = fopen(GetFileName().c_str(), "rb");
+    if (!file)
+        return false;
+
+    uint32 header[3];
+    uint64 tableKey = 0;
+    uint32 rowsSize = 0;
+    uint8 digest[SHA_DIGEST_LENGTH];
+    std::string format(m_store.src_format);
+    std::vector<char> fileFormat(format.size());
+
+    bool valid = fread(header, sizeof(header), 1, file) == 1 &&
+        header[0] == SQLSTORAGE_SNAPSHOT_MAGIC && header[1] == SQLSTORAGE_SNAPSHOT_VERSION && header[2] == format.size() &&
+        fread(&fileFormat[0], fileFormat.size(), 1, file) == 1 && format.compare(0, format.size(), &fileFormat[0], fileFormat.size()) == 0 &&
+        fread(&tableKey, sizeof(tableKey), 1, file) == 1 && tableKey == m_tableKey &&
+        fread(&m_maxEntry, sizeof(m_maxEntry), 1, file) == 1 &&
+        fread(&m_recordCount, sizeof(m_recordCount), 1, file) == 1 &&
+        fread(&rowsSize, sizeof(rowsSize), 1, file) == 1 &&
+        fread(digest, sizeof(digest), 1, file) == 1;
+
+    if (valid && rowsSize)
+    {
+        m_rows.resize(rowsSize);
+        valid = fread(&m_rows[0], rowsSize, 1, file) == 1;
+    }
+
+    fclose(file);
+
+    if (valid)
+    {
+        Sha1Hash sha;
+        sha.Initialize();
+        if (!m_rows.empty())
+            sha.UpdateData(&m_rows[0], m_rows.size());
+        sha.Finalize();
+
+        valid = memcmp(sha.GetDigest(), digest, SHA_DIGEST_LENGTH) == 0;
+        if (!valid)
+            sLog.outLog(LOG_DEFAULT, "ERROR: Snapshot %s is damaged, loading `%s` from database", GetFileName().c_str(), m_store.GetTableName());
+    }
+
+    if (!valid)
+    {
+        m_rows.clear();
+        m_maxEntry = 0;
+        m_recordCount = 0;
+        return false;
+    }
+
+    m_readPos = 0;
+    return true;
+}
+
+bool SQLStorageSnapshot::Save()
+{
+    std::string fileName = GetFileName();
+    std::string tmpName = fileName + ".tmp";
+
+    FILE* file = fopen(tmpName.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: Can't create snapshot file %s", tmpName.c_str());
+        return false;
+    }
+
+    Sha1Hash sha;
+    sha.Initialize();
+    if (!m_rows.empty())
+        sha.UpdateData(&m_rows[0], m_rows.size());
+    sha.Finalize();
+
+    std::string format(m_store.src_format);
+    uint32 header[3] = { SQLSTORAGE_SNAPSHOT_MAGIC, SQLSTORAGE_SNAPSHOT_VERSION, uint32(format.size()) };
+    uint32 rowsSize = m_rows.size();
+
+    bool written = fwrite(header, sizeof(header), 1, file) == 1 &&
+        fwrite(format.c_str(), format.size(), 1, file) == 1 &&
+        fwrite(&m_tableKey, sizeof(m_tableKey), 1, file) == 1 &&
+        fwrite(&m_maxEntry, sizeof(m_maxEntry), 1, file) == 1 &&
+        fwrite(&m_recordCount, sizeof(m_recordCount), 1, file) == 1 &&
+        fwrite(&rowsSize, sizeof(rowsSize), 1, file) == 1 &&
+        fwrite(sha.GetDigest(), SHA_DIGEST_LENGTH, 1, file) == 1 &&
+        (m_rows.empty() || fwrite(&m_rows[0], m_rows.size(), 1, file) == 1);
+
+    if (fclose(file) != 0)
+        written = false;
+
+    // replace old snapshot only by complete file
+    if (!written || (remove(fileName.c_str()) != 0 && errno != ENOENT) || rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: Can't write snapshot file %s", fileName.c_str());
+        remove(tmpName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void SQLStorageSnapshot::AddRecord(uint32 entry)
+{
+    if (entry >= m_maxEntry)
+        m_maxEntry = entry + 1;
+
+    ++m_recordCount;
+    Append(entry);
+}
+
+void SQLStorageSnapshot::Append(char const* value)
+{
+    // keep NULL apart from empty string, loaders may convert them differently
+    if (!value)
+    {
+        Append(uint8(0));
+        return;
+    }
+
+    Append(uint8(1));
+    Append(value, strlen(value) + 1);
+}
+
+void SQLStorageSnapshot::Append(void const* data, size_t size)
+{
+    uint8 const* bytes = (uint8 const*)data;
+    m_rows.insert(m_rows.end(), bytes, bytes + size);
+}
+
+void SQLStorageSnapshot::Read(void* data, size_t size)
+{
+    if (m_readPos + size > m_rows.size())
+    {
+        memset(data, 0, size);
+        m_readPos = m_rows.size() + 1;                      // mark as overrun
+        return;
+    }
+
+    memcpy(data, &m_rows[m_readPos], size);
+    m_readPos += size;
+}
+
+uint8 SQLStorageSnapshot::ReadUInt8()
+{
+    uint8 value;
+    Read(&value, sizeof(value));
+    return value;
+}
+
+uint32 SQLStorageSnapshot::ReadUInt32()
+{
+    uint32 value;
+    Read(&value, sizeof(value));
+    return value;
+}
+
+float SQLStorageSnapshot::ReadFloat()
+{
+    float value;
+    Read(&value, sizeof(value));
+    return value;
+}
+
+char const* SQLStorageSnapshot::ReadString()
+{
+    if (!ReadUInt8())
+        return NULL;
+
+    if (m_readPos >= m_rows.size())
+        return NULL;
+
+    char const* value = (char const*)&m_rows[m_readPos];
+    size_t length = strnlen(value, m_rows.size() - m_readPos);
+    if (m_readPos + length >= m_rows.size())
+    {
+        m_readPos = m_rows.size() + 1;
+        return NULL;
+    }
+
+    m_readPos += length + 1;
+    return value;
+}
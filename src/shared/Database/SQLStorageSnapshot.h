@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLSTORAGE_SNAPSHOT_H
+#define SQLSTORAGE_SNAPSHOT_H
+
+#include "Common.h"
+
+class SQLStorage;
+
+#define SQLSTORAGE_SNAPSHOT_MAGIC   0x5347344C              // "L4GS"
+#define SQLSTORAGE_SNAPSHOT_VERSION 2
+
+/// Raw rows of one SQLStorage table kept in a local file (native byte order).
+/// While the table version key matches the one stored in the file the rows are
+/// replayed through the storage loader instead of querying the table, so
+/// loader conversions (script names etc.) still run on every startup.
+/// The key is the content checksum of the table: the live one (CHECKSUM TABLE ... QUICK)
+/// of tables with CHECKSUM=1, else one the server computes from the rows (CHECKSUM TABLE).
+class SQLStorageSnapshot
+{
+    public:
+        explicit SQLStorageSnapshot(SQLStorage const& store);
+
+        /// empty directory disables snapshots
+        static void SetDirectory(std::string const& dir);
+
+        /// get current table version key, false if snapshots can't be used for this table
+        bool Prepare();
+        bool IsPrepared() const { return m_prepared; }
+
+        /// read snapshot file, false if missing, outdated or damaged
+        bool Load();
+        bool Save();
+
+        uint32 GetMaxEntry() const { return m_maxEntry; }
+        uint32 GetRecordCount() const { return m_recordCount; }
+
+        // writing, every record starts with its entry followed by raw field values
+        void AddRecord(uint32 entry);
+        void Append(uint8 value) { m_rows.push_back(value); }
+        void Append(uint32 value) { Append(&value, sizeof(value)); }
+        void Append(float value) { Append(&value, sizeof(value)); }
+        void Append(char const* value);
+
+        // reading
+        bool EndOfRows() const { return m_readPos >= m_rows.size(); }
+        bool IsOverrun() const { return m_readPos > m_rows.size(); }
+        uint8 ReadUInt8();
+        uint32 ReadUInt32();
+        float ReadFloat();
+        char const* ReadString();
+
+    private:
+        void Append(void const* data, size_t size);
+        void Read(void* data, size_t size);
+
+        std::string GetFileName() const;
+
+        SQLStorage const& m_store;
+        uint64 m_tableKey;
+        bool m_prepared;
+
+        uint32 m_maxEntry;
+        uint32 m_recordCount;
+
+        std::vector<uint8> m_rows;
+        size_t m_readPos;
+
+        static std::string m_directory;
+};
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2009 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOCKFREEQUEUE_H
+#define LOCKFREEQUEUE_H
+
+#include <atomic>
+
+namespace ACE_Based
+{
+    /**
+     * Unbounded queue without locks, any thread may add items but only one
+     * thread at a time may take them (callers must serialize consumers).
+     * Nodes of taken items are kept and reused by later add() calls.
+     */
+    template <class T>
+        class LockFreeQueue
+    {
+        struct Node
+        {
+            Node() : next(NULL), item() {}
+
+            std::atomic<Node*> next;
+            T item;
+        };
+
+        //! Last added node, producers append behind it
+        std::atomic<Node*> _head;
+
+        //! Consumer side, its next node holds first item
+        Node* _tail;
+
+        //! Nodes of taken items
+        std::atomic<Node*> _free;
+
+        //! Nodes taken from _free by producers, guarded by _allocating
+        Node* _spare;
+        std::atomic_flag _allocating;
+
+        LockFreeQueue(LockFreeQueue const&);
+        LockFreeQueue& operator=(LockFreeQueue const&);
+
+        Node* allocNode()
+        {
+            Node* node = NULL;
+
+            // producer finding another one allocating doesn't wait for it
+            if (!_allocating.test_and_set(std::memory_order_acquire))
+            {
+                // whole list is taken at once, single node pop could suffer from ABA
+                if (!_spare)
+                    _spare = _free.exchange(NULL, std::memory_order_acquire);
+
+                node = _spare;
+                if (node)
+                    _spare = node->next.load(std::memory_order_relaxed);
+
+                _allocating.clear(std::memory_order_release);
+            }
+
+            if (!node)
+                return new Node();
+
+            node->next.store(NULL, std::memory_order_relaxed);
+            return node;
+        }
+
+        void releaseNode(Node* node)
+        {
+            Node* top = _free.load(std::memory_order_relaxed);
+            do
+            {
+                node->next.store(top, std::memory_order_relaxed);
+            }
+            while (!_free.compare_exchange_weak(top, node, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        static void deleteNodes(Node* node)
+        {
+            while (node)
+            {
+                Node* next = node->next.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+
+        public:
+
+            LockFreeQueue() : _spare(NULL)
+            {
+                Node* stub = new Node();
+                _head.store(stub, std::memory_order_relaxed);
+                _tail = stub;
+                _free.store(NULL, std::memory_order_relaxed);
+                _allocating.clear();
+            }
+
+            //! Items still queued are not destroyed, take them first
+            ~LockFreeQueue()
+            {
+                deleteNodes(_tail);
+                deleteNodes(_free.load(std::memory_order_relaxed));
+                deleteNodes(_spare);
+            }
+
+            //! Adds an item to the queue.
+            void add(const T& item)
+            {
+                Node* node = allocNode();
+                node->item = item;
+
+                Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+                prev->next.store(node, std::memory_order_release);
+            }
+
+            //! Gets the next item in the queue, if any.
+            bool next(T& result)
+            {
+                Node* node = _tail->next.load(std::memory_order_acquire);
+                if (!node)
+                    return false;
+
+                result = node->item;
+                pop(node);
+                return true;
+            }
+
+            //! Gets the next item if check.Process() accepts it.
+            template<class Checker>
+            bool next(T& result, Checker& check)
+            {
+                Node* node = _tail->next.load(std::memory_order_acquire);
+                if (!node || !check.Process(node->item))
+                    return false;
+
+                result = node->item;
+                pop(node);
+                return true;
+            }
+
+            //! Item being added may not be visible yet.
+            bool empty() const
+            {
+                return !_tail->next.load(std::memory_order_acquire);
+            }
+
+        private:
+
+            // node becomes new stub, old one is reused
+            void pop(Node* node)
+            {
+                Node* old = _tail;
+                _tail = node;
+                node->item = T();
+
+                releaseNode(old);
+            }
+    };
+}
+#endif
@@ -26,6 +26,8 @@
 #include "Config/Config.h"
 #include "Util.h"
 
+#include <ace/TSS_T.h>
+
 enum LogType
 {
     LogNormal = 0,
@@ -36,6 +38,15 @@ enum LogType
 
 const int LogType_count = int(LogError) +1;
 
+struct ConsoleCapturePtr
+{
+    ConsoleCapturePtr() : lines(NULL) {}
+
+    std::vector<std::string>* lines;
+};
+
+static ACE_TSS<ConsoleCapturePtr> consoleCapture;
+
 const char* logToStr[LOG_MAX_FILES][3] =
 {     // file name conf    mode  timestamp conf name
     { "GMLogFile",          "a", "GmLogTimestamp" },    // LOG_GM
@@ -396,9 +407,14 @@ void Log::outTitle( const char * str)
 
 void Log::outString()
 {
-    if(m_includeTime)
-        outTime();
-    printf( "\n" );
+    if (std::vector<std::string>* lines = consoleCapture->lines)
+        lines->push_back(std::string());
+    else
+    {
+        if(m_includeTime)
+            outTime();
+        printf( "\n" );
+    }
     if(logFile[LOG_DEFAULT])
     {
         outTimestamp(logFile[LOG_DEFAULT]);
@@ -413,18 +429,31 @@ void Log::outString( const char * str, ... )
     if( !str )
         return;
 
-    if(m_colored)
-        SetColor(true,m_colors[LogNormal]);
+    if (std::vector<std::string>* lines = consoleCapture->lines)
+    {
+        char buf[6000];
+        va_list ap;
+        va_start(ap, str);
+        vsnprintf(buf, sizeof(buf), str, ap);
+        va_end(ap);
 
-    if(m_includeTime)
-        outTime();
+        lines->push_back(buf);
+    }
+    else
+    {
+        if(m_colored)
+            SetColor(true,m_colors[LogNormal]);
 
-    UTF8PRINTF(stdout,str,);
+        if(m_includeTime)
+            outTime();
 
-    if(m_colored)
-        ResetColor(true);
+        UTF8PRINTF(stdout,str,);
 
-    printf( "\n" );
+        if(m_colored)
+            ResetColor(true);
+
+        printf( "\n" );
+    }
     if(logFile[LOG_DEFAULT])
     {
         outTimestamp(logFile[LOG_DEFAULT]);
@@ -440,6 +469,38 @@ void Log::outString( const char * str, ... )
     fflush(stdout);
 }
 
+void Log::SetConsoleCapture(std::vector<std::string>* lines)
+{
+    consoleCapture->lines = lines;
+}
+
+void Log::outCapturedLines(std::vector<std::string> const& lines)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_consoleLock);
+
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        outConsole("%s", itr->c_str());
+
+    fflush(stdout);
+}
+
+// console part of outString
+void Log::outConsole(const char * str, ...)
+{
+    if(m_colored)
+        SetColor(true,m_colors[LogNormal]);
+
+    if(m_includeTime)
+        outTime();
+
+    UTF8PRINTF(stdout,str,);
+
+    if(m_colored)
+        ResetColor(true);
+
+    printf( "\n" );
+}
+
 void Log::outBasic(const char * str, ...)
 {
     if (!str)
@@ -134,7 +134,16 @@ class Log
 
         bool IsLogEnabled(LogNames log) const { return logFile[log] != NULL; }
 
+        // while set, console lines of outString from the calling thread are collected instead of printed
+        // (log file still gets them at once), so loaders running in parallel don't mix their output
+        void SetConsoleCapture(std::vector<std::string>* lines);
+        // prints captured lines as one block
+        void outCapturedLines(std::vector<std::string> const& lines);
+
     private:
+        void outConsole(const char * str, ...)      ATTR_PRINTF(2, 3);
+        ACE_Thread_Mutex m_consoleLock;
+
         FILE* openLogFile(LogNames log);
         FILE* openGmlogPerAccount(uint32 account);
 
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PacketBufferPool.h"
+#include "WorldPacket.h"
+
+#include <ace/TSS_T.h>
+
+#include <new>
+
+// movement and most other client packets fit in the first class
+size_t const PacketBufferPool::s_classSizes[SIZE_CLASSES] = { 64, 256, 1024, 4096, 16384 };
+
+struct PacketBufferPoolPtr
+{
+    PacketBufferPoolPtr() : pool(NULL) {}
+
+    // not deleted at thread end, see ThreadInstance()
+    PacketBufferPool* pool;
+};
+
+static ACE_TSS<PacketBufferPoolPtr> threadPool;
+
+PacketBufferPool& PacketBufferPool::ThreadInstance()
+{
+    PacketBufferPoolPtr* ptr = threadPool.ts_object();
+    if (!ptr->pool)
+        ptr->pool = new PacketBufferPool;
+
+    return *ptr->pool;
+}
+
+PacketBuffer* PacketBufferPool::Acquire(size_t size)
+{
+    int sizeClass = 0;
+    while (s_classSizes[sizeClass] < size)
+        if (++sizeClass == SIZE_CLASSES)
+            return NULL;
+
+    Collect();
+
+    std::vector<PacketBuffer*>& freeList = m_free[sizeClass];
+    if (freeList.empty())
+    {
+        PacketBuffer* buffer = new PacketBuffer(this);
+        buffer->storage.reserve(s_classSizes[sizeClass]);
+        return buffer;
+    }
+
+    PacketBuffer* buffer = freeList.back();
+    freeList.pop_back();
+    return buffer;
+}
+
+void PacketBufferPool::Release(PacketBuffer* buffer)
+{
+    // keeps the capacity
+    buffer->storage.clear();
+
+    PacketBufferPool* owner = buffer->owner;
+    if (threadPool.ts_object()->pool == owner)
+        owner->Store(buffer);
+    else
+        owner->m_returned.add(buffer);
+}
+
+void PacketBufferPool::Store(PacketBuffer* buffer)
+{
+    size_t capacity = buffer->storage.capacity();
+
+    // storage may have grown while borrowed, file it under the largest class it still serves
+    int sizeClass = SIZE_CLASSES - 1;
+    while (sizeClass >= 0 && s_classSizes[sizeClass] > capacity)
+        --sizeClass;
+
+    if (sizeClass < 0 || capacity > 2 * s_classSizes[SIZE_CLASSES - 1] || m_free[sizeClass].size() * s_classSizes[sizeClass] >= MAX_FREE_BYTES_PER_CLASS)
+    {
+        delete buffer;
+        return;
+    }
+
+    m_free[sizeClass].push_back(buffer);
+}
+
+void* PacketBufferPool::AllocatePacket(size_t size)
+{
+    if (size != sizeof(WorldPacket))
+        return AllocateUnpooled(size, true);
+
+    Collect();
+
+    PacketSlotHeader* slot;
+    if (m_freePackets.empty())
+    {
+        slot = (PacketSlotHeader*)::operator new(sizeof(PacketSlotHeader) + size, std::nothrow);
+        if (!slot)
+            return NULL;
+    }
+    else
+    {
+        slot = m_freePackets.back();
+        m_freePackets.pop_back();
+    }
+
+    slot->owner = this;
+    return slot + 1;
+}
+
+void* PacketBufferPool::AllocateUnpooled(size_t size, bool nothrow)
+{
+    PacketSlotHeader* slot = (PacketSlotHeader*)(nothrow ? ::operator new(sizeof(PacketSlotHeader) + size, std::nothrow) : ::operator new(sizeof(PacketSlotHeader) + size));
+    if (!slot)
+        return NULL;
+
+    slot->owner = NULL;
+    return slot + 1;
+}
+
+void PacketBufferPool::FreePacket(void* packet)
+{
+    if (!packet)
+        return;
+
+    PacketSlotHeader* slot = (PacketSlotHeader*)packet - 1;
+    PacketBufferPool* owner = slot->owner;
+    if (!owner)
+        ::operator delete(slot);
+    else if (threadPool.ts_object()->pool == owner)
+        owner->StorePacket(slot);
+    else
+        owner->m_returnedPackets.add(slot);
+}
+
+void PacketBufferPool::Collect()
+{
+    PacketBuffer* buffer;
+    while (m_returned.next(buffer))
+        Store(buffer);
+
+    PacketSlotHeader* slot;
+    while (m_returnedPackets.next(slot))
+        StorePacket(slot);
+}
+
+void PacketBufferPool::StorePacket(PacketSlotHeader* slot)
+{
+    if (m_freePackets.size() >= MAX_FREE_PACKETS)
+    {
+        ::operator delete(slot);
+        return;
+    }
+
+    m_freePackets.push_back(slot);
+}
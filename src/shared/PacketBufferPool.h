@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKETBUFFERPOOL_H
+#define PACKETBUFFERPOOL_H
+
+#include "Common.h"
+
+// LockFreeQueue needs <atomic>, missing before VC110
+#if defined(_MSC_VER) && _MSC_VER < 1700
+#include "LockedQueue.h"
+#else
+#include "LockFreeQueue.h"
+#endif
+
+class PacketBufferPool;
+
+/// Packet storage lent by a pool, swapped with the storage of the packet while it is borrowed
+struct PacketBuffer
+{
+    explicit PacketBuffer(PacketBufferPool* pool) : owner(pool) {}
+
+    std::vector<uint8> storage;
+    PacketBufferPool* owner;
+};
+
+/// Heap WorldPacket memory starts with the pool it came from, NULL if none.
+/// Sized to keep the packet behind it aligned like ::operator new does.
+union PacketSlotHeader
+{
+    PacketBufferPool* owner;
+    uint64 align;
+    double alignDouble;
+};
+
+/**
+ * Size classed free lists of packet storage and a free list of WorldPacket objects,
+ * one pool per thread taking them. Only the owning thread takes from its pool, any
+ * thread gives back: the owner stores them directly, other threads queue them to
+ * the owner without locking, collected by the owner whenever it takes again.
+ */
+class PacketBufferPool
+{
+    public:
+        enum
+        {
+            SIZE_CLASSES                = 5,
+            MAX_FREE_BYTES_PER_CLASS    = 256 * 1024,       // enough for the packets in flight of a busy network thread
+            MAX_FREE_PACKETS            = 4096
+        };
+
+        /// Pool of the calling thread. It is never destroyed, buffers may still be in use when the thread ends.
+        static PacketBufferPool& ThreadInstance();
+
+        /// Buffer with capacity for size bytes, NULL if size is above the largest class
+        PacketBuffer* Acquire(size_t size);
+
+        /// Gives the buffer back to its pool, from any thread
+        static void Release(PacketBuffer* buffer);
+
+        /// Memory for a WorldPacket object, NULL if out of memory. Other sizes are not pooled.
+        void* AllocatePacket(size_t size);
+
+        /// Memory for a WorldPacket object not taken from any pool
+        static void* AllocateUnpooled(size_t size, bool nothrow);
+
+        /// Gives WorldPacket memory back to the pool it came from, from any thread
+        static void FreePacket(void* packet);
+
+    private:
+        PacketBufferPool() {}
+        PacketBufferPool(PacketBufferPool const&);
+        PacketBufferPool& operator=(PacketBufferPool const&);
+
+        // owner thread only
+        void Collect();
+        void Store(PacketBuffer* buffer);
+        void StorePacket(PacketSlotHeader* slot);
+
+        static size_t const s_classSizes[SIZE_CLASSES];
+
+        std::vector<PacketBuffer*> m_free[SIZE_CLASSES];
+        std::vector<PacketSlotHeader*> m_freePackets;
+#if defined(_MSC_VER) && _MSC_VER < 1700
+        ACE_Based::LockedQueue<PacketBuffer*, ACE_Thread_Mutex> m_returned;
+        ACE_Based::LockedQueue<PacketSlotHeader*, ACE_Thread_Mutex> m_returnedPackets;
+#else
+        ACE_Based::LockFreeQueue<PacketBuffer*> m_returned;
+        ACE_Based::LockFreeQueue<PacketSlotHeader*> m_returnedPackets;
+#endif
+};
+
+#endif
@@ -21,6 +21,7 @@
 #include "ProgressBar.h"
 
 bool BarGoLink::m_showOutput = true;
+bool BarGoLink::m_suppressed = false;
 
 char const* const BarGoLink::empty = " ";
 #ifdef _WIN32
@@ -44,9 +45,14 @@ void BarGoLink::SetOutputState(bool on)
     m_showOutput = on;
 }
 
+void BarGoLink::SetSuppressed(bool on)
+{
+    m_suppressed = on;
+}
+
 BarGoLink::BarGoLink(int row_count, bool on)
 {
-    m_showOutput = on;
+    m_showOutput = on && !m_suppressed;
     if (!m_showOutput)
         return;
 
@@ -31,12 +31,15 @@ class BarGoLink
 
         void step();
         static void SetOutputState(bool on);
+        // no bars at all while set, e.g. while several loaders run at once
+        static void SetSuppressed(bool on);
 
     private:
         static char const * const empty;
         static char const * const full;
 
         static bool m_showOutput;
+        static bool m_suppressed;
 
         int rec_no;
         int rec_pos;
@@ -235,6 +235,30 @@ bool IsIPAddress(char const* ipaddress)
     return ACE_OS::inet_addr(ipaddress) != INADDR_NONE;
 }
 
+bool ParseIPNetwork(std::string const& ip, uint32& net, uint8& prefixLen)
+{
+    uint32 a, b, c, d;
+    int consumed = 0;
+    if (sscanf(ip.c_str(), "%u.%u.%u.%u%n", &a, &b, &c, &d, &consumed) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+        return false;
+
+    char const* rest = ip.c_str() + consumed;
+    uint32 len = 32;
+    if (*rest == '/')
+    {
+        char* end = NULL;
+        len = strtoul(rest + 1, &end, 10);
+        if (end == rest + 1 || *end || len > 32)
+            return false;
+    }
+    else if (*rest)
+        return false;
+
+    net = (a << 24) | (b << 16) | (c << 8) | d;
+    prefixLen = uint8(len);
+    return true;
+}
+
 /// create PID file
 uint32 CreatePIDFile(const std::string& filename)
 {
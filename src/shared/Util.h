@@ -318,6 +318,10 @@ bool Utf8FitTo(const std::string& str, std::wstring search);
 #endif
 
 bool IsIPAddress(char const* ipaddress);
+/// Parses "a.b.c.d" (prefix length 32) or a network in CIDR notation "a.b.c.d/len", address in host byte order
+bool ParseIPNetwork(std::string const& ip, uint32& net, uint8& prefixLen);
+/// Mask of the network part of addresses in a network with this prefix length
+inline uint32 IPNetworkMask(uint8 prefixLen) { return prefixLen ? 0xFFFFFFFF << (32 - prefixLen) : 0; }
 uint32 CreatePIDFile(const std::string& filename);
 
 #endif
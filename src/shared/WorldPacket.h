@@ -23,18 +23,55 @@
 
 #include "Common.h"
 #include "ByteBuffer.h"
+#include "PacketBufferPool.h"
+
+#include <new>
 
 class WorldPacket : public ByteBuffer
 {
     public:
                                                             // just container for later use
-        WorldPacket()                                       : ByteBuffer(0), m_opcode(0)
+        WorldPacket()                                       : ByteBuffer(0), m_opcode(0), m_poolBuffer(NULL)
+        {
+        }
+        explicit WorldPacket(uint16 opcode, size_t res=200) : ByteBuffer(res), m_opcode(opcode), m_poolBuffer(NULL) { }
+                                                            // storage borrowed from pool, given back on destruction
+        WorldPacket(uint16 opcode, size_t res, PacketBufferPool& pool) : ByteBuffer(0), m_opcode(opcode), m_poolBuffer(pool.Acquire(res))
         {
+            if (m_poolBuffer)
+                _storage.swap(m_poolBuffer->storage);
+            else
+                _storage.reserve(res);
         }
-        explicit WorldPacket(uint16 opcode, size_t res=200) : ByteBuffer(res), m_opcode(opcode) { }
                                                             // copy constructor
-        WorldPacket(const WorldPacket &packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode)
+        WorldPacket(const WorldPacket &packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode), m_poolBuffer(NULL)
+        {
+        }
+
+        // heap packets remember the pool their memory came from, new (pool) WorldPacket(opcode, size, pool)
+        // takes object and storage from the pool, NULL if out of memory
+        static void* operator new(size_t size) { return PacketBufferPool::AllocateUnpooled(size, false); }
+        static void* operator new(size_t size, std::nothrow_t const&) throw() { return PacketBufferPool::AllocateUnpooled(size, true); }
+        static void* operator new(size_t size, PacketBufferPool& pool) throw() { return pool.AllocatePacket(size); }
+        static void operator delete(void* packet) { PacketBufferPool::FreePacket(packet); }
+        static void operator delete(void* packet, std::nothrow_t const&) throw() { PacketBufferPool::FreePacket(packet); }
+        static void operator delete(void* packet, PacketBufferPool&) throw() { PacketBufferPool::FreePacket(packet); }
+
+        ~WorldPacket()
+        {
+            if (m_poolBuffer)
+            {
+                _storage.swap(m_poolBuffer->storage);
+                PacketBufferPool::Release(m_poolBuffer);
+            }
+        }
+
+        // keeps the own storage, a borrowed buffer must not be shared
+        WorldPacket& operator=(const WorldPacket &packet)
         {
+            ByteBuffer::operator=(packet);
+            m_opcode = packet.m_opcode;
+            return *this;
         }
 
         void Initialize(uint16 opcode, size_t newres=200)
@@ -49,6 +86,7 @@ class WorldPacket : public ByteBuffer
 
     protected:
         uint16 m_opcode;
+        PacketBuffer* m_poolBuffer;
 };
 #endif
 
@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Microbenchmark of the unit and player hot sets: a combat simulation touching attackers, combo
+/// point holders and dynamic objects like Unit does, and a visibility simulation copying and
+/// updating client guids like VisibleNotifier does. Runs with the std containers the members used
+/// before and with the containers of FlatContainers.h, counting heap allocations of each.
+
+#include "Common.h"
+#include "Utilities/FlatContainers.h"
+
+#include <ace/Get_Opt.h>
+#include <ace/OS_NS_sys_time.h>
+
+#include <set>
+#include <list>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+static uint64 allocations = 0;
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) throw()
+{
+    free(p);
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void* p) throw()
+{
+    operator delete(p);
+}
+
+static uint64 NowUs()
+{
+    ACE_Time_Value tv = ACE_OS::gettimeofday();
+    return uint64(tv.sec()) * 1000000 + tv.usec();
+}
+
+/// Same random sequence for both container families
+static uint32 randState;
+
+static uint32 Rand(uint32 max)
+{
+    randState = randState * 1103515245 + 12345;
+    return (randState >> 8) % max;
+}
+
+struct StdSets
+{
+    static char const* Name() { return "std"; }
+
+    typedef std::set<void*> AttackerSet;
+    typedef std::set<uint32> ComboPointHolderSet;
+    typedef std::list<uint64> DynObjectGUIDs;
+    typedef std::set<uint64> ClientGUIDs;
+};
+
+struct FlatSets
+{
+    static char const* Name() { return "flat"; }
+
+    typedef FlatSet<void*, 8> AttackerSet;
+    typedef FlatSet<uint32, 4> ComboPointHolderSet;
+    typedef SmallVector<uint64, 4> DynObjectGUIDs;
+    typedef FlatHashSet<uint64, 0> ClientGUIDs;
+};
+
+template<class Sets>
+struct SimUnit
+{
+    typename Sets::AttackerSet attackers;
+    typename Sets::ComboPointHolderSet comboHolders;
+    typename Sets::DynObjectGUIDs dynObjects;
+    SimUnit* victim;
+};
+
+struct Result
+{
+    Result() : allocations(0), elapsed(0.0), checksum(0) {}
+
+    uint64 allocations;
+    double elapsed;
+    uint64 checksum;
+};
+
+/// Units pick, switch and drop victims like Unit::Attack/AttackStop, rogues open combo points on
+/// their victims, casters place and remove area auras, threat checks walk the attacker sets.
+template<class Sets>
+static Result RunCombat(uint32 unitCount, uint32 ticks)
+{
+    typedef SimUnit<Sets> Unit;
+
+    randState = 1;
+    Result result;
+    uint64 startAllocations = allocations;
+    uint64 start = NowUs();
+
+    std::vector<Unit*> units(unitCount);
+    for (uint32 i = 0; i < unitCount; ++i)
+    {
+        units[i] = new Unit;
+        units[i]->victim = NULL;
+    }
+
+    uint64 nextDynObject = 1;
+    for (uint32 tick = 0; tick < ticks; ++tick)
+    {
+        for (uint32 i = 0; i < unitCount; ++i)
+        {
+            Unit* unit = units[i];
+            switch (Rand(8))
+            {
+                case 0:                                         // switch victim, nearby units only
+                {
+                    Unit* victim = units[(i + 1 + Rand(15)) % unitCount];
+                    if (unit->victim)
+                        unit->victim->attackers.erase((void*)unit);
+                    unit->victim = victim;
+                    victim->attackers.insert((void*)unit);
+                    break;
+                }
+                case 1:                                         // stop attacking
+                    if (unit->victim)
+                    {
+                        unit->victim->attackers.erase((void*)unit);
+                        unit->victim->comboHolders.erase(i);
+                        unit->victim = NULL;
+                    }
+                    break;
+                case 2:
+                    if (unit->victim)
+                        unit->victim->comboHolders.insert(i);
+                    break;
+                case 3:
+                    unit->dynObjects.push_back(nextDynObject++);
+                    break;
+                case 4:
+                    if (!unit->dynObjects.empty())
+                        unit->dynObjects.erase(unit->dynObjects.begin());
+                    break;
+                default:                                        // attacker lookups of threat and assist code
+                    for (typename Sets::AttackerSet::const_iterator itr = unit->attackers.begin(); itr != unit->attackers.end(); ++itr)
+                        result.checksum += ((Unit*)*itr)->attackers.find((void*)unit) != ((Unit*)*itr)->attackers.end();
+                    result.checksum += unit->attackers.size();
+                    break;
+            }
+        }
+    }
+
+    for (uint32 i = 0; i < unitCount; ++i)
+        delete units[i];
+
+    result.elapsed = double(NowUs() - start) / 1000000.0;
+    result.allocations = allocations - startAllocations;
+    return result;
+}
+
+/// Players moving through a crowd: each update copies the client guids like VisibleNotifier,
+/// strikes the objects still in sight, adds the new ones and drops the ones left behind.
+template<class Sets>
+static Result RunVisibility(uint32 playerCount, uint32 visible, uint32 updates)
+{
+    typedef typename Sets::ClientGUIDs ClientGUIDs;
+
+    randState = 1;
+    Result result;
+    uint64 startAllocations = allocations;
+    uint64 start = NowUs();
+
+    std::vector<ClientGUIDs> clientGUIDs(playerCount);
+    std::vector<uint64> inSight(playerCount);           // first guid of the window each player sees
+
+    for (uint32 i = 0; i < playerCount; ++i)
+    {
+        inSight[i] = 1 + Rand(100000);
+        for (uint32 j = 0; j < visible; ++j)
+            clientGUIDs[i].insert(inSight[i] + j);
+    }
+
+    for (uint32 update = 0; update < updates; ++update)
+    {
+        for (uint32 i = 0; i < playerCount; ++i)
+        {
+            ClientGUIDs& atClient = clientGUIDs[i];
+            uint64 first = inSight[i] + Rand(8);        // moved a bit
+
+            ClientGUIDs vis_guids(atClient);
+            for (uint64 guid = first; guid < first + visible; ++guid)
+            {
+                if (vis_guids.find(guid) != vis_guids.end())
+                    vis_guids.erase(guid);
+                else
+                    atClient.insert(guid);
+            }
+
+            for (typename ClientGUIDs::const_iterator itr = vis_guids.begin(); itr != vis_guids.end(); ++itr)
+                atClient.erase(*itr);
+
+            // HaveAtClient checks of packet broadcasts
+            for (uint32 j = 0; j < 16; ++j)
+                result.checksum += atClient.find(first + Rand(visible * 2)) != atClient.end();
+
+            inSight[i] = first;
+        }
+    }
+
+    clientGUIDs.clear();
+
+    result.elapsed = double(NowUs() - start) / 1000000.0;
+    result.allocations = allocations - startAllocations;
+    return result;
+}
+
+static void Print(char const* bench, char const* name, Result const& result)
+{
+    printf("%-10s %-5s %12llu allocations in %.3f s (checksum %llu)\n", bench, name,
+        (unsigned long long)result.allocations, result.elapsed, (unsigned long long)result.checksum);
+}
+
+static void Compare(char const* bench, Result const& before, Result const& after)
+{
+    printf("%-10s allocations %+.1f%%, time %+.1f%%\n", bench,
+        before.allocations ? (double(after.allocations) / before.allocations - 1.0) * 100.0 : 0.0,
+        (after.elapsed / before.elapsed - 1.0) * 100.0);
+}
+
+void usage(const char *prog)
+{
+    printf("Usage: \n %s [<options>]\n"
+        "    -u units                 units in combat (default 2000)\n"
+        "    -t ticks                 combat ticks (default 2000)\n"
+        "    -p players               players for visibility updates (default 500)\n"
+        "    -v objects               objects visible to each player (default 200)\n"
+        "    -n updates               visibility updates per player (default 500)\n",
+        prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32 unitCount = 2000;
+    uint32 ticks = 2000;
+    uint32 playerCount = 500;
+    uint32 visible = 200;
+    uint32 updates = 500;
+
+    ACE_Get_Opt cmd_opts(argc, argv, ":u:t:p:v:n:");
+
+    int option;
+    while ((option = cmd_opts()) != EOF)
+    {
+        switch (option)
+        {
+            case 'u': unitCount = atoi(cmd_opts.opt_arg()); break;
+            case 't': ticks = atoi(cmd_opts.opt_arg()); break;
+            case 'p': playerCount = atoi(cmd_opts.opt_arg()); break;
+            case 'v': visible = atoi(cmd_opts.opt_arg()); break;
+            case 'n': updates = atoi(cmd_opts.opt_arg()); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (unitCount < 16 || !ticks || !playerCount || !visible || !updates)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("combat: %u units for %u ticks, visibility: %u players seeing %u objects for %u updates\n",
+        unitCount, ticks, playerCount, visible, updates);
+
+    Result stdCombat = RunCombat<StdSets>(unitCount, ticks);
+    Print("combat", StdSets::Name(), stdCombat);
+    Result flatCombat = RunCombat<FlatSets>(unitCount, ticks);
+    Print("combat", FlatSets::Name(), flatCombat);
+
+    Result stdVisibility = RunVisibility<StdSets>(playerCount, visible, updates);
+    Print("visibility", StdSets::Name(), stdVisibility);
+    Result flatVisibility = RunVisibility<FlatSets>(playerCount, visible, updates);
+    Print("visibility", FlatSets::Name(), flatVisibility);
+
+    Compare("combat", stdCombat, flatCombat);
+    Compare("visibility", stdVisibility, flatVisibility);
+    return 0;
+}
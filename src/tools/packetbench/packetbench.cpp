@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Microbenchmark of the world socket receive path: network threads build WorldPackets from a
+/// client stream like WorldSocket::handle_input_header/payload and queue them to sessions, update
+/// threads take and delete them like WorldSession::Update, so pooled packets and storage go back to
+/// their pools from other threads. Runs with and without PacketBufferPool.
+
+#include "Common.h"
+#include "WorldPacket.h"
+#include "LockFreeQueue.h"
+#include "Threading.h"
+
+#include <ace/Get_Opt.h>
+#include <ace/OS_NS_sys_time.h>
+#include <ace/Atomic_Op.h>
+
+#include <stdio.h>
+
+static uint64 NowUs()
+{
+    ACE_Time_Value tv = ACE_OS::gettimeofday();
+    return uint64(tv.sec()) * 1000000 + tv.usec();
+}
+
+typedef ACE_Based::LockFreeQueue<WorldPacket*> PacketQueue;
+
+static ACE_Atomic_Op<ACE_Thread_Mutex, long> producersLeft;
+static ACE_Atomic_Op<ACE_Thread_Mutex, long> inFlight;     // clients wait for the server, queues do not grow without limit
+static long maxInFlight;
+static ACE_Atomic_Op<ACE_Thread_Mutex, uint64> processed;
+
+/// Payload sizes of a typical client stream, mostly movement
+static size_t const packetSizes[] = { 30, 34, 38, 30, 42, 30, 8, 4, 30, 34, 38, 30, 120, 30, 34, 512 };
+#define PACKET_SIZE_COUNT (sizeof(packetSizes) / sizeof(packetSizes[0]))
+
+class NetworkRunnable : public ACE_Based::Runnable
+{
+    public:
+        NetworkRunnable(std::vector<PacketQueue*> const& sessions, uint32 count, bool pooled) :
+            m_sessions(sessions), m_count(count), m_pooled(pooled) {}
+
+        void run()
+        {
+            uint8 stream[1024];
+            for (size_t i = 0; i < sizeof(stream); ++i)
+                stream[i] = uint8(i);
+
+            PacketBufferPool& pool = PacketBufferPool::ThreadInstance();
+
+            for (uint32 i = 0; i < m_count; ++i)
+            {
+                while (inFlight.value() >= maxInFlight)
+                    ACE_Based::Thread::Sleep(0);
+
+                ++inFlight;
+
+                size_t size = packetSizes[i % PACKET_SIZE_COUNT];
+                uint16 opcode = uint16(0xB5 + (i & 7));
+
+                WorldPacket* packet = m_pooled ? new (pool) WorldPacket(opcode, size, pool) : new WorldPacket(opcode, size);
+                packet->resize(size);
+                memcpy((void*)packet->contents(), stream, size);
+
+                m_sessions[i % m_sessions.size()]->add(packet);
+            }
+
+            --producersLeft;
+        }
+
+    private:
+        std::vector<PacketQueue*> m_sessions;
+        uint32 m_count;
+        bool m_pooled;
+};
+
+class UpdateRunnable : public ACE_Based::Runnable
+{
+    public:
+        explicit UpdateRunnable(std::vector<PacketQueue*> const& sessions) : m_sessions(sessions) {}
+
+        void run()
+        {
+            uint64 count = 0;
+            uint32 checksum = 0;
+
+            while (true)
+            {
+                bool done = producersLeft.value() == 0;
+                bool any = false;
+
+                for (size_t i = 0; i < m_sessions.size(); ++i)
+                {
+                    WorldPacket* packet;
+                    while (m_sessions[i]->next(packet))
+                    {
+                        checksum += packet->GetOpcode() + packet->read<uint32>();
+                        delete packet;
+                        --inFlight;
+                        ++count;
+                        any = true;
+                    }
+                }
+
+                // queues were empty after the last producer finished
+                if (done && !any)
+                    break;
+            }
+
+            processed += count;
+            if (checksum == 1)                              // keep the reads
+                printf(" ");
+        }
+
+    private:
+        std::vector<PacketQueue*> m_sessions;
+};
+
+static double RunBench(uint32 networkThreads, uint32 updateThreads, uint32 sessionsPerThread, uint32 count, bool pooled)
+{
+    std::vector<std::vector<PacketQueue*> > sessions(updateThreads);
+    std::vector<PacketQueue*> allSessions;
+    for (uint32 i = 0; i < updateThreads; ++i)
+    {
+        for (uint32 j = 0; j < sessionsPerThread; ++j)
+        {
+            PacketQueue* queue = new PacketQueue;
+            sessions[i].push_back(queue);
+            allSessions.push_back(queue);
+        }
+    }
+
+    producersLeft = networkThreads;
+    processed = 0;
+    inFlight = 0;
+
+    uint64 start = NowUs();
+
+    std::vector<ACE_Based::Thread*> threads;
+    for (uint32 i = 0; i < updateThreads; ++i)
+        threads.push_back(new ACE_Based::Thread(new UpdateRunnable(sessions[i])));
+    for (uint32 i = 0; i < networkThreads; ++i)
+        threads.push_back(new ACE_Based::Thread(new NetworkRunnable(allSessions, count, pooled)));
+
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i]->wait();
+        delete threads[i];
+    }
+
+    double elapsed = double(NowUs() - start) / 1000000.0;
+
+    for (size_t i = 0; i < allSessions.size(); ++i)
+        delete allSessions[i];
+
+    double rate = double(processed.value()) / elapsed;
+    printf("%-10s %llu packets in %.3f s: %.0f packets/s\n", pooled ? "pooled" : "allocated",
+        (unsigned long long)processed.value(), elapsed, rate);
+    return rate;
+}
+
+void usage(const char *prog)
+{
+    printf("Usage: \n %s [<options>]\n"
+        "    -n threads               network threads building packets (default 2)\n"
+        "    -u threads               update threads deleting packets (default 2)\n"
+        "    -s sessions              sessions per update thread (default 50)\n"
+        "    -c count                 packets per network thread (default 2000000)\n"
+        "    -w packets               packets queued but not yet processed (default 4096)\n"
+        "    -r runs                  runs of each mode (default 3)\n",
+        prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32 networkThreads = 2;
+    uint32 updateThreads = 2;
+    uint32 sessionsPerThread = 50;
+    uint32 count = 2000000;
+    uint32 runs = 3;
+    maxInFlight = 4096;
+
+    ACE_Get_Opt cmd_opts(argc, argv, ":n:u:s:c:w:r:");
+
+    int option;
+    while ((option = cmd_opts()) != EOF)
+    {
+        switch (option)
+        {
+            case 'n': networkThreads = atoi(cmd_opts.opt_arg()); break;
+            case 'u': updateThreads = atoi(cmd_opts.opt_arg()); break;
+            case 's': sessionsPerThread = atoi(cmd_opts.opt_arg()); break;
+            case 'c': count = atoi(cmd_opts.opt_arg()); break;
+            case 'w': maxInFlight = atoi(cmd_opts.opt_arg()); break;
+            case 'r': runs = atoi(cmd_opts.opt_arg()); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (!networkThreads || !updateThreads || !sessionsPerThread || !count || maxInFlight <= 0 || !runs)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("%u network threads, %u update threads with %u sessions each, %u packets per network thread\n",
+        networkThreads, updateThreads, sessionsPerThread, count);
+
+    double allocated = 0.0, pooled = 0.0;
+    for (uint32 i = 0; i < runs; ++i)
+    {
+        allocated += RunBench(networkThreads, updateThreads, sessionsPerThread, count, false);
+        pooled += RunBench(networkThreads, updateThreads, sessionsPerThread, count, true);
+    }
+
+    printf("Average: allocated %.0f packets/s, pooled %.0f packets/s (%+.1f%%)\n",
+        allocated / runs, pooled / runs, (pooled / allocated - 1.0) * 100.0);
+    return 0;
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Load generator for realmd: runs full logon challenge / proof (and optionally realm list)
+/// handshakes from several threads and reports handshakes per second.
+
+#include "Common.h"
+#include "Auth/BigNumber.h"
+#include "Auth/Sha1.h"
+#include "ByteBuffer.h"
+#include "Threading.h"
+
+#include <ace/Get_Opt.h>
+#include <ace/INET_Addr.h>
+#include <ace/SOCK_Connector.h>
+#include <ace/SOCK_Stream.h>
+#include <ace/OS_NS_sys_time.h>
+#include <ace/Atomic_Op.h>
+
+#include <stdio.h>
+
+enum
+{
+    CMD_AUTH_LOGON_CHALLENGE    = 0x00,
+    CMD_AUTH_LOGON_PROOF        = 0x01,
+    CMD_REALM_LIST              = 0x10
+};
+
+struct BenchConfig
+{
+    std::string host;
+    uint16 port;
+    std::string login;                                      // upper case
+    std::string password;                                   // upper case
+    uint32 seconds;
+    bool realmList;
+};
+
+static BenchConfig config;
+
+static ACE_Atomic_Op<ACE_Thread_Mutex, long> succeeded;
+static ACE_Atomic_Op<ACE_Thread_Mutex, long> failed;
+static ACE_Atomic_Op<ACE_Thread_Mutex, uint64> totalLatencyUs;
+
+static uint64 NowUs()
+{
+    ACE_Time_Value tv = ACE_OS::gettimeofday();
+    return uint64(tv.sec()) * 1000000 + tv.usec();
+}
+
+static std::string ToUpper(std::string str)
+{
+    std::transform(str.begin(), str.end(), str.begin(), ::toupper);
+    return str;
+}
+
+/// One client connection doing the same steps as the game client
+class BenchClient
+{
+    public:
+        bool Handshake();
+
+    private:
+        bool SendChallenge();
+        bool HandleChallenge();
+        bool HandleProof();
+        bool HandleRealmList();
+
+        bool Recv(void* buf, size_t len) { return m_stream.recv_n(buf, len) == ssize_t(len); }
+        bool Send(ByteBuffer const& pkt) { return m_stream.send_n(pkt.contents(), pkt.size()) == ssize_t(pkt.size()); }
+
+        ACE_SOCK_Stream m_stream;
+
+        BigNumber N, g, s, B;
+        BigNumber a, A, K, M;
+};
+
+bool BenchClient::Handshake()
+{
+    ACE_INET_Addr addr(config.port, config.host.c_str());
+    ACE_SOCK_Connector connector;
+
+    if (connector.connect(m_stream, addr) == -1)
+        return false;
+
+    bool ok = SendChallenge() && HandleChallenge() && HandleProof() && (!config.realmList || HandleRealmList());
+
+    m_stream.close();
+    return ok;
+}
+
+bool BenchClient::SendChallenge()
+{
+    ByteBuffer pkt;
+    pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
+    pkt << uint8(0x08);
+    pkt << uint16(30 + config.login.size());                // size of the rest
+    pkt.append("WoW", 4);                                   // game name
+    pkt << uint8(2) << uint8(4) << uint8(3);                // version 2.4.3
+    pkt << uint16(8606);                                    // build
+    pkt.append("68x", 4);                                   // platform, reversed
+    pkt.append("niW", 4);                                   // os, reversed
+    pkt.append("SUne", 4);                                  // country, reversed
+    pkt << uint32(0);                                       // timezone bias
+    pkt << uint8(127) << uint8(0) << uint8(0) << uint8(1);  // local ip
+    pkt << uint8(config.login.size());
+    pkt.append(config.login.c_str(), config.login.size());
+
+    return Send(pkt);
+}
+
+bool BenchClient::HandleChallenge()
+{
+    uint8 header[3];
+    if (!Recv(header, sizeof(header)) || header[0] != CMD_AUTH_LOGON_CHALLENGE || header[2] != 0)
+        return false;
+
+    // B[32], g_len, g[1], N_len, N[32], s[32], unk[16], security flags
+    uint8 body[32 + 1 + 1 + 1 + 32 + 32 + 16 + 1];
+    if (!Recv(body, sizeof(body)) || body[32] != 1 || body[34] != 32 || body[115] != 0)
+        return false;
+
+    B.SetBinary(body, 32);
+    g.SetBinary(body + 33, 1);
+    N.SetBinary(body + 35, 32);
+    s.SetBinary(body + 67, 32);
+
+    ///- x = H(s | H(I:P)), same digest as account.pass_hash
+    Sha1Hash sha;
+    sha.UpdateData(config.login);
+    sha.UpdateData(":");
+    sha.UpdateData(config.password);
+    sha.Finalize();
+
+    uint8 passHash[SHA_DIGEST_LENGTH];
+    memcpy(passHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateData(s.AsByteArray(), s.GetNumBytes());
+    sha.UpdateData(passHash, SHA_DIGEST_LENGTH);
+    sha.Finalize();
+
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), sha.GetLength());
+
+    a.SetRand(19 * 8);
+    A = g.ModExp(a, N);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&A, &B, NULL);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), 20);
+
+    ///- S = (B - 3 * g^x) ^ (a + u * x)
+    BigNumber kgx = (g.ModExp(x, N) * 3) % N;
+    BigNumber base = ((B + N) - kgx) % N;
+    BigNumber S = base.ModExp(a + u * x, N);
+
+    uint8 t[32];
+    uint8 t1[16];
+    uint8 vK[40];
+    memcpy(t, S.AsByteArray(32), 32);
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2] = sha.GetDigest()[i];
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2 + 1];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2 + 1] = sha.GetDigest()[i];
+    K.SetBinary(vK, 40);
+
+    ///- M1 = H(H(N) xor H(g), H(I), s, A, B, K)
+    uint8 hash[20];
+    sha.Initialize();
+    sha.UpdateBigNumbers(&N, NULL);
+    sha.Finalize();
+    memcpy(hash, sha.GetDigest(), 20);
+    sha.Initialize();
+    sha.UpdateBigNumbers(&g, NULL);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        hash[i] ^= sha.GetDigest()[i];
+    BigNumber t3;
+    t3.SetBinary(hash, 20);
+
+    sha.Initialize();
+    sha.UpdateData(config.login);
+    sha.Finalize();
+    uint8 t4[SHA_DIGEST_LENGTH];
+    memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&t3, NULL);
+    sha.UpdateData(t4, SHA_DIGEST_LENGTH);
+    sha.UpdateBigNumbers(&s, &A, &B, &K, NULL);
+    sha.Finalize();
+    M.SetBinary(sha.GetDigest(), 20);
+
+    ByteBuffer pkt;
+    pkt << uint8(CMD_AUTH_LOGON_PROOF);
+    pkt.append(A.AsByteArray(32), 32);
+    pkt.append(M.AsByteArray(20), 20);
+    for (int i = 0; i < 20; ++i)                            // crc hash
+        pkt << uint8(0);
+    pkt << uint8(0);                                        // number of keys
+    pkt << uint8(0);                                        // security flags
+
+    return Send(pkt);
+}
+
+bool BenchClient::HandleProof()
+{
+    uint8 header[2];
+    if (!Recv(header, sizeof(header)) || header[0] != CMD_AUTH_LOGON_PROOF || header[1] != 0)
+        return false;
+
+    // M2[20], account flags, survey id, unk flags
+    uint8 body[20 + 4 + 4 + 2];
+    if (!Recv(body, sizeof(body)))
+        return false;
+
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(&A, &M, &K, NULL);
+    sha.Finalize();
+
+    return !memcmp(body, sha.GetDigest(), 20);
+}
+
+bool BenchClient::HandleRealmList()
+{
+    ByteBuffer pkt;
+    pkt << uint8(CMD_REALM_LIST);
+    pkt << uint32(0);
+
+    if (!Send(pkt))
+        return false;
+
+    uint8 header[3];
+    if (!Recv(header, sizeof(header)) || header[0] != CMD_REALM_LIST)
+        return false;
+
+    uint16 size = uint16(header[1]) | (uint16(header[2]) << 8);
+    std::vector<uint8> body(size);
+    return !size || Recv(&body[0], size);
+}
+
+class BenchRunnable : public ACE_Based::Runnable
+{
+    public:
+        explicit BenchRunnable(uint64 endTime) : m_endTime(endTime) {}
+
+        void run()
+        {
+            while (NowUs() < m_endTime)
+            {
+                uint64 start = NowUs();
+
+                BenchClient client;
+                if (client.Handshake())
+                {
+                    ++succeeded;
+                    totalLatencyUs += NowUs() - start;
+                }
+                else
+                    ++failed;
+            }
+        }
+
+    private:
+        uint64 m_endTime;
+};
+
+void usage(const char *prog)
+{
+    printf("Usage: \n %s [<options>]\n"
+        "    -h host                  realmd address (default 127.0.0.1)\n"
+        "    -p port                  realmd port (default 3724)\n"
+        "    -u account               account name\n"
+        "    -w password              account password\n"
+        "    -c clients               concurrent connections (default 16)\n"
+        "    -t seconds               test duration (default 10)\n"
+        "    -r                       request the realm list after the proof\n"
+        "Note: realmd WrongPass.MaxCount bans the address when the password is wrong.\n",
+        prog);
+}
+
+int main(int argc, char **argv)
+{
+    config.host = "127.0.0.1";
+    config.port = 3724;
+    config.seconds = 10;
+    config.realmList = false;
+
+    uint32 clients = 16;
+
+    ACE_Get_Opt cmd_opts(argc, argv, ":h:p:u:w:c:t:r");
+
+    int option;
+    while ((option = cmd_opts()) != EOF)
+    {
+        switch (option)
+        {
+            case 'h': config.host = cmd_opts.opt_arg(); break;
+            case 'p': config.port = atoi(cmd_opts.opt_arg()); break;
+            case 'u': config.login = ToUpper(cmd_opts.opt_arg()); break;
+            case 'w': config.password = ToUpper(cmd_opts.opt_arg()); break;
+            case 'c': clients = atoi(cmd_opts.opt_arg()); break;
+            case 't': config.seconds = atoi(cmd_opts.opt_arg()); break;
+            case 'r': config.realmList = true; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (config.login.empty() || config.login.size() > 16 || !clients || !config.seconds)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("Running %u clients against %s:%u for %u seconds...\n", clients, config.host.c_str(), config.port, config.seconds);
+
+    uint64 start = NowUs();
+    uint64 end = start + uint64(config.seconds) * 1000000;
+
+    std::vector<ACE_Based::Thread*> threads;
+    for (uint32 i = 0; i < clients; ++i)
+        threads.push_back(new ACE_Based::Thread(new BenchRunnable(end)));
+
+    for (uint32 i = 0; i < threads.size(); ++i)
+    {
+        threads[i]->wait();
+        delete threads[i];
+    }
+
+    double elapsed = double(NowUs() - start) / 1000000.0;
+    long ok = succeeded.value();
+
+    printf("Handshakes: %ld succeeded, %ld failed in %.2f s\n", ok, failed.value(), elapsed);
+    printf("Rate: %.1f handshakes/s, average latency %.2f ms\n", ok / elapsed, ok ? double(totalLatencyUs.value()) / ok / 1000.0 : 0.0);
+    return 0;
+}
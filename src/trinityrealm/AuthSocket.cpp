@@ -28,6 +28,8 @@
 #include "AuthSocket.h"
 #include "AuthCodes.h"
 #include "PatchHandler.h"
+#include "BanList.h"
+#include "Database/SqlOperations.h"
 
 #include <openssl/md5.h>
 //#include "Util.h" -- for commented utf8ToUpperOnlyLatin
@@ -186,8 +188,13 @@ AuthSocket::AuthSocket()
     N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
     g.SetDword(7);
     _authed = false;
+    _queryPending = false;
+    _queryResult = NULL;
+    _queryHandler = NULL;
+    _accountId = 0;
 
     accountPermissionMask_ = PERM_PLAYER;
+    _realmCharactersLoaded = false;
 
     _build = 0;
     patch_ = ACE_INVALID_HANDLE;
@@ -198,6 +205,8 @@ AuthSocket::~AuthSocket()
 {
     if(patch_ != ACE_INVALID_HANDLE)
         ACE_OS::close(patch_);
+
+    delete _queryResult;
 }
 
 /// Accept the connection and set the s random value for SRP6
@@ -212,6 +221,10 @@ void AuthSocket::OnRead()
     uint8 _cmd;
     while (1)
     {
+        // the rest stays buffered until the pending request is done
+        if (_queryPending)
+            return;
+
         if(!recv_soft((char *)&_cmd, 1))
             return;
 
@@ -275,7 +288,8 @@ void AuthSocket::_SetVSFields(const std::string& rI)
     v_hex = v.AsHexStr();
     s_hex = s.AsHexStr();
 
-    AccountsDatabase.DirectPExecute("UPDATE account_session SET v = '%s', s = '%s' WHERE username = '%s'", v_hex, s_hex, _safelogin.c_str() );
+    // async, the session key update issued at logon proof is executed after it on the same connection
+    AccountsDatabase.PExecute("UPDATE account_session SET v = '%s', s = '%s' WHERE account_id = '%u'", v_hex, s_hex, _accountId);
 
     OPENSSL_free((void*)v_hex);
     OPENSSL_free((void*)s_hex);
@@ -368,8 +382,6 @@ bool AuthSocket::_HandleLogonChallenge()
 
     localIp_ = tmpLocalIp.str();
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
     operatingSystem_ = (const char*)ch->os;
@@ -390,6 +402,11 @@ bool AuthSocket::_HandleLogonChallenge()
     _safelogin = _login;
     AccountsDatabase.escape_string(_safelogin);
 
+    _localizationName.resize(4);
+    for (int i = 0; i < 4; ++i)
+        _localizationName[i] = ch->country[4-i-1];
+
+    ByteBuffer pkt;
     pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
     pkt << (uint8) 0x00;
 
@@ -407,171 +424,172 @@ bool AuthSocket::_HandleLogonChallenge()
     }
 #endif
 
-    ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    AccountsDatabase.Execute("DELETE FROM ip_banned WHERE unbandate<=UNIX_TIMESTAMP() AND unbandate<>bandate");
-    AccountsDatabase.escape_string(address);
-    //Delete ViP
-	AccountsDatabase.Execute("UPDATE account_permissions SET permission_mask = 1 WHERE unsetdate<=UNIX_TIMESTAMP() AND unsetdate<>setdate");
-    QueryResultAutoPtr result = AccountsDatabase.PQuery("SELECT * FROM ip_banned WHERE ip = '%s'", address.c_str());
-
-    if (result) // ip banned
+    ///- Verify that this IP is not banned, ip_banned is kept in memory by sBanList
+    if (sBanList.IsIpBanned(address))
     {
-        sLog.outBasic("[AuthChallenge] Banned ip %s tries to login!", get_remote_address().c_str());
+        sLog.outBasic("[AuthChallenge] Banned ip %s tries to login!", address.c_str());
         pkt << uint8(WOW_FAIL_BANNED);
         send((char const*)pkt.contents(), pkt.size());
         return true;
     }
 
-    ///- Get the account details from the account table
-    // No SQL injection (escaped user name)
-
-    result = AccountsDatabase.PQuery("SELECT pass_hash, account.account_id, account_state_id, last_ip, permission_mask, email "
-                                     "FROM account JOIN account_permissions ON account.account_id = account_permissions.account_id "
-                                     "WHERE username = '%s'", _safelogin.c_str());
+    ///- Reset expired temporary permissions, runs on the async connection before the account query below
+    AccountsDatabase.Execute("UPDATE account_permissions SET permission_mask = 1 WHERE unsetdate<=UNIX_TIMESTAMP() AND unsetdate<>setdate");
 
-    if (!result)    // account not exists
+    ///- Get the account details and active account bans without blocking the other connections
+    // No SQL injection (escaped user name)
+    SqlQueryHolder* holder = new SqlQueryHolder;
+    holder->SetSize(2);
+    holder->SetPQuery(0, "SELECT pass_hash, account.account_id, account_state_id, last_ip, permission_mask, email "
+                         "FROM account JOIN account_permissions ON account.account_id = account_permissions.account_id "
+                         "WHERE username = '%s'", _safelogin.c_str());
+    holder->SetPQuery(1, "SELECT punishment_date, expiration_date "
+                         "FROM account_punishment JOIN account ON account_punishment.account_id = account.account_id "
+                         "WHERE username = '%s' AND punishment_type_id = '%u' AND (punishment_date = expiration_date OR expiration_date > UNIX_TIMESTAMP())", _safelogin.c_str(), PUNISHMENT_BAN);
+
+    if (!_DelayQuery(holder, &AuthSocket::_HandleLogonChallengeCallback))
     {
-        pkt<< uint8(WOW_FAIL_UNKNOWN_ACCOUNT);
+        pkt << uint8(WOW_FAIL_DB_BUSY);
         send((char const*)pkt.contents(), pkt.size());
-        return true;
     }
 
-    Field * fields = result->Fetch();
+    return true;
+}
 
-    ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
-    switch (fields[2].GetUInt8())
+void AuthSocket::_HandleLogonChallengeCallback(SqlQueryHolder* holder)
+{
+    QueryResultAutoPtr result = holder->GetResult(0);
+    QueryResultAutoPtr banresult = holder->GetResult(1);
+
+    if (_FinishQuery())
     {
-        case ACCOUNT_STATE_IP_LOCKED:
+        ByteBuffer pkt;
+        pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+        pkt << (uint8) 0x00;
+
+        if (!result)    // account not exists
+            pkt << uint8(WOW_FAIL_UNKNOWN_ACCOUNT);
+        else
         {
-            DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), (*result)[3].GetString());
-            DEBUG_LOG("[AuthChallenge] Player address is '%s'", get_remote_address().c_str());
-            if (strcmp(fields[4].GetString(), get_remote_address().c_str()))
+            Field * fields = result->Fetch();
+            uint8 error = WOW_SUCCESS;
+
+            ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
+            switch (fields[2].GetUInt8())
             {
-                DEBUG_LOG("[AuthChallenge] Account IP differs");
-                    pkt << (uint8) WOW_FAIL_LOCKED_ENFORCED;
-                send((char const*)pkt.contents(), pkt.size());
-                return true;
+                case ACCOUNT_STATE_IP_LOCKED:
+                {
+                    DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[3].GetString());
+                    DEBUG_LOG("[AuthChallenge] Player address is '%s'", get_remote_address().c_str());
+                    if (strcmp(fields[3].GetString(), get_remote_address().c_str()))
+                    {
+                        DEBUG_LOG("[AuthChallenge] Account IP differs");
+                        error = WOW_FAIL_LOCKED_ENFORCED;
+                    }
+                    else
+                    {
+                        DEBUG_LOG("[AuthChallenge] Account IP matches");
+                    }
+                    break;
+                }
+                case ACCOUNT_STATE_FROZEN:
+                    error = WOW_FAIL_SUSPENDED;
+                    break;
+                default:
+                    DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip or frozen", _login.c_str());
+                    break;
             }
-            else
+
+            if (error == WOW_SUCCESS)
             {
-                DEBUG_LOG("[AuthChallenge] Account IP matches");
+                RealmList::ReadGuard guard(sRealmList.GetLock());
+                Realm const* realm = sRealmList.FindRealm(1);
+                if (realm && fields[4].GetUInt64() < realm->requiredPermissionMask)
+                    error = WOW_FAIL_FAIL_NOACCESS;
             }
-            break;
-        }
-        case ACCOUNT_STATE_FROZEN:
-        {
-            pkt << uint8(WOW_FAIL_SUSPENDED);
-            send((char const*)pkt.contents(), pkt.size());
-            return true;
-        }
-        default:
-            DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip or frozen", _login.c_str());
-            break;
-    }
-
-    QueryResultAutoPtr permission_result = AccountsDatabase.PQuery("SELECT required_permission_mask FROM realms WHERE realm_id = 1");
-    
-    if (permission_result)
-    {
-        Field * permission_fields =  permission_result->Fetch();
-        if (fields[4].GetUInt32() < permission_fields[0].GetUInt32())
-        {
-            pkt<< uint8(WOW_FAIL_FAIL_NOACCESS);
-            send((char const*)pkt.contents(), pkt.size());
-            return true;
-        }
 
-    }
+            ///- If the account is banned, reject the logon attempt
+            if (error == WOW_SUCCESS && banresult)
+            {
+                if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
+                {
+                    error = WOW_FAIL_BANNED;
+                    sLog.outBasic("[AuthChallenge] Banned account %s tries to login!", _login.c_str ());
+                }
+                else
+                {
+                    error = WOW_FAIL_SUSPENDED;
+                    sLog.outBasic("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str ());
+                }
+            }
 
-    ///- If the account is banned, reject the logon attempt
-    QueryResultAutoPtr  banresult = AccountsDatabase.PQuery("SELECT punishment_date, expiration_date "
-                                                            "FROM account_punishment "
-                                                            "WHERE account_id = '%u' AND punishment_type_id = '%u' AND (punishment_date = expiration_date OR expiration_date > UNIX_TIMESTAMP())", (*result)[1].GetUInt32(), PUNISHMENT_BAN);
+            if (error == WOW_SUCCESS && sBanList.IsEmailBanned(fields[5].GetCppString()))
+            {
+                error = WOW_FAIL_BANNED;
+                sLog.outBasic("[AuthChallenge] Account %s with banned email %s tries to login!", _login.c_str (), fields[5].GetString());
+            }
 
-    if (banresult)
-    {
-        if((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-        {
-            pkt << uint8(WOW_FAIL_BANNED);
-            sLog.outBasic("[AuthChallenge] Banned account %s tries to login!", _login.c_str ());
-        }
-        else
-        {
-            pkt << uint8(WOW_FAIL_SUSPENDED);
-            sLog.outBasic("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str ());
-        }
+            if (error != WOW_SUCCESS)
+                pkt << uint8(error);
+            else
+            {
+                _accountId = fields[1].GetUInt32();
+                accountPermissionMask_ = fields[4].GetUInt64();
 
-        send((char const*)pkt.contents(), pkt.size());
-        return true;
-    }
+                ///- Get the password from the account table, upper it, and make the SRP6 calculation
+                std::string rI = fields[0].GetCppString();
 
-    QueryResultAutoPtr  emailbanresult = AccountsDatabase.PQuery("SELECT email FROM email_banned WHERE email = '%s'", (*result)[5].GetString());
-    if (emailbanresult)
-    {
-        pkt << uint8(WOW_FAIL_BANNED);
-        sLog.outBasic("[AuthChallenge] Account %s with banned email %s tries to login!", _login.c_str (), (*emailbanresult)[0].GetString());
+                _SetVSFields(rI);
 
-        send((char const*)pkt.contents(), pkt.size());
-        return true;
-    }
+                b.SetRand(19 * 8);
+                BigNumber gmod = g.ModExp(b, N);
+                B = ((v * 3) + gmod) % N;
 
-    ///- Get the password from the account table, upper it, and make the SRP6 calculation
-    std::string rI = fields[0].GetCppString();
+                ASSERT(gmod.GetNumBytes() <= 32);
 
-    _SetVSFields(rI);
+                BigNumber unk3;
+                unk3.SetRand(16 * 8);
 
-    b.SetRand(19 * 8);
-    BigNumber gmod = g.ModExp(b, N);
-    B = ((v * 3) + gmod) % N;
+                ///- Fill the response packet with the result
+                pkt << uint8(WOW_SUCCESS);
 
-    ASSERT(gmod.GetNumBytes() <= 32);
+                // B may be calculated < 32B so we force minimal length to 32B
+                pkt.append(B.AsByteArray(32), 32);      // 32 bytes
+                pkt << uint8(1);
+                pkt.append(g.AsByteArray(), 1);
+                pkt << uint8(32);
+                pkt.append(N.AsByteArray(32), 32);
+                pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
+                pkt.append(unk3.AsByteArray(16), 16);
+                uint8 securityFlags = 0;
+                pkt << uint8(securityFlags);            // security flags (0x0...0x04)
 
-    BigNumber unk3;
-    unk3.SetRand(16 * 8);
+                if (securityFlags & 0x01)                // PIN input
+                {
+                    pkt << uint32(0);
+                    pkt << uint64(0) << uint64(0);      // 16 bytes hash?
+                }
 
-    ///- Fill the response packet with the result
-    pkt << uint8(WOW_SUCCESS);
+                if (securityFlags & 0x02)                // Matrix input
+                {
+                    pkt << uint8(0);
+                    pkt << uint8(0);
+                    pkt << uint8(0);
+                    pkt << uint8(0);
+                    pkt << uint64(0);
+                }
 
-    // B may be calculated < 32B so we force minimal length to 32B
-    pkt.append(B.AsByteArray(32), 32);      // 32 bytes
-    pkt << uint8(1);
-    pkt.append(g.AsByteArray(), 1);
-    pkt << uint8(32);
-    pkt.append(N.AsByteArray(32), 32);
-    pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
-    pkt.append(unk3.AsByteArray(16), 16);
-    uint8 securityFlags = 0;
-    pkt << uint8(securityFlags);            // security flags (0x0...0x04)
+                if (securityFlags & 0x04)                // Security token input
+                    pkt << uint8(1);
 
-    if (securityFlags & 0x01)                // PIN input
-    {
-        pkt << uint32(0);
-        pkt << uint64(0) << uint64(0);      // 16 bytes hash?
-    }
+                sLog.outBasic("[AuthChallenge] account %s is using '%s' locale (%u)", _login.c_str (), _localizationName.c_str(), GetLocaleByName(_localizationName));
+            }
+        }
 
-    if (securityFlags & 0x02)                // Matrix input
-    {
-        pkt << uint8(0);
-        pkt << uint8(0);
-        pkt << uint8(0);
-        pkt << uint8(0);
-        pkt << uint64(0);
+        send((char const*)pkt.contents(), pkt.size());
     }
 
-    if (securityFlags & 0x04)                // Security token input
-        pkt << uint8(1);
-
-    accountPermissionMask_ = fields[4].GetUInt64();
-
-    _localizationName.resize(4);
-    for (int i = 0; i < 4; ++i)
-        _localizationName[i] = ch->country[4-i-1];
-
-    sLog.outBasic("[AuthChallenge] account %s is using '%c%c%c%c' locale (%u)", _login.c_str (), ch->country[3], ch->country[2], ch->country[1], ch->country[0], GetLocaleByName(_localizationName));
-
-    send((char const*)pkt.contents(), pkt.size());
-    return true;
+    _ResumeAfterQuery();
 }
 
 /// Logon Proof command handler
@@ -655,6 +673,10 @@ bool AuthSocket::_HandleLogonProof()
     if (A.isZero())
         return false;
 
+    // no successful logon challenge before
+    if (!_accountId)
+        return false;
+
     Sha1Hash sha;
     sha.UpdateBigNumbers(&A, &B, NULL);
     sha.Finalize();
@@ -741,33 +763,8 @@ bool AuthSocket::_HandleLogonProof()
             sLog.outLog(LOG_WARDEN, "Client %s got unsupported operating system (%s)", _safelogin.c_str(), operatingSystem_.c_str());
         }
 
-        ///- Update the sessionkey, last_ip, last login time and reset number of failed logins in the account table for this account
+        ///- Update last_ip, last login time and reset number of failed logins in the account table for this account
         // No SQL injection (escaped user name) and IP address as received by socket
-        const char* K_hex = K.AsHexStr();
-
-        QueryResultAutoPtr result = AccountsDatabase.PQuery("SELECT account_id FROM account WHERE username = '%s'", _safelogin.c_str());
-
-        if (!result)
-        {
-            if (_build > 6005)                                  // > 1.12.2
-            {
-                char data[4] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 3, 0};
-                send(data, sizeof(data));
-            }
-            else
-            {
-                // 1.x not react incorrectly at 4-byte message use 3 as real error
-                char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT};
-                send(data, sizeof(data));
-            }
-            return true;
-        }
-
-        uint32 accId = result->Fetch()->GetUInt32();
-
-        // direct to be sure that values will be set before character choose, this will slow down logging in a bit ;p
-        AccountsDatabase.DirectPExecute("UPDATE account_session SET session_key = '%s' WHERE account_id = '%u'", K_hex, accId);
-
         static SqlStatementID updateAccount;
         SqlStatement stmt = AccountsDatabase.CreateStatement(updateAccount, "UPDATE account SET last_ip = ?, last_local_ip = ?, last_login = NOW(), locale_id = ?, failed_logins = 0, client_os_version_id = ? WHERE account_id = ?");
         std::string tmpIp = get_remote_address();
@@ -775,20 +772,30 @@ bool AuthSocket::_HandleLogonProof()
         stmt.addString(localIp_.c_str());
         stmt.addUInt8(uint8(GetLocaleByName(_localizationName)));
         stmt.addUInt8(OS);
-        stmt.addUInt32(accId);
-        stmt.DirectExecute();
-
-        OPENSSL_free((void*)K_hex);
+        stmt.addUInt32(_accountId);
+        stmt.Execute();
 
-        ///- Finish SRP6 and send the final result to the client
+        ///- Finish SRP6, the result is sent to the client once the session key is stored
         sha.Initialize();
         sha.UpdateBigNumbers(&A, &M, &K, NULL);
         sha.Finalize();
+        _proof = sha;
 
-        SendProof(sha);
+        // the session key must be set before the client connects to the world server, so the update is
+        // queued as async query and the proof is only sent from its callback
+        const char* K_hex = K.AsHexStr();
 
-        ///- Set _authed to true!
-        _authed = true;
+        SqlQueryHolder* holder = new SqlQueryHolder;
+        holder->SetSize(1);
+        holder->SetPQuery(0, "UPDATE account_session SET session_key = '%s' WHERE account_id = '%u'", K_hex, _accountId);
+
+        OPENSSL_free((void*)K_hex);
+
+        if (!_DelayQuery(holder, &AuthSocket::_HandleLogonProofCallback))
+        {
+            char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_DB_BUSY };
+            send(data, sizeof(data));
+        }
     }
     else
     {
@@ -814,40 +821,63 @@ bool AuthSocket::_HandleLogonProof()
             stmt.addString(_login);
             stmt.Execute();
 
-            if (QueryResultAutoPtr loginfail = AccountsDatabase.PQuery("SELECT account_id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
-            {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
-
-                if (failed_logins >= MaxWrongPassCount)
-                {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
-
-                    if (WrongPassBanType)
-                    {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        AccountsDatabase.PExecute("INSERT INTO account_punishment VALUES ('%u', '%u', UNIX_TIMESTAMP(), UNIX_TIMESTAMP()+%u, 'Realm', 'Incorrect password for: %u times. Ban for: %u seconds')",
-                                                acc_id, PUNISHMENT_BAN, WrongPassBanTime, failed_logins, WrongPassBanTime);
-                        sLog.outBasic("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                            _login.c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
-                    {
-                        std::string current_ip = get_remote_address();
-                        AccountsDatabase.escape_string(current_ip);
-                        AccountsDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','Realm','Incorrect password for: %u times. Ban for: %u seconds')",
-                            current_ip.c_str(), WrongPassBanTime, failed_logins, WrongPassBanTime);
-                        sLog.outBasic("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                            current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
-                    }
-                }
-            }
+            // executed after the increment, the socket is not needed for the result
+            AccountsDatabase.AsyncPQuery(&AuthSocket::_HandleFailedLoginCallback, _login, get_remote_address(),
+                "SELECT account_id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str());
         }
     }
     return true;
 }
 
+void AuthSocket::_HandleLogonProofCallback(SqlQueryHolder* /*holder*/)
+{
+    if (_FinishQuery())
+    {
+        SendProof(_proof);
+
+        ///- Set _authed to true!
+        _authed = true;
+    }
+
+    _ResumeAfterQuery();
+}
+
+void AuthSocket::_HandleFailedLoginCallback(QueryResultAutoPtr loginfail, std::string login, std::string address)
+{
+    if (!loginfail)
+        return;
+
+    uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
+
+    Field* fields = loginfail->Fetch();
+    uint32 failed_logins = fields[1].GetUInt32();
+
+    if (!MaxWrongPassCount || failed_logins < MaxWrongPassCount)
+        return;
+
+    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+
+    if (WrongPassBanType)
+    {
+        uint32 acc_id = fields[0].GetUInt32();
+        AccountsDatabase.PExecute("INSERT INTO account_punishment VALUES ('%u', '%u', UNIX_TIMESTAMP(), UNIX_TIMESTAMP()+%u, 'Realm', 'Incorrect password for: %u times. Ban for: %u seconds')",
+                                acc_id, PUNISHMENT_BAN, WrongPassBanTime, failed_logins, WrongPassBanTime);
+        sLog.outBasic("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+            login.c_str(), WrongPassBanTime, failed_logins);
+    }
+    else
+    {
+        std::string current_ip = address;
+        AccountsDatabase.escape_string(current_ip);
+        AccountsDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','Realm','Incorrect password for: %u times. Ban for: %u seconds')",
+            current_ip.c_str(), WrongPassBanTime, failed_logins, WrongPassBanTime);
+        sBanList.AddIpBan(address, WrongPassBanTime ? time(NULL) + WrongPassBanTime : 0);
+        sLog.outBasic("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+            current_ip.c_str(), WrongPassBanTime, login.c_str(), failed_logins);
+    }
+}
+
 /// Reconnect Challenge command handler
 bool AuthSocket::_HandleReconnectChallenge()
 {
@@ -886,30 +916,51 @@ bool AuthSocket::_HandleReconnectChallenge()
     EndianConvert(ch->build);
     _build = ch->build;
 
-    QueryResultAutoPtr  result = AccountsDatabase.PQuery("SELECT session_key FROM account JOIN account_session ON account.account_id = account_session.account_id WHERE username = '%s'", _safelogin.c_str());
+    SqlQueryHolder* holder = new SqlQueryHolder;
+    holder->SetSize(1);
+    holder->SetPQuery(0, "SELECT session_key, account.account_id FROM account JOIN account_session ON account.account_id = account_session.account_id WHERE username = '%s'", _safelogin.c_str());
 
-    // Stop if the account is not found
-    if (!result)
+    if (!_DelayQuery(holder, &AuthSocket::_HandleReconnectChallengeCallback))
     {
-        sLog.outLog(LOG_DEFAULT, "ERROR: [ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
         close_connection();
         return false;
     }
 
-    Field* fields = result->Fetch ();
-    K.SetHexStr (fields[0].GetString ());
-
-    ///- Sending response
-    ByteBuffer pkt;
-    pkt << uint8(CMD_AUTH_RECONNECT_CHALLENGE);
-    pkt << uint8(0x00);
-    _reconnectProof.SetRand(16 * 8);
-    pkt.append(_reconnectProof.AsByteArray(16),16);         // 16 bytes random
-    pkt << uint64(0x00) << uint64(0x00);                    // 16 bytes zeros
-    send((char const*)pkt.contents(), pkt.size());
     return true;
 }
 
+void AuthSocket::_HandleReconnectChallengeCallback(SqlQueryHolder* holder)
+{
+    if (_FinishQuery())
+    {
+        QueryResultAutoPtr result = holder->GetResult(0);
+
+        // Stop if the account is not found
+        if (!result)
+        {
+            sLog.outLog(LOG_DEFAULT, "ERROR: [ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
+            close_connection();
+        }
+        else
+        {
+            Field* fields = result->Fetch ();
+            K.SetHexStr (fields[0].GetString ());
+            _accountId = fields[1].GetUInt32();
+
+            ///- Sending response
+            ByteBuffer pkt;
+            pkt << uint8(CMD_AUTH_RECONNECT_CHALLENGE);
+            pkt << uint8(0x00);
+            _reconnectProof.SetRand(16 * 8);
+            pkt.append(_reconnectProof.AsByteArray(16),16);         // 16 bytes random
+            pkt << uint64(0x00) << uint64(0x00);                    // 16 bytes zeros
+            send((char const*)pkt.contents(), pkt.size());
+        }
+    }
+
+    _ResumeAfterQuery();
+}
+
 /// Reconnect Proof command handler
 bool AuthSocket::_HandleReconnectProof()
 {
@@ -962,26 +1013,52 @@ bool AuthSocket::_HandleRealmList()
 
     recv_skip(5);
 
-    ///- Get the user id (else close the connection)
-    // No SQL injection (escaped user name)
+    if (_realmCharactersLoaded)
+    {
+        _SendRealmList();
+        return true;
+    }
+
+    ///- Get the characters count of the account on every realm (else close the connection)
+    SqlQueryHolder* holder = new SqlQueryHolder;
+    holder->SetSize(1);
+    holder->SetPQuery(0, "SELECT realm_id, characters_count FROM realm_characters WHERE account_id = '%u'", _accountId);
 
-    QueryResultAutoPtr  result = AccountsDatabase.PQuery("SELECT account_id, pass_hash FROM account WHERE username = '%s'", _safelogin.c_str());
-    if (!result)
+    if (!_DelayQuery(holder, &AuthSocket::_HandleRealmListCallback))
     {
-        sLog.outLog(LOG_DEFAULT, "ERROR: [ERROR] user %s tried to login and we cannot find him in the database.",_login.c_str());
         close_connection();
         return false;
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    std::string rI = (*result)[1].GetCppString();
+    return true;
+}
+
+void AuthSocket::_HandleRealmListCallback(SqlQueryHolder* holder)
+{
+    if (_FinishQuery())
+    {
+        if (QueryResultAutoPtr result = holder->GetResult(0))
+        {
+            do
+            {
+                Field *fields = result->Fetch();
+                _realmCharacters[fields[0].GetUInt32()] = fields[1].GetUInt8();
+            }
+            while (result->NextRow());
+        }
+
+        _realmCharactersLoaded = true;
+        _SendRealmList();
+    }
 
-    ///- Update realm list if need
-    sRealmList.UpdateIfNeed();
+    _ResumeAfterQuery();
+}
 
+void AuthSocket::_SendRealmList()
+{
     ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
+    LoadRealmlist(pkt);
 
     ByteBuffer hdr;
     hdr << uint8(CMD_REALM_LIST);
@@ -989,12 +1066,78 @@ bool AuthSocket::_HandleRealmList()
     hdr.append(pkt);
 
     send((char const*)hdr.contents(), hdr.size());
+}
 
+/// Run the queries of holder in the database thread, no further commands are handled until handler was called
+bool AuthSocket::_DelayQuery(SqlQueryHolder* holder, QueryHandler handler)
+{
+    // released by _QueryCallback
+    add_reference();
+
+    if (!AccountsDatabase.DelayQueryHolder(this, &AuthSocket::_QueryCallback, holder, handler))
+    {
+        remove_reference();
+        delete holder;
+        return false;
+    }
+
+    _queryPending = true;
     return true;
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer &pkt, uint32 acctid)
+void AuthSocket::_QueryCallback(QueryResultAutoPtr /*dummy*/, SqlQueryHolder* holder, QueryHandler handler)
+{
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, _queryResultLock);
+        _queryResult = holder;
+        _queryHandler = handler;
+    }
+
+    // the notification keeps its own reference until handle_exception was called
+    if (reactor()->notify(this, ACE_Event_Handler::EXCEPT_MASK) == -1)
+        sLog.outLog(LOG_DEFAULT, "ERROR: AuthSocket::_QueryCallback: can not notify the network thread of '%s'", get_remote_address().c_str());
+
+    // may delete the socket
+    remove_reference();
+}
+
+/*virtual*/ int AuthSocket::handle_exception(ACE_HANDLE)
+{
+    SqlQueryHolder* holder;
+    QueryHandler handler;
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, _queryResultLock, 0);
+        holder = _queryResult;
+        handler = _queryHandler;
+        _queryResult = NULL;
+        _queryHandler = NULL;
+    }
+
+    if (handler)
+        (this->*handler)(holder);
+
+    delete holder;
+    return 0;
+}
+
+/// Clear the pending state of a database callback, false if the client disconnected meanwhile
+bool AuthSocket::_FinishQuery()
+{
+    _queryPending = false;
+    return !is_closed();
+}
+
+/// Handle the commands received while the request was pending
+void AuthSocket::_ResumeAfterQuery()
 {
+    if (!is_closed())
+        OnRead();
+}
+
+void AuthSocket::LoadRealmlist(ByteBuffer &pkt)
+{
+    RealmList::ReadGuard guard(sRealmList.GetLock());
+
     switch (_build)
     {
         case 5875:                                          // 1.12.1
@@ -1005,17 +1148,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer &pkt, uint32 acctid)
 
             for (RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResultAutoPtr result = AccountsDatabase.PQuery( "SELECT characters_count FROM realm_characters WHERE realm_id = '%u' AND account_id = '%u'", i->second.m_ID, acctid);
-                if (result)
-                {
-                    Field *fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                }
-                else
-                    AmountOfCharacters = 0;
+                RealmCharacters::const_iterator chars = _realmCharacters.find(i->second.m_ID);
+                uint8 AmountOfCharacters = chars != _realmCharacters.end() ? chars->second : 0;
 
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
@@ -1065,17 +1199,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer &pkt, uint32 acctid)
 
             for (RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResultAutoPtr result = AccountsDatabase.PQuery("SELECT characters_count FROM realm_characters WHERE realm_id = '%u' AND account_id = '%u'", i->second.m_ID, acctid);
-                if (result)
-                {
-                    Field *fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                }
-                else
-                    AmountOfCharacters = 0;
+                RealmCharacters::const_iterator chars = _realmCharacters.find(i->second.m_ID);
+                uint8 AmountOfCharacters = chars != _realmCharacters.end() ? chars->second : 0;
 
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
@@ -27,12 +27,15 @@
 #include "Auth/BigNumber.h"
 #include "Auth/Sha1.h"
 #include "ByteBuffer.h"
+#include "Database/QueryResult.h"
 
 #include <regex>
 #define REGEX_NAMESPACE std
 
 #include "BufferedSocket.h"
 
+class SqlQueryHolder;
+
 #ifdef REGEX_NAMESPACE
 typedef std::list<std::pair<REGEX_NAMESPACE::regex, REGEX_NAMESPACE::regex > > PatternList; // <IP pattern, LocalIP pattern>
 #endif
@@ -49,13 +52,20 @@ class AuthSocket: public BufferedSocket
         void OnAccept();
         void OnRead();
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer &pkt, uint32 acctid);
+        void LoadRealmlist(ByteBuffer &pkt);
 
         bool _HandleLogonChallenge();
         bool _HandleLogonProof();
         bool _HandleReconnectChallenge();
         bool _HandleReconnectProof();
         bool _HandleRealmList();
+
+        // continue the handlers above once their database requests are done, called from the network thread of the socket
+        void _HandleLogonChallengeCallback(SqlQueryHolder* holder);
+        void _HandleLogonProofCallback(SqlQueryHolder* holder);
+        void _HandleReconnectChallengeCallback(SqlQueryHolder* holder);
+        void _HandleRealmListCallback(SqlQueryHolder* holder);
+        static void _HandleFailedLoginCallback(QueryResultAutoPtr result, std::string login, std::string address);
         //data transfer handle for patch
 
         bool _HandleXferResume();
@@ -64,18 +74,37 @@ class AuthSocket: public BufferedSocket
 
         void _SetVSFields(const std::string& rI);
 
+        typedef void (AuthSocket::*QueryHandler)(SqlQueryHolder*);
+
+        // called from the AccountsDatabase result queue, hands the results to the network thread of the socket
+        void _QueryCallback(QueryResultAutoPtr dummy, SqlQueryHolder* holder, QueryHandler handler);
+
+        // runs the handler of a finished database request
+        virtual int handle_exception(ACE_HANDLE = ACE_INVALID_HANDLE);
+
 #ifdef REGEX_NAMESPACE
         static PatternList pattern_banned;
 #endif
 
     private:
+        bool _DelayQuery(SqlQueryHolder* holder, QueryHandler handler);
+        bool _FinishQuery();
+        void _ResumeAfterQuery();
+        void _SendRealmList();
 
         BigNumber N, s, g, v;
         BigNumber b, B;
         BigNumber K;
         BigNumber _reconnectProof;
 
+        Sha1Hash _proof;                                    // sent once the session key is stored
+
         bool _authed;
+        bool _queryPending;                                 // no further commands are handled until the database answered
+        SqlQueryHolder* _queryResult;                       // finished request waiting for handle_exception
+        QueryHandler _queryHandler;
+        ACE_Thread_Mutex _queryResultLock;
+        uint32 _accountId;
 
         std::string _login;
         std::string _safelogin;
@@ -88,6 +117,11 @@ class AuthSocket: public BufferedSocket
         uint16 _build;
         uint64 accountPermissionMask_;
 
+        // characters per realm id, loaded once per connection since the client repeats realm list requests while it is shown
+        typedef std::map<uint32, uint8> RealmCharacters;
+        RealmCharacters _realmCharacters;
+        bool _realmCharactersLoaded;
+
         ACE_HANDLE patch_;
 
         void InitPatch();
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "AuthSocketMgr.h"
+#include "AuthSocket.h"
+#include "Config/Config.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+
+#include <ace/Reactor.h>
+#include <ace/Reactor_Impl.h>
+#include <ace/TP_Reactor.h>
+#include <ace/Dev_Poll_Reactor.h>
+#include <ace/Task.h>
+#include <ace/Acceptor.h>
+#include <ace/SOCK_Acceptor.h>
+
+extern DatabaseType AccountsDatabase;
+
+/// Network thread running the reactor of its share of the auth connections
+class AuthReactorRunnable : protected ACE_Task_Base
+{
+    public:
+        AuthReactorRunnable() : m_Reactor(0), m_ThreadId(-1)
+        {
+            ACE_Reactor_Impl* imp = 0;
+
+            #if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+
+            imp = new ACE_Dev_Poll_Reactor();
+
+            imp->max_notify_iterations(128);
+            imp->restart(1);
+
+            #else
+
+            imp = new ACE_TP_Reactor();
+            imp->max_notify_iterations(128);
+
+            #endif
+
+            m_Reactor = new ACE_Reactor(imp, 1);
+        }
+
+        virtual ~AuthReactorRunnable()
+        {
+            Stop();
+            Wait();
+
+            delete m_Reactor;
+        }
+
+        void Stop() { m_Reactor->end_reactor_event_loop(); }
+
+        int Start()
+        {
+            if (m_ThreadId != -1)
+                return -1;
+
+            return (m_ThreadId = activate());
+        }
+
+        void Wait() { ACE_Task_Base::wait(); }
+
+        ACE_Reactor* GetReactor() { return m_Reactor; }
+
+    protected:
+        virtual int svc()
+        {
+            DEBUG_LOG("Realm Network Thread Starting");
+
+            AccountsDatabase.ThreadStart();
+
+            m_Reactor->run_reactor_event_loop();
+
+            AccountsDatabase.ThreadEnd();
+
+            DEBUG_LOG("Realm Network Thread Exiting");
+
+            return 0;
+        }
+
+    private:
+        ACE_Reactor* m_Reactor;
+        int m_ThreadId;
+};
+
+/// Accepts in the main thread and hands each connection to a network thread before it is opened
+class AuthSocketAcceptor : public ACE_Acceptor<AuthSocket, ACE_SOCK_Acceptor>
+{
+    protected:
+        virtual int make_svc_handler(AuthSocket*& sh)
+        {
+            if (!sh)
+                ACE_NEW_RETURN(sh, AuthSocket, -1);
+
+            sh->reactor(sAuthSocketMgr.SelectReactor());
+            return 0;
+        }
+};
+
+AuthSocketMgr::AuthSocketMgr() : m_NetThreads(NULL), m_NetThreadsCount(0), m_NextThread(0), m_AcceptReactor(NULL), m_Acceptor(NULL)
+{
+}
+
+AuthSocketMgr::~AuthSocketMgr()
+{
+    delete [] m_NetThreads;
+    delete m_Acceptor;
+}
+
+AuthSocketMgr& AuthSocketMgr::Instance()
+{
+    static AuthSocketMgr mgr;
+    return mgr;
+}
+
+int AuthSocketMgr::StartNetwork(ACE_Reactor* acceptReactor, uint16 port, std::string const& address)
+{
+    int num_threads = sConfig.GetIntDefault("Network.Threads", 0);
+    if (num_threads < 0)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: Network.Threads is wrong in your config file");
+        return -1;
+    }
+
+    m_AcceptReactor = acceptReactor;
+
+    // 0 keeps all connections in the accepting thread
+    m_NetThreadsCount = size_t(num_threads);
+    if (m_NetThreadsCount)
+        m_NetThreads = new AuthReactorRunnable[m_NetThreadsCount];
+
+    m_Acceptor = new AuthSocketAcceptor;
+
+    ACE_INET_Addr bind_addr(port, address.c_str());
+
+    if (m_Acceptor->open(bind_addr, m_AcceptReactor, ACE_NONBLOCK) == -1)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: TrinityRealm can not bind to %s:%d", address.c_str(), port);
+        return -1;
+    }
+
+    for (size_t i = 0; i < m_NetThreadsCount; ++i)
+        m_NetThreads[i].Start();
+
+    sLog.outString("Handling connections with %u network threads", uint32(m_NetThreadsCount));
+    return 0;
+}
+
+void AuthSocketMgr::StopNetwork()
+{
+    if (m_Acceptor)
+        m_Acceptor->close();
+
+    for (size_t i = 0; i < m_NetThreadsCount; ++i)
+        m_NetThreads[i].Stop();
+
+    for (size_t i = 0; i < m_NetThreadsCount; ++i)
+        m_NetThreads[i].Wait();
+}
+
+ACE_Reactor* AuthSocketMgr::SelectReactor()
+{
+    if (!m_NetThreadsCount)
+        return m_AcceptReactor;
+
+    // connections are short lived, no need to balance by load
+    return m_NetThreads[m_NextThread++ % m_NetThreadsCount].GetReactor();
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _AUTHSOCKETMGR_H
+#define _AUTHSOCKETMGR_H
+
+#include "Common.h"
+
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+class ACE_Reactor;
+class AuthReactorRunnable;
+class AuthSocketAcceptor;
+
+/// Owns the listening socket and the network threads the accepted auth connections are spread over
+class AuthSocketMgr
+{
+    public:
+        static AuthSocketMgr& Instance();
+
+        AuthSocketMgr();
+        ~AuthSocketMgr();
+
+        /// Listen at address:port from acceptReactor and start the network threads
+        int StartNetwork(ACE_Reactor* acceptReactor, uint16 port, std::string const& address);
+
+        /// Close the listening socket and wait for the network threads
+        void StopNetwork();
+
+        /// Reactor of the network thread a new connection is handled by, round robin
+        ACE_Reactor* SelectReactor();
+
+    private:
+        AuthReactorRunnable* m_NetThreads;
+        size_t m_NetThreadsCount;
+        ACE_Atomic_Op<ACE_Thread_Mutex, size_t> m_NextThread;
+
+        ACE_Reactor* m_AcceptReactor;
+        AuthSocketAcceptor* m_Acceptor;
+};
+
+#define sAuthSocketMgr AuthSocketMgr::Instance()
+
+#endif
+/// @}
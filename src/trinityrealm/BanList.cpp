@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "Common.h"
+#include "BanList.h"
+#include "Database/DatabaseEnv.h"
+#include "Database/SqlOperations.h"
+#include "Log.h"
+#include "Util.h"
+
+extern DatabaseType AccountsDatabase;
+
+void IpBanTrie::Clear()
+{
+    m_nodes.clear();
+    m_nodes.push_back(Node());
+}
+
+void IpBanTrie::Insert(uint32 net, uint8 prefixLen, time_t unbanDate)
+{
+    uint32 node = 0;
+    for (uint8 bit = 0; bit < prefixLen; ++bit)
+    {
+        uint32 side = (net >> (31 - bit)) & 1;
+        if (!m_nodes[node].child[side])
+        {
+            m_nodes[node].child[side] = m_nodes.size();
+            m_nodes.push_back(Node());
+        }
+
+        node = m_nodes[node].child[side];
+    }
+
+    // keep the longest of overlapping bans
+    Node& entry = m_nodes[node];
+    if (!entry.banned || (entry.unbanDate && (!unbanDate || unbanDate > entry.unbanDate)))
+    {
+        entry.banned = true;
+        entry.unbanDate = unbanDate;
+    }
+}
+
+bool IpBanTrie::IsBanned(uint32 ip, time_t now) const
+{
+    uint32 node = 0;
+    for (uint8 bit = 0; ; ++bit)
+    {
+        Node const& entry = m_nodes[node];
+        if (entry.banned && (!entry.unbanDate || entry.unbanDate > now))
+            return true;
+
+        if (bit == 32)
+            return false;
+
+        node = entry.child[(ip >> (31 - bit)) & 1];
+        if (!node)
+            return false;
+    }
+}
+
+BanList::BanList() : m_UpdateInterval(0), m_NextUpdateTime(time(NULL)), m_updatePending(false)
+{
+}
+
+BanList& BanList::Instance()
+{
+    static BanList banlist;
+    return banlist;
+}
+
+void BanList::InsertIpBan(std::string const& ip, time_t unbanDate)
+{
+    uint32 net;
+    uint8 prefixLen;
+    if (ParseIPNetwork(ip, net, prefixLen))
+        m_ipBans.Insert(net, prefixLen, unbanDate);
+    else
+    {
+        std::map<std::string, time_t>::iterator itr = m_otherIpBans.find(ip);
+        if (itr == m_otherIpBans.end())
+            m_otherIpBans[ip] = unbanDate;
+        else if (itr->second && (!unbanDate || unbanDate > itr->second))
+            itr->second = unbanDate;
+    }
+}
+
+void BanList::AddIpBan(std::string const& ip, time_t unbanDate)
+{
+    WriteGuard guard(m_lock);
+
+    InsertIpBan(ip, unbanDate);
+
+    if (m_updatePending)
+        m_addedWhileLoading.push_back(std::make_pair(ip, unbanDate));
+}
+
+bool BanList::IsIpBanned(std::string const& ip) const
+{
+    time_t now = time(NULL);
+
+    ReadGuard guard(m_lock);
+
+    uint32 addr;
+    uint8 prefixLen;
+    if (ParseIPNetwork(ip, addr, prefixLen))
+        return m_ipBans.IsBanned(addr, now);
+
+    std::map<std::string, time_t>::const_iterator itr = m_otherIpBans.find(ip);
+    return itr != m_otherIpBans.end() && (!itr->second || itr->second > now);
+}
+
+bool BanList::IsEmailBanned(std::string const& email) const
+{
+    if (email.empty())
+        return false;
+
+    std::string lower = email;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+
+    ReadGuard guard(m_lock);
+    return m_emailBans.find(lower) != m_emailBans.end();
+}
+
+uint32 BanList::LoadIpBans(QueryResultAutoPtr result)
+{
+    m_ipBans.Clear();
+    m_otherIpBans.clear();
+
+    if (!result)
+        return 0;
+
+    uint32 count = 0;
+    time_t now = time(NULL);
+    do
+    {
+        Field* fields = result->Fetch();
+
+        uint64 banDate = fields[1].GetUInt64();
+        uint64 unbanDate = fields[2].GetUInt64();
+
+        // same dates mean permanent ban
+        if (unbanDate != banDate && time_t(unbanDate) <= now)
+            continue;
+
+        InsertIpBan(fields[0].GetCppString(), unbanDate == banDate ? 0 : time_t(unbanDate));
+        ++count;
+    }
+    while (result->NextRow());
+
+    return count;
+}
+
+uint32 BanList::LoadEmailBans(QueryResultAutoPtr result)
+{
+    m_emailBans.clear();
+
+    if (!result)
+        return 0;
+
+    do
+    {
+        std::string email = result->Fetch()[0].GetCppString();
+        std::transform(email.begin(), email.end(), email.begin(), ::tolower);
+        m_emailBans.insert(email);
+    }
+    while (result->NextRow());
+
+    return m_emailBans.size();
+}
+
+/// Load the bans from the database
+void BanList::Initialize(uint32 updateInterval)
+{
+    m_UpdateInterval = updateInterval;
+    m_NextUpdateTime = time(NULL) + updateInterval;
+
+    uint32 ipCount = LoadIpBans(AccountsDatabase.Query("SELECT ip, ban_date, unban_date FROM ip_banned"));
+    uint32 emailCount = LoadEmailBans(AccountsDatabase.Query("SELECT email FROM email_banned"));
+
+    sLog.outString("Loaded %u active ip bans and %u email bans", ipCount, emailCount);
+}
+
+void BanList::UpdateIfNeed()
+{
+    // maybe disabled, updated recently or still loading
+    if (!m_UpdateInterval || m_updatePending || m_NextUpdateTime > time(NULL))
+        return;
+
+    m_NextUpdateTime = time(NULL) + m_UpdateInterval;
+
+    // expired rows are ignored by the lookup, only clean them up here
+    AccountsDatabase.Execute("DELETE FROM ip_banned WHERE unban_date <= UNIX_TIMESTAMP() AND unban_date <> ban_date");
+
+    SqlQueryHolder* holder = new SqlQueryHolder;
+    holder->SetSize(2);
+    holder->SetQuery(0, "SELECT ip, ban_date, unban_date FROM ip_banned");
+    holder->SetQuery(1, "SELECT email FROM email_banned");
+
+    if (!AccountsDatabase.DelayQueryHolder(this, &BanList::LoadCallback, holder))
+    {
+        delete holder;
+        return;
+    }
+
+    m_updatePending = true;
+}
+
+void BanList::LoadCallback(QueryResultAutoPtr /*dummy*/, SqlQueryHolder* holder)
+{
+    sLog.outDetail("Updating Ban List...");
+
+    WriteGuard guard(m_lock);
+
+    LoadIpBans(holder->GetResult(0));
+    LoadEmailBans(holder->GetResult(1));
+
+    delete holder;
+
+    for (IpBanVector::const_iterator itr = m_addedWhileLoading.begin(); itr != m_addedWhileLoading.end(); ++itr)
+        InsertIpBan(itr->first, itr->second);
+
+    m_addedWhileLoading.clear();
+    m_updatePending = false;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2005-2011 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _BANLIST_H
+#define _BANLIST_H
+
+#include "Common.h"
+#include "Database/QueryResult.h"
+
+class SqlQueryHolder;
+
+/// Binary trie of banned IPv4 networks, one level per address bit
+class IpBanTrie
+{
+    public:
+        IpBanTrie() { Clear(); }
+
+        void Clear();
+
+        // unbanDate 0 means permanent
+        void Insert(uint32 net, uint8 prefixLen, time_t unbanDate);
+        bool IsBanned(uint32 ip, time_t now) const;
+
+    private:
+        struct Node
+        {
+            Node() : unbanDate(0), banned(false) { child[0] = child[1] = 0; }
+
+            uint32 child[2];                                // index in m_nodes, 0 = none (root is never a child)
+            time_t unbanDate;
+            bool banned;
+        };
+
+        std::vector<Node> m_nodes;
+};
+
+/// In-memory copy of ip_banned and email_banned, refreshed from the database in background
+class BanList
+{
+    public:
+        static BanList& Instance();
+
+        BanList();
+
+        // synchronous load at startup
+        void Initialize(uint32 updateInterval);
+        // starts an asynchronous refresh when the update interval expired
+        void UpdateIfNeed();
+
+        bool IsIpBanned(std::string const& ip) const;
+        bool IsEmailBanned(std::string const& email) const;
+
+        // bans issued by realmd itself are visible before the next refresh
+        void AddIpBan(std::string const& ip, time_t unbanDate);
+
+        void LoadCallback(QueryResultAutoPtr dummy, SqlQueryHolder* holder);
+
+    private:
+        void InsertIpBan(std::string const& ip, time_t unbanDate);
+        uint32 LoadIpBans(QueryResultAutoPtr result);
+        uint32 LoadEmailBans(QueryResultAutoPtr result);
+
+        typedef ACE_RW_Thread_Mutex LockType;
+        typedef ACE_Read_Guard<LockType> ReadGuard;
+        typedef ACE_Write_Guard<LockType> WriteGuard;
+
+        // lookups come from the network threads, loads and added bans from the main thread
+        mutable LockType m_lock;
+
+        IpBanTrie m_ipBans;
+        std::map<std::string, time_t> m_otherIpBans;        // entries which are no IPv4 address or network
+        std::set<std::string> m_emailBans;                  // lower case
+
+        typedef std::vector<std::pair<std::string, time_t> > IpBanVector;
+        IpBanVector m_addedWhileLoading;                    // may be missing in the pending refresh result
+
+        uint32 m_UpdateInterval;
+        time_t m_NextUpdateTime;
+        bool m_updatePending;
+};
+
+#define sBanList BanList::Instance()
+
+#endif
+/// @}
@@ -32,8 +32,11 @@
 
 BufferedSocket::BufferedSocket(void):
     input_buffer_(4096),
+    closed_(false),
     remote_address_("<unknown>")
 {
+    // the socket may be kept alive by pending database callbacks after the reactor released it
+    reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
 }
 
 /*virtual*/ BufferedSocket::~BufferedSocket(void)
@@ -42,9 +45,6 @@ BufferedSocket::BufferedSocket(void):
 
 /*virtual*/ int BufferedSocket::open(void * arg)
 {
-    if(Base::open(arg) == -1)
-        return -1;
-
     ACE_INET_Addr addr;
 
     if(peer().get_remote_addr(addr) == -1)
@@ -58,6 +58,13 @@ BufferedSocket::BufferedSocket(void):
 
     this->OnAccept();
 
+    // registers with the reactor of a network thread, which may handle input from now on
+    if(Base::open(arg) == -1)
+        return -1;
+
+    // reactor takes care of the socket from now on
+    remove_reference();
+
     return 0;
 }
 
@@ -250,6 +257,8 @@ bool BufferedSocket::send(const char *buf, size_t len)
 
 /*virtual*/ int BufferedSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask m)
 {
+    closed_ = true;
+
     this->OnClose();
 
     Base::handle_close();
@@ -257,8 +266,21 @@ bool BufferedSocket::send(const char *buf, size_t len)
     return 0;
 }
 
+/*virtual*/ int BufferedSocket::close(u_long)
+{
+    closed_ = true;
+
+    shutdown();
+
+    remove_reference();
+
+    return 0;
+}
+
 void BufferedSocket::close_connection(void)
 {
+    closed_ = true;
+
     this->peer().close_reader();
     this->peer().close_writer();
 
@@ -57,6 +57,7 @@ class BufferedSocket: public ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH>
         virtual int open(void *);
 
         void close_connection(void);
+        bool is_closed(void) const { return closed_; }
 
         virtual int handle_input(ACE_HANDLE = ACE_INVALID_HANDLE);
         virtual int handle_output(ACE_HANDLE = ACE_INVALID_HANDLE);
@@ -64,11 +65,15 @@ class BufferedSocket: public ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH>
         virtual int handle_close(ACE_HANDLE = ACE_INVALID_HANDLE,
                 ACE_Reactor_Mask = ACE_Event_Handler::ALL_EVENTS_MASK);
 
+        // called by the acceptor when open() failed
+        virtual int close(u_long = 0);
+
     private:
         ssize_t noblk_send(ACE_Message_Block &message_block);
 
     private:
         ACE_Message_Block input_buffer_;
+        bool closed_;
 
     protected:
         std::string remote_address_;
@@ -27,6 +27,8 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "AuthSocket.h"
+#include "AuthSocketMgr.h"
+#include "BanList.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "Util.h"
@@ -37,8 +39,6 @@
 #include <ace/Dev_Poll_Reactor.h>
 #include <ace/TP_Reactor.h>
 #include <ace/ACE.h>
-#include <ace/Acceptor.h>
-#include <ace/SOCK_Acceptor.h>
 
 #include <ace/Get_Opt.h>
 
@@ -263,19 +263,15 @@ extern int main(int argc, char **argv)
     // set expired bans to inactive
     AccountsDatabase.Execute("DELETE FROM ip_banned WHERE unban_date <= UNIX_TIMESTAMP() AND unban_date <> ban_date");
 
-    ///- Launch the listening network socket
-    ACE_Acceptor<AuthSocket, ACE_SOCK_Acceptor> acceptor;
+    ///- Load ip and email bans, logon challenges check them in memory
+    sBanList.Initialize(sConfig.GetIntDefault("BanListUpdateDelay", 60));
 
+    ///- Launch the listening network socket, accepted connections are handled by the network threads
     uint16 rmport = sConfig.GetIntDefault("RealmServerPort", DEFAULT_REALMSERVER_PORT);
     std::string bind_ip = sConfig.GetStringDefault("BindIP", "0.0.0.0");
 
-    ACE_INET_Addr bind_addr(rmport, bind_ip.c_str());
-
-    if (acceptor.open(bind_addr, ACE_Reactor::instance(), ACE_NONBLOCK) == -1)
-    {
-        sLog.outLog(LOG_DEFAULT, "ERROR: TrinityRealm can not bind to %s:%d", bind_ip.c_str(), rmport);
+    if (sAuthSocketMgr.StartNetwork(ACE_Reactor::instance(), rmport, bind_ip) == -1)
         return 1;
-    }
 
     ///- Catch termination signals
     HookSignals();
@@ -326,7 +322,7 @@ extern int main(int argc, char **argv)
     AccountsDatabase.EnableLogging();
 
     // maximum counter for next ping
-    uint32 numLoops = (sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000000 / 100000));
+    uint32 numLoops = (sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000000 / 10000));
     uint32 loopCounter = 0;
 
 #ifndef WIN32
@@ -337,11 +333,17 @@ extern int main(int argc, char **argv)
     while (!stopEvent)
     {
         // dont move this outside the loop, the reactor will modify it
-        ACE_Time_Value interval(0, 100000);
+        // short, database callbacks of the clients are only handled between the reactor runs
+        ACE_Time_Value interval(0, 10000);
 
         if (ACE_Reactor::instance()->run_reactor_event_loop(interval) == -1)
             break;
 
+        AccountsDatabase.ProcessResultQueue();
+
+        sRealmList.UpdateIfNeed();
+        sBanList.UpdateIfNeed();
+
         if( (++loopCounter) == numLoops )
         {
             loopCounter = 0;
@@ -357,6 +359,9 @@ extern int main(int argc, char **argv)
 #endif
     }
 
+    ///- Stop accepting and wait for the network threads to exit
+    sAuthSocketMgr.StopNetwork();
+
     ///- Wait for the delay thread to exit
     AccountsDatabase.HaltDelayThread();
 
@@ -29,6 +29,7 @@
 #include <ace/SOCK_Stream.h>
 #include <ace/Message_Block.h>
 #include <ace/Auto_Ptr.h>
+#include <ace/Thread_Mutex.h>
 #include <map>
 
 #include <openssl/bn.h>
@@ -69,6 +70,9 @@ class PatchCache
         void LoadPatchesInfo();
         Patches patches_;
 
+        // patches found after startup are added from the network threads
+        ACE_Thread_Mutex lock_;
+
 };
 
 class PatchHandler: public ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH>
@@ -59,7 +59,11 @@ RealmBuildInfo const* FindBuildInfo(uint16 _build)
     return NULL;
 }
 
-RealmList::RealmList( ) : m_UpdateInterval(0), m_NextUpdateTime(time(NULL))
+////                                                         0       1         2       3     4      5       6                 7                  8           9
+static char const* RealmListQuery = "SELECT realm_id, name, ip_address, port, icon, flags, timezone, required_permission_mask, population, allowed_builds "
+                                    "FROM realms WHERE (flags & 1) = 0 ORDER BY name";
+
+RealmList::RealmList( ) : m_UpdateInterval(0), m_NextUpdateTime(time(NULL)), m_updatePending(false)
 {
 }
 
@@ -120,26 +124,46 @@ void RealmList::UpdateRealm( uint32 ID, const std::string& name, const std::stri
 
 void RealmList::UpdateIfNeed()
 {
-    // maybe disabled or updated recently
-    if(!m_UpdateInterval || m_NextUpdateTime > time(NULL))
+    // maybe disabled, updated recently or still loading
+    if(!m_UpdateInterval || m_updatePending || m_NextUpdateTime > time(NULL))
         return;
 
     m_NextUpdateTime = time(NULL) + m_UpdateInterval;
 
+    // Get the content of the realmlist table in the database without blocking the clients
+    if (AccountsDatabase.AsyncQuery(this, &RealmList::UpdateRealmsCallback, RealmListQuery))
+        m_updatePending = true;
+}
+
+void RealmList::UpdateRealmsCallback(QueryResultAutoPtr result)
+{
+    m_updatePending = false;
+
+    WriteGuard guard(m_lock);
+
     // Clears Realm list
     m_realms.clear();
 
-    // Get the content of the realmlist table in the database
-    UpdateRealms(false);
+    LoadRealms(result, false);
+}
+
+Realm const* RealmList::FindRealm(uint32 id) const
+{
+    for (RealmMap::const_iterator itr = m_realms.begin(); itr != m_realms.end(); ++itr)
+        if (itr->second.m_ID == id)
+            return &itr->second;
+
+    return NULL;
 }
 
 void RealmList::UpdateRealms(bool init)
 {
-    sLog.outDetail("Updating Realm List...");
+    LoadRealms(AccountsDatabase.Query(RealmListQuery), init);
+}
 
-    ////                                                          0       1         2       3     4      5       6                 7                  8           9
-    QueryResultAutoPtr result = AccountsDatabase.Query("SELECT realm_id, name, ip_address, port, icon, flags, timezone, required_permission_mask, population, allowed_builds "
-                                                       "FROM realms WHERE (flags & 1) = 0 ORDER BY name");
+void RealmList::LoadRealms(QueryResultAutoPtr result, bool init)
+{
+    sLog.outDetail("Updating Realm List...");
 
     ///- Circle through results and add them to the realm map
     if(result)
@@ -24,6 +24,7 @@
 #define _REALMLIST_H
 
 #include "Common.h"
+#include "Database/QueryResult.h"
 
 struct RealmBuildInfo
 {
@@ -58,6 +59,10 @@ class RealmList
     public:
         typedef std::map<std::string, Realm> RealmMap;
 
+        typedef ACE_RW_Thread_Mutex LockType;
+        typedef ACE_Read_Guard<LockType> ReadGuard;
+        typedef ACE_Write_Guard<LockType> WriteGuard;
+
         static RealmList& Instance();
 
         RealmList();
@@ -65,19 +70,29 @@ class RealmList
 
         void Initialize(uint32 updateInterval);
 
+        // starts an asynchronous reload when the update interval expired
         void UpdateIfNeed();
 
+        // the network threads must hold a ReadGuard on GetLock() while using the realms, a reload replaces them
+        LockType& GetLock() const { return m_lock; }
+
+        Realm const* FindRealm(uint32 id) const;
+
         RealmMap::const_iterator begin() const { return m_realms.begin(); }
         RealmMap::const_iterator end() const { return m_realms.end(); }
         uint32 size() const { return m_realms.size(); }
         std::string ChatboxOsName;
     private:
         void UpdateRealms(bool init);
+        void UpdateRealmsCallback(QueryResultAutoPtr result);
+        void LoadRealms(QueryResultAutoPtr result, bool init);
         void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, uint64 requiredPermissionMask, float popu, const std::string& builds);
     private:
         RealmMap m_realms;                                  ///< Internal map of realms
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
+        bool     m_updatePending;
+        mutable LockType m_lock;
 };
 
 #define sRealmList RealmList::Instance()
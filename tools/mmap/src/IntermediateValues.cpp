@@ -17,6 +17,7 @@
  */
 
 #include "IntermediateValues.h"
+#include "MapBuilder.h"
 
 namespace MMAP
 {
@@ -35,7 +36,7 @@ namespace MMAP
         char tileString[25];
         sprintf(tileString, "[%02u,%02u]: ", tileX, tileY);
 
-        printf("%sWriting debug output...                       \r", tileString);
+        printProgress("%sWriting debug output...                       \r", tileString);
 
         string name("meshes/%03u%02i%02i.");
 
@@ -52,7 +53,7 @@ namespace MMAP
             else \
                 debugWrite(file, data); \
             if(file) fclose(file); \
-            printf("%sWriting debug output...                       \r", tileString); \
+            printProgress("%sWriting debug output...                       \r", tileString); \
         } while (false)
 
         if(heightfield)
@@ -237,7 +238,7 @@ namespace MMAP
 
         char tileString[25];
         sprintf(tileString, "[%02u,%02u]: ", tileY, tileX);
-        printf("%sWriting debug output...                       \r", tileString);
+        printProgress("%sWriting debug output...                       \r", tileString);
 
         sprintf(objFileName, "meshes/%03u.map", mapID);
 
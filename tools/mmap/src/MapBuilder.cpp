@@ -25,13 +25,30 @@
 #include "DetourNavMeshBuilder.h"
 #include "DetourCommon.h"
 
+#include "G3D/GThread.h"
+
+#include <cstdarg>
+
 using namespace VMAP;
 
 namespace MMAP
 {
+    static G3D::GMutex progressLock;
+
+    void printProgress(const char* format, ...)
+    {
+        G3D::GMutexLock lock(&progressLock);
+
+        va_list ap;
+        va_start(ap, format);
+        vprintf(format, ap);
+        va_end(ap);
+        fflush(stdout);
+    }
+
     MapBuilder::MapBuilder(float maxWalkableAngle, bool skipLiquid,
                            bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
-                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath) :
+                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath, int threads) :
                            m_terrainBuilder(NULL),
                            m_debugOutput        (debugOutput),
                            m_skipContinents     (skipContinents),
@@ -39,13 +56,15 @@ namespace MMAP
                            m_skipBattlegrounds  (skipBattlegrounds),
                            m_maxWalkableAngle   (maxWalkableAngle),
                            m_bigBaseUnit        (bigBaseUnit),
-                           m_rcContext          (NULL),
-                           m_offMeshFilePath    (offMeshFilePath)
+                           m_offMeshFilePath    (offMeshFilePath),
+                           m_threads            (threads > 0 ? threads : 1),
+                           m_workMapID          (0),
+                           m_workTiles          (NULL),
+                           m_workNextTile       (0),
+                           m_workNavMesh        (NULL)
     {
         m_terrainBuilder = new TerrainBuilder(skipLiquid);
 
-        m_rcContext = new rcContext(false);
-
         discoverTiles();
     }
 
@@ -59,7 +78,6 @@ namespace MMAP
         }
 
         delete m_terrainBuilder;
-        delete m_rcContext;
     }
 
     /**************************************************************************/
@@ -239,6 +257,8 @@ namespace MMAP
 
         // now start building mmtiles for each tile
         printf("We have %u tiles.                          \n", (unsigned int)tiles->size());
+
+        vector<uint32> tileIDs;
         for (set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
         {
             uint32 tileX, tileY;
@@ -249,7 +269,19 @@ namespace MMAP
             if (shouldSkipTile(mapID, tileX, tileY))
                 continue;
 
-            buildTile(mapID, tileX, tileY, navMesh);
+            tileIDs.push_back(*it);
+        }
+
+        if (m_threads > 1 && tileIDs.size() > 1)
+            buildTilesParallel(mapID, tileIDs, navMesh);
+        else
+        {
+            for (vector<uint32>::iterator it = tileIDs.begin(); it != tileIDs.end(); ++it)
+            {
+                uint32 tileX, tileY;
+                StaticMapTree::unpackTileID((*it), tileX, tileY);
+                buildTile(mapID, tileX, tileY, navMesh);
+            }
         }
 
         dtFreeNavMesh(navMesh);
@@ -257,10 +289,73 @@ namespace MMAP
         printf("Complete!                               \n\n");
     }
 
+    /**************************************************************************/
+    void MapBuilder::buildTilesParallel(uint32 mapID, vector<uint32> const& tileIDs, dtNavMesh* navMesh)
+    {
+        m_workMapID = mapID;
+        m_workTiles = &tileIDs;
+        m_workNextTile = 0;
+        m_workNavMesh = navMesh;
+
+        // every tile reads its own terrain and vmap data and is written to its own file,
+        // so output doesn't depend on thread count or on the order tiles are finished in
+        uint32 threadCount = min(uint32(m_threads), uint32(tileIDs.size()));
+        printf("Building tiles in %u threads\n", threadCount);
+
+        vector<G3D::GThreadRef> threads;
+        for (uint32 i = 0; i < threadCount; ++i)
+        {
+            G3D::GThreadRef thread = G3D::GThread::create("MoveMapGen tile builder", &MapBuilder::buildTilesThread, this);
+            if (!thread->start())
+            {
+                printf("Failed starting tile builder thread, continuing with %u threads\n", i);
+                break;
+            }
+
+            threads.push_back(thread);
+        }
+
+        // no worker started, build tiles here
+        if (threads.empty())
+            buildTilesWorker();
+
+        for (vector<G3D::GThreadRef>::iterator it = threads.begin(); it != threads.end(); ++it)
+            (*it)->waitForCompletion();
+
+        m_workTiles = NULL;
+        m_workNavMesh = NULL;
+    }
+
+    /**************************************************************************/
+    void MapBuilder::buildTilesThread(void* builder)
+    {
+        ((MapBuilder*)builder)->buildTilesWorker();
+    }
+
+    /**************************************************************************/
+    void MapBuilder::buildTilesWorker()
+    {
+        while (true)
+        {
+            uint32 tileID;
+            {
+                G3D::GMutexLock lock(&m_workLock);
+                if (m_workNextTile >= m_workTiles->size())
+                    return;
+
+                tileID = (*m_workTiles)[m_workNextTile++];
+            }
+
+            uint32 tileX, tileY;
+            StaticMapTree::unpackTileID(tileID, tileX, tileY);
+            buildTile(m_workMapID, tileX, tileY, m_workNavMesh);
+        }
+    }
+
     /**************************************************************************/
     void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
     {
-        printf("Building map %03u, tile [%02u,%02u]\n", mapID, tileX, tileY);
+        printProgress("Building map %03u, tile [%02u,%02u]\n", mapID, tileX, tileY);
 
         MeshData meshData;
 
@@ -380,10 +475,13 @@ namespace MMAP
         // console output
         char tileString[10];
         sprintf(tileString, "[%02i,%02i]: ", tileX, tileY);
-        printf("%s Building movemap tiles...                        \r", tileString);
+        printProgress("%s Building movemap tiles...                        \r", tileString);
 
         IntermediateValues iv;
 
+        // rcContext is per tile, tiles may be built by several threads
+        rcContext rcCtx(false);
+
         float* tVerts = meshData.solidVerts.getCArray();
         int tVertCount = meshData.solidVerts.size() / 3;
         int* tTris = meshData.solidTris.getCArray();
@@ -460,71 +558,71 @@ namespace MMAP
 
                 // build heightfield
                 tile.solid = rcAllocHeightfield();
-                if (!tile.solid || !rcCreateHeightfield(m_rcContext, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
+                if (!tile.solid || !rcCreateHeightfield(&rcCtx, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
                 {
-                    printf("%sFailed building heightfield!            \n", tileString);
+                    printProgress("%sFailed building heightfield!            \n", tileString);
                     continue;
                 }
 
                 // mark all walkable tiles, both liquids and solids
                 unsigned char* triFlags = new unsigned char[tTriCount];
                 memset(triFlags, NAV_GROUND, tTriCount*sizeof(unsigned char));
-                rcClearUnwalkableTriangles(m_rcContext, tileCfg.walkableSlopeAngle, tVerts, tVertCount, tTris, tTriCount, triFlags);
-                rcRasterizeTriangles(m_rcContext, tVerts, tVertCount, tTris, triFlags, tTriCount, *tile.solid, config.walkableClimb);
+                rcClearUnwalkableTriangles(&rcCtx, tileCfg.walkableSlopeAngle, tVerts, tVertCount, tTris, tTriCount, triFlags);
+                rcRasterizeTriangles(&rcCtx, tVerts, tVertCount, tTris, triFlags, tTriCount, *tile.solid, config.walkableClimb);
                 delete [] triFlags;
 
-                rcFilterLowHangingWalkableObstacles(m_rcContext, config.walkableClimb, *tile.solid);
-                rcFilterLedgeSpans(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid);
-                rcFilterWalkableLowHeightSpans(m_rcContext, tileCfg.walkableHeight, *tile.solid);
+                rcFilterLowHangingWalkableObstacles(&rcCtx, config.walkableClimb, *tile.solid);
+                rcFilterLedgeSpans(&rcCtx, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid);
+                rcFilterWalkableLowHeightSpans(&rcCtx, tileCfg.walkableHeight, *tile.solid);
 
-                rcRasterizeTriangles(m_rcContext, lVerts, lVertCount, lTris, lTriFlags, lTriCount, *tile.solid, config.walkableClimb);
+                rcRasterizeTriangles(&rcCtx, lVerts, lVertCount, lTris, lTriFlags, lTriCount, *tile.solid, config.walkableClimb);
 
                 // compact heightfield spans
                 tile.chf = rcAllocCompactHeightfield();
-                if (!tile.chf || !rcBuildCompactHeightfield(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
+                if (!tile.chf || !rcBuildCompactHeightfield(&rcCtx, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
                 {
-                    printf("%sFailed compacting heightfield!            \n", tileString);
+                    printProgress("%sFailed compacting heightfield!            \n", tileString);
                     continue;
                 }
 
                 // build polymesh intermediates
-                if (!rcErodeWalkableArea(m_rcContext, config.walkableRadius, *tile.chf))
+                if (!rcErodeWalkableArea(&rcCtx, config.walkableRadius, *tile.chf))
                 {
-                    printf("%sFailed eroding area!                    \n", tileString);
+                    printProgress("%sFailed eroding area!                    \n", tileString);
                     continue;
                 }
 
-                if (!rcBuildDistanceField(m_rcContext, *tile.chf))
+                if (!rcBuildDistanceField(&rcCtx, *tile.chf))
                 {
-                    printf("%sFailed building distance field!         \n", tileString);
+                    printProgress("%sFailed building distance field!         \n", tileString);
                     continue;
                 }
 
-                if (!rcBuildRegions(m_rcContext, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
+                if (!rcBuildRegions(&rcCtx, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
                 {
-                    printf("%sFailed building regions!                \n", tileString);
+                    printProgress("%sFailed building regions!                \n", tileString);
                     continue;
                 }
 
                 tile.cset = rcAllocContourSet();
-                if (!tile.cset || !rcBuildContours(m_rcContext, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
+                if (!tile.cset || !rcBuildContours(&rcCtx, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
                 {
-                    printf("%sFailed building contours!               \n", tileString);
+                    printProgress("%sFailed building contours!               \n", tileString);
                     continue;
                 }
 
                 // build polymesh
                 tile.pmesh = rcAllocPolyMesh();
-                if (!tile.pmesh || !rcBuildPolyMesh(m_rcContext, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
+                if (!tile.pmesh || !rcBuildPolyMesh(&rcCtx, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
                 {
-                    printf("%sFailed building polymesh!               \n", tileString);
+                    printProgress("%sFailed building polymesh!               \n", tileString);
                     continue;
                 }
 
                 tile.dmesh = rcAllocPolyMeshDetail();
-                if (!tile.dmesh || !rcBuildPolyMeshDetail(m_rcContext, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg    .detailSampleMaxError, *tile.dmesh))
+                if (!tile.dmesh || !rcBuildPolyMeshDetail(&rcCtx, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg    .detailSampleMaxError, *tile.dmesh))
                 {
-                    printf("%sFailed building polymesh detail!        \n", tileString);
+                    printProgress("%sFailed building polymesh detail!        \n", tileString);
                     continue;
                 }
 
@@ -544,14 +642,14 @@ namespace MMAP
         rcPolyMesh** pmmerge = new rcPolyMesh*[TILES_PER_MAP * TILES_PER_MAP];
         if (!pmmerge)
         {
-            printf("%s alloc pmmerge FIALED!          \r", tileString);
+            printProgress("%s alloc pmmerge FIALED!          \r", tileString);
             return;
         }
 
         rcPolyMeshDetail** dmmerge = new rcPolyMeshDetail*[TILES_PER_MAP * TILES_PER_MAP];
         if (!dmmerge)
         {
-            printf("%s alloc dmmerge FIALED!          \r", tileString);
+            printProgress("%s alloc dmmerge FIALED!          \r", tileString);
             return;
         }
 
@@ -573,18 +671,18 @@ namespace MMAP
         iv.polyMesh = rcAllocPolyMesh();
         if (!iv.polyMesh)
         {
-            printf("%s alloc iv.polyMesh FIALED!          \r", tileString);
+            printProgress("%s alloc iv.polyMesh FIALED!          \r", tileString);
             return;
         }
-        rcMergePolyMeshes(m_rcContext, pmmerge, nmerge, *iv.polyMesh);
+        rcMergePolyMeshes(&rcCtx, pmmerge, nmerge, *iv.polyMesh);
 
         iv.polyMeshDetail = rcAllocPolyMeshDetail();
         if (!iv.polyMeshDetail)
         {
-            printf("%s alloc m_dmesh FIALED!          \r", tileString);
+            printProgress("%s alloc m_dmesh FIALED!          \r", tileString);
             return;
         }
-        rcMergePolyMeshDetails(m_rcContext, dmmerge, nmerge, *iv.polyMeshDetail);
+        rcMergePolyMeshDetails(&rcCtx, dmmerge, nmerge, *iv.polyMeshDetail);
 
         // free things up
         delete [] pmmerge;
@@ -650,12 +748,12 @@ namespace MMAP
             // so we have a clear error message
             if (params.nvp > DT_VERTS_PER_POLYGON)
             {
-                printf("%s Invalid verts-per-polygon value!        \n", tileString);
+                printProgress("%s Invalid verts-per-polygon value!        \n", tileString);
                 continue;
             }
             if (params.vertCount >= 0xffff)
             {
-                printf("%s Too many vertices!                      \n", tileString);
+                printProgress("%s Too many vertices!                      \n", tileString);
                 continue;
             }
             if (!params.vertCount || !params.verts)
@@ -673,30 +771,34 @@ namespace MMAP
                 // we have flat tiles with no actual geometry - don't build those, its useless
                 // keep in mind that we do output those into debug info
                 // drop tiles with only exact count - some tiles may have geometry while having less tiles
-                printf("%s No polygons to build on tile!              \n", tileString);
+                printProgress("%s No polygons to build on tile!              \n", tileString);
                 continue;
             }
             if (!params.detailMeshes || !params.detailVerts || !params.detailTris)
             {
-                printf("%s No detail mesh to build tile!           \n", tileString);
+                printProgress("%s No detail mesh to build tile!           \n", tileString);
                 continue;
             }
 
-            printf("%s Building navmesh tile...                \r", tileString);
+            printProgress("%s Building navmesh tile...                \r", tileString);
             if (!dtCreateNavMeshData(&params, &navData, &navDataSize))
             {
-                printf("%s Failed building navmesh tile!           \n", tileString);
+                printProgress("%s Failed building navmesh tile!           \n", tileString);
                 continue;
             }
 
             dtTileRef tileRef = 0;
-            printf("%s Adding tile to navmesh...                \r", tileString);
+            printProgress("%s Adding tile to navmesh...                \r", tileString);
             // DT_TILE_FREE_DATA tells detour to unallocate memory when the tile
             // is removed via removeTile()
-            dtStatus dtResult = navMesh->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, &tileRef);
+            dtStatus dtResult;
+            {
+                G3D::GMutexLock lock(&m_navMeshLock);
+                dtResult = navMesh->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, &tileRef);
+            }
             if (!tileRef || dtResult != DT_SUCCESS)
             {
-                printf("%s Failed adding tile to navmesh!           \n", tileString);
+                printProgress("%s Failed adding tile to navmesh!           \n", tileString);
                 continue;
             }
 
@@ -709,11 +811,13 @@ namespace MMAP
                 char message[1024];
                 sprintf(message, "Failed to open %s for writing!\n", fileName);
                 perror(message);
+
+                G3D::GMutexLock lock(&m_navMeshLock);
                 navMesh->removeTile(tileRef, NULL, NULL);
                 continue;
             }
 
-            printf("%s Writing to file...                      \r", tileString);
+            printProgress("%s Writing to file...                      \r", tileString);
 
             // write header
             MmapTileHeader header;
@@ -726,6 +830,7 @@ namespace MMAP
             fclose(file);
 
             // now that tile is written to disk, we can unload it
+            G3D::GMutexLock lock(&m_navMeshLock);
             navMesh->removeTile(tileRef, NULL, NULL);
         }
         while (0);
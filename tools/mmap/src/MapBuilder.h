@@ -32,12 +32,17 @@
 #include "Recast.h"
 #include "DetourNavMesh.h"
 
+#include "G3D/GMutex.h"
+
 using namespace std;
 using namespace VMAP;
 // G3D namespace typedefs conflicts with ACE typedefs
 
 namespace MMAP
 {
+    // printf for tile building, serialized between tile builder threads
+    void printProgress(const char* format, ...);
+
     typedef map<uint32,set<uint32>*> TileList;
     struct Tile
     {
@@ -67,7 +72,8 @@ namespace MMAP
                        bool skipBattlegrounds   = false,
                        bool debugOutput         = false,
                        bool bigBaseUnit         = false,
-                       const char* offMeshFilePath = NULL);
+                       const char* offMeshFilePath = NULL,
+                       int threads              = 1);
 
             ~MapBuilder();
 
@@ -89,6 +95,11 @@ namespace MMAP
 
             void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
 
+            // tile-parallel map building, workers take tiles in tile list order
+            void buildTilesParallel(uint32 mapID, vector<uint32> const& tileIDs, dtNavMesh* navMesh);
+            static void buildTilesThread(void* builder);
+            void buildTilesWorker();
+
             // move map building
             void buildMoveMapTile(uint32 mapID,
                                   uint32 tileX,
@@ -120,8 +131,15 @@ namespace MMAP
             float m_maxWalkableAngle;
             bool m_bigBaseUnit;
 
-            // build performance - not really used for now
-            rcContext* m_rcContext;
+            int m_threads;
+
+            // state of map built by worker threads
+            uint32 m_workMapID;
+            vector<uint32> const* m_workTiles;
+            uint32 m_workNextTile;
+            dtNavMesh* m_workNavMesh;
+            G3D::GMutex m_workLock;         // guards m_workNextTile
+            G3D::GMutex m_navMeshLock;      // dtNavMesh is not thread safe
     };
 }
 
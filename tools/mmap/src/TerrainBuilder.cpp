@@ -92,7 +92,7 @@ namespace MMAP
         if (fheader.versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)))
         {
             fclose(mapFile);
-            printf("%s is the wrong version, please extract new .map files\n", mapFileName);
+            printProgress("%s is the wrong version, please extract new .map files\n", mapFileName);
             return false;
         }
 
@@ -810,14 +810,14 @@ namespace MMAP
         // no meshfile input given?
         if(offMeshFilePath == NULL)
         {
-            printf("No offmesh file provided \n");
+            printProgress("No offmesh file provided \n");
             return;
         }
 
         FILE* fp = fopen(offMeshFilePath, "rb");
         if (!fp)
         {
-            printf(" loadOffMeshConnections:: input file %s not found!\n", offMeshFilePath);
+            printProgress(" loadOffMeshConnections:: input file %s not found!\n", offMeshFilePath);
             return;
         }
 
@@ -832,13 +832,13 @@ namespace MMAP
             if(10 != sscanf(buf, "%d %d,%d (%f %f %f) (%f %f %f) %f", &mid, &tx, &ty,
                                     &p0[0], &p0[1], &p0[2], &p1[0], &p1[1], &p1[2], &size))
             {
-                printf("Offmesh line format problem \n");
+                printProgress("Offmesh line format problem \n");
                 continue;
             }
 
             if(mapID == mid, tileX == tx, tileY == ty)
             {
-                printf("Appending offmesh connection \n");
+                printProgress("Appending offmesh connection \n");
                 meshData.offMeshConnections.append(p0[1]);
                 meshData.offMeshConnections.append(p0[2]);
                 meshData.offMeshConnections.append(p0[0]);